@@ -1,8 +1,14 @@
 #include "util/util.hpp"
+#include "batch.hpp"
 #include "dir.hpp"
+#include "log.hpp"
+#include "trace.hpp"
 
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 int main(int argc, char** argv) {
 	const auto start = std::chrono::high_resolution_clock::now();
@@ -10,27 +16,306 @@ int main(int argc, char** argv) {
 
 	const auto path = docs_gen_core::util::next_arg(&argc, &argv);
 	if (path == nullptr) {
-		std::cerr << "[USAGE] <program> <root of the project>\n";
+		std::cerr << "[USAGE] <program> <root of the project> [--trace <out.json>] [--log-level <trace|debug|info|warning|error|off>] [--max-value-bytes <n>] [--split-bytes <n>] [--prefetch <n>] [--stream] [--expand-instances <depth>] [--node-properties] [--stats] [--reachable] [--entry <res://path>]... [--shard <i>/<n>] [--budget <ms>] [--archive <out.tar|out.zip>] [--compression <store|deflate>] [ignored folders...]\n"
+			<< "        <program> merge <root of the project> [--log-level <level>] [ignored folders...]\n"
+			<< "        <program> --batch <manifest> [--project <root>]... [--jobs <n>] [--trace <out.json>] [--log-level <level>] [--max-value-bytes <n>] [--split-bytes <n>] [--prefetch <n>] [--stream] [--expand-instances <depth>] [--node-properties] [--stats] [--reachable] [--entry <res://path>]... [--shard <i>/<n>] [--budget <ms>] [ignored folders...]\n";
 		return -1;
 	}
 
-	docs_gen_core::dir p;
+	// batch mode: project roots come from the manifest and --project, the root argument is the manifest
+	const bool batch_mode = std::strcmp(path, "--batch") == 0;
+	const char* manifest = nullptr;
+	if (batch_mode) {
+		manifest = docs_gen_core::util::next_arg(&argc, &argv);
+		if (manifest == nullptr) {
+			std::cerr << "[ERROR] --batch expects a manifest file, pass \"-\" to give the roots with --project only\n";
+			return -1;
+		}
+	}
+
+	// merge mode: the shards' docs were copied into <root>/docs, their sections get completed
+	const bool merge_mode = std::strcmp(path, "merge") == 0;
+	const char* merge_root = nullptr;
+	if (merge_mode) {
+		merge_root = docs_gen_core::util::next_arg(&argc, &argv);
+		if (merge_root == nullptr) {
+			std::cerr << "[ERROR] merge expects the root of the project the shards documented\n";
+			return -1;
+		}
+	}
+
+	std::vector<std::wstring> ignored_folders;
+	std::vector<const char*> project_roots;
+	std::size_t jobs = 0;
+	docs_gen_core::parse_options options;
+	bool streaming = false;
+	bool stats = false;
+	bool reachable = false;
+	std::vector<std::wstring> entry_points;
+	std::size_t shard_index = 0;
+	std::size_t shard_count = 1;
+	std::size_t expand_depth = 0;
+	long long budget_ms = 0;
+	const char* trace_path = nullptr;
+	const char* archive_path = nullptr;
+	bool archive_store = false;
 	char* arg;
 	while ((arg = docs_gen_core::util::next_arg(&argc, &argv)) != nullptr) {
+		if (batch_mode && std::strcmp(arg, "--project") == 0) {
+			const auto root = docs_gen_core::util::next_arg(&argc, &argv);
+			if (root == nullptr) {
+				std::cerr << "[ERROR] --project expects a project root\n";
+				return -1;
+			}
+			project_roots.push_back(root);
+			continue;
+		}
+
+		if (batch_mode && std::strcmp(arg, "--jobs") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoi(n) < 1) {
+				std::cerr << "[ERROR] --jobs expects a positive thread count\n";
+				return -1;
+			}
+			jobs = static_cast<std::size_t>(std::atoi(n));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--trace") == 0) {
+			trace_path = docs_gen_core::util::next_arg(&argc, &argv);
+			if (trace_path == nullptr) {
+				std::cerr << "[ERROR] --trace expects an output file\n";
+				return -1;
+			}
+			continue;
+		}
+
+		if (std::strcmp(arg, "--max-value-bytes") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoll(n) < 0) {
+				std::cerr << "[ERROR] --max-value-bytes expects a byte count, 0 keeps every value\n";
+				return -1;
+			}
+			options.max_value_bytes = static_cast<std::size_t>(std::atoll(n));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--split-bytes") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoll(n) < 0) {
+				std::cerr << "[ERROR] --split-bytes expects a chunk size in bytes, 0 parses every scene in one piece\n";
+				return -1;
+			}
+			options.split_bytes = static_cast<std::uint64_t>(std::atoll(n));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--prefetch") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoi(n) < 0) {
+				std::cerr << "[ERROR] --prefetch expects a file count, 0 turns read-ahead off\n";
+				return -1;
+			}
+			options.prefetch_depth = static_cast<std::size_t>(std::atoi(n));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--expand-instances") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoi(n) < 0) {
+				std::cerr << "[ERROR] --expand-instances expects a depth, 0 keeps instanced scenes collapsed\n";
+				return -1;
+			}
+			expand_depth = static_cast<std::size_t>(std::atoi(n));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--stream") == 0) {
+			streaming = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--node-properties") == 0) {
+			options.node_properties = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--stats") == 0) {
+			stats = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--reachable") == 0) {
+			reachable = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--entry") == 0) {
+			const auto root = docs_gen_core::util::next_arg(&argc, &argv);
+			if (root == nullptr) {
+				std::cerr << "[ERROR] --entry expects a scene, resource or script, e.g. res://main.tscn\n";
+				return -1;
+			}
+			// the given entry points replace the ones from project.godot
+			reachable = true;
+			entry_points.push_back(docs_gen_core::util::to_wstring(root));
+			continue;
+		}
+
+		if (std::strcmp(arg, "--shard") == 0) {
+			const auto spec = docs_gen_core::util::next_arg(&argc, &argv);
+			const char* slash = spec ? std::strchr(spec, '/') : nullptr;
+			const auto i = spec ? std::atoi(spec) : 0;
+			const auto n = slash ? std::atoi(slash + 1) : 0;
+			if (n < 1 || i < 1 || i > n) {
+				std::cerr << "[ERROR] --shard expects <i>/<n> with 1 <= i <= n, e.g. 2/4\n";
+				return -1;
+			}
+			shard_index = static_cast<std::size_t>(i - 1);
+			shard_count = static_cast<std::size_t>(n);
+			continue;
+		}
+
+		if (std::strcmp(arg, "--budget") == 0) {
+			const auto n = docs_gen_core::util::next_arg(&argc, &argv);
+			if (n == nullptr || std::atoll(n) <= 0) {
+				std::cerr << "[ERROR] --budget expects a time in milliseconds\n";
+				return -1;
+			}
+			budget_ms = std::atoll(n);
+			continue;
+		}
+
+		if (std::strcmp(arg, "--archive") == 0) {
+			archive_path = docs_gen_core::util::next_arg(&argc, &argv);
+			if (archive_path == nullptr) {
+				std::cerr << "[ERROR] --archive expects an output file, .zip writes a zip and anything else a tar\n";
+				return -1;
+			}
+			continue;
+		}
+
+		if (std::strcmp(arg, "--compression") == 0) {
+			const auto method = docs_gen_core::util::next_arg(&argc, &argv);
+			if (method == nullptr || (std::strcmp(method, "store") != 0 && std::strcmp(method, "deflate") != 0)) {
+				std::cerr << "[ERROR] --compression expects store or deflate\n";
+				return -1;
+			}
+			archive_store = std::strcmp(method, "store") == 0;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--log-level") == 0) {
+			const auto lvl = docs_gen_core::util::next_arg(&argc, &argv);
+			docs_gen_core::logging::level l;
+			if (lvl == nullptr || !docs_gen_core::logging::parse_level(lvl, l)) {
+				std::cerr << "[ERROR] --log-level expects one of trace, debug, info, warning, error, off\n";
+				return -1;
+			}
+			docs_gen_core::logging::set_level(l);
+			continue;
+		}
+
 		auto str = docs_gen_core::util::to_wstring(arg);
 		if (str.front() == '"' && str.back() == '"') {
 			str = str.substr(1, str.size() - 2);
 		}
-		p.push_ignored_folder(str);
+		ignored_folders.push_back(str);
+	}
+
+	if (trace_path != nullptr) {
+		docs_gen_core::trace::set_enabled(true);
+		docs_gen_core::trace::set_thread_name("main");
+	}
+
+	if (shard_count > 1 && reachable) {
+		std::cerr << "[ERROR] --shard can not be combined with --reachable or --entry\n";
+		return -1;
+	}
+
+	if ((batch_mode || merge_mode) && archive_path != nullptr) {
+		std::cerr << "[ERROR] --archive writes the docs of a single project\n";
+		return -1;
+	}
+
+	if (shard_count > 1 && archive_path != nullptr) {
+		std::cerr << "[ERROR] --shard can not be combined with --archive, the merge completes a docs folder\n";
+		return -1;
 	}
 
-	if (!p.set_path(docs_gen_core::util::to_wstring(path))) {
-		std::cerr << "[ERROR] invalid path: " << arg << '\n';
+	if (budget_ms > 0 && (shard_count > 1 || reachable || archive_path != nullptr)) {
+		std::cerr << "[ERROR] --budget can not be combined with --shard, --reachable, --entry or --archive\n";
 		return -1;
 	}
 
-	p.construct_file_tree();
-	p.gen_docs();
+	docs_gen_core::parse_stats parse_stats;
+	if (merge_mode) {
+		docs_gen_core::dir p;
+		p.set_ignored_folders(ignored_folders);
+		if (!p.set_path(docs_gen_core::util::to_wstring(merge_root))) {
+			std::cerr << "[ERROR] invalid path: " << merge_root << '\n';
+			return -1;
+		}
+		if (!p.merge_shards()) {
+			docs_gen_core::logging::flush();
+			return -1;
+		}
+	}
+	else if (batch_mode) {
+		// the calling thread works too, so n jobs means n - 1 pool workers
+		docs_gen_core::batch b{ jobs > 0 ? jobs - 1 : docs_gen_core::thread_pool::default_workers() };
+		b.set_parse_options(options);
+		b.set_streaming(streaming);
+		b.set_expand_instances(expand_depth);
+		b.set_parse_stats(stats ? &parse_stats : nullptr);
+		b.set_reachable_only(reachable);
+		b.set_entry_points(entry_points);
+		b.set_shard(shard_index, shard_count);
+		b.set_budget(std::chrono::milliseconds(budget_ms));
+		if (std::strcmp(manifest, "-") != 0 && !b.add_manifest(std::filesystem::u8path(manifest), ignored_folders)) {
+			docs_gen_core::logging::flush();
+			return -1;
+		}
+		for (const auto root : project_roots) {
+			if (!b.add_project(docs_gen_core::util::to_wstring(root), ignored_folders)) {
+				docs_gen_core::logging::flush();
+				return -1;
+			}
+		}
+		b.run();
+	}
+	else {
+		docs_gen_core::dir p;
+		p.set_ignored_folders(ignored_folders);
+		p.set_parse_options(options);
+		p.set_streaming(streaming);
+		p.set_expand_instances(expand_depth);
+		p.set_parse_stats(stats ? &parse_stats : nullptr);
+		p.set_reachable_only(reachable);
+		p.set_entry_points(entry_points);
+		p.set_shard(shard_index, shard_count);
+		p.set_budget(std::chrono::milliseconds(budget_ms));
+		if (archive_path != nullptr) {
+			const auto archive = std::filesystem::u8path(archive_path);
+			p.set_archive(archive, docs_gen_core::archive_writer::format_for(archive, archive_store));
+		}
+		if (!p.set_path(docs_gen_core::util::to_wstring(path))) {
+			std::cerr << "[ERROR] invalid path: " << path << '\n';
+			return -1;
+		}
+
+		p.construct_file_tree();
+		p.gen_docs();
+	}
+	docs_gen_core::logging::flush();
+
+	if (stats) {
+		parse_stats.write_report(std::cout);
+	}
+
+	if (trace_path != nullptr && !docs_gen_core::trace::write_chrome_trace(trace_path)) {
+		std::cerr << "[ERROR] could not write trace: " << trace_path << '\n';
+	}
 	
 	auto stop = std::chrono::high_resolution_clock::now();
 	auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
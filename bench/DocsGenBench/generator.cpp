@@ -0,0 +1,239 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "uid.hpp"
+
+namespace docs_gen_bench {
+
+	namespace {
+
+		constexpr const char* node_types[] = {
+			"Node2D", "Sprite2D", "Area2D", "CollisionShape2D", "AnimationPlayer", "Timer", "Label", "Control"
+		};
+
+		constexpr const char* sub_resource_types[] = {
+			"Curve", "Gradient", "RectangleShape2D", "CircleShape2D", "StyleBoxFlat"
+		};
+
+		std::string number(std::size_t n, std::size_t width) {
+			auto s = std::to_string(n);
+			if (s.size() < width) s.insert(0, width - s.size(), '0');
+			return s;
+		}
+
+		std::string scene_path(std::size_t i, std::size_t level) {
+			return "scenes/level_" + std::to_string(level) + "/scene_" + number(i, 5) + ".tscn";
+		}
+
+		std::string script_path(std::size_t i) {
+			return "scripts/script_" + number(i, 5) + ".gd";
+		}
+
+		std::string resource_path(std::size_t i) {
+			return "resources/resource_" + number(i, 5) + ".tres";
+		}
+
+		std::string script_class_name(std::size_t i) {
+			return "Generated" + number(i, 5);
+		}
+
+		std::string coordinate(rng& r) {
+			auto s = std::to_string(static_cast<long long>(r.below(2000)) - 1000);
+			if (r.below(2)) s += ".5";
+			return s;
+		}
+
+		std::uintmax_t write_file(const std::filesystem::path& path, const std::string& contents) {
+			std::filesystem::create_directories(path.parent_path());
+			std::ofstream out{ path, std::ios::out | std::ios::binary };
+			out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+			return contents.size();
+		}
+
+		std::string gen_script(rng& r, std::size_t i, const project_params& params) {
+			std::string s;
+			s += "extends Node2D\n";
+			s += "class_name " + script_class_name(i) + '\n';
+			s += "#CLASS generated script " + std::to_string(i) + '\n';
+			s += "#TAGS generated, bench\n\n";
+
+			s += "@export_category(\"Generated\")\n";
+			const auto vars = 2 + r.below(4);
+			for (std::size_t v = 0; v < vars; ++v) {
+				if (r.below(2)) s += "#VAR generated variable\n";
+				s += "@export var value_" + std::to_string(v) + " : int = " + std::to_string(r.below(100)) + '\n';
+			}
+			s += '\n';
+
+			for (std::size_t f = 0; f < params.functions_per_script; ++f) {
+				s += "#FUNC generated function " + std::to_string(f) + '\n';
+				s += "func fn_" + std::to_string(f) + "(a : int, b : float, c : Node) -> int:\n";
+				const auto lines = 1 + r.below(6);
+				for (std::size_t l = 0; l < lines; ++l) {
+					s += "\tvar t_" + std::to_string(l) + " = a + " + std::to_string(r.below(1000)) + '\n';
+				}
+				s += "\treturn a\n\n";
+			}
+			return s;
+		}
+
+		std::string gen_resource(rng& r, std::size_t i, const project_params& params,
+			const std::vector<std::uint64_t>& resource_uids) {
+			std::string s;
+			const auto script = params.scripts ? r.below(params.scripts) : 0;
+			const bool has_parent = i > 0 && r.below(3) == 0;
+			const auto parent = has_parent ? r.below(i) : 0;
+
+			s += "[gd_resource type=\"Resource\" script_class=\"" + script_class_name(script) + "\" load_steps="
+				+ std::to_string(2 + params.sub_resources_per_resource) + " format=3 uid=\""
+				+ docs_gen_core::encode_uid(resource_uids[i]) + "\"]\n\n";
+
+			if (params.scripts) {
+				s += "[ext_resource type=\"Script\" path=\"res://" + script_path(script) + "\" id=\"1_s\"]\n";
+			}
+			if (has_parent) {
+				s += "[ext_resource type=\"Resource\" uid=\"" + docs_gen_core::encode_uid(resource_uids[parent]) + "\" path=\"res://"
+					+ resource_path(parent) + "\" id=\"2_r\"]\n";
+			}
+			s += '\n';
+
+			std::vector<std::string> sub_ids;
+			for (std::size_t sr = 0; sr < params.sub_resources_per_resource; ++sr) {
+				const std::string type = sub_resource_types[r.below(std::size(sub_resource_types))];
+				sub_ids.push_back(type + '_' + std::to_string(sr));
+				s += "[sub_resource type=\"" + type + "\" id=\"" + sub_ids.back() + "\"]\n";
+				const auto points = 2 + r.below(8);
+				s += "_data = [";
+				for (std::size_t p = 0; p < points; ++p) {
+					if (p) s += ", ";
+					s += "Vector2(" + coordinate(r) + ", " + coordinate(r) + "), 0.0, 0.0, 0, 0";
+				}
+				s += "]\n";
+				s += "point_count = " + std::to_string(points) + "\n\n";
+			}
+
+			s += "[resource]\n";
+			if (params.scripts) s += "script = ExtResource(\"1_s\")\n";
+			if (has_parent) s += "base = ExtResource(\"2_r\")\n";
+			for (std::size_t sr = 0; sr < sub_ids.size(); ++sr) {
+				s += "part_" + std::to_string(sr) + " = SubResource(\"" + sub_ids[sr] + "\")\n";
+			}
+			s += "value = " + std::to_string(r.below(1000)) + '\n';
+			return s;
+		}
+
+	} // namespace
+
+	std::uint64_t rng::next() {
+		// splitmix64
+		std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	project_stats generate_project(const std::filesystem::path& root, const project_params& params) {
+		std::filesystem::remove_all(root);
+		std::filesystem::create_directories(root);
+
+		rng r{ params.seed };
+		project_stats stats;
+
+		std::vector<std::uint64_t> scene_uids(params.scenes);
+		std::vector<std::uint64_t> resource_uids(params.resources);
+		for (auto& u : scene_uids) u = r.next() & 0x7FFFFFFFFFFFFFFFull;
+		for (auto& u : resource_uids) u = r.next() & 0x7FFFFFFFFFFFFFFFull;
+
+		const auto depth = std::max<std::size_t>(1, params.instancing_depth);
+		std::vector<std::size_t> levels(params.scenes);
+		std::vector<std::vector<std::size_t>> by_level(depth);
+		for (std::size_t i = 0; i < params.scenes; ++i) {
+			levels[i] = i * depth / params.scenes;
+			by_level[levels[i]].push_back(i);
+		}
+
+		{
+			std::string s;
+			s += "config_version=5\n\n[application]\n\n";
+			s += "config/name=\"" + params.name + "\"\n";
+			if (params.scenes) s += "run/main_scene=\"res://" + scene_path(0, 0) + "\"\n";
+			s += "\n[autoload]\n\n";
+			if (params.scripts) s += "Generated=\"*res://" + script_path(0) + "\"\n";
+			stats.bytes += write_file(root / "project.godot", s);
+		}
+
+		for (std::size_t i = 0; i < params.scripts; ++i) {
+			stats.bytes += write_file(root / script_path(i), gen_script(r, i, params));
+			++stats.script_files;
+		}
+
+		for (std::size_t i = 0; i < params.resources; ++i) {
+			stats.bytes += write_file(root / resource_path(i), gen_resource(r, i, params, resource_uids));
+			++stats.resource_files;
+		}
+
+		for (std::size_t i = 0; i < params.scenes; ++i) {
+			const auto level = levels[i];
+			std::string s;
+			s += "[gd_scene load_steps=4 format=3 uid=\"" + docs_gen_core::encode_uid(scene_uids[i]) + "\"]\n\n";
+
+			const bool has_script = params.scripts > 0;
+			const bool has_resource = params.resources > 0;
+			if (has_script) {
+				s += "[ext_resource type=\"Script\" path=\"res://" + script_path(r.below(params.scripts)) + "\" id=\"1_s\"]\n";
+			}
+			if (has_resource) {
+				const auto res = r.below(params.resources);
+				s += "[ext_resource type=\"Resource\" uid=\"" + docs_gen_core::encode_uid(resource_uids[res]) + "\" path=\"res://"
+					+ resource_path(res) + "\" id=\"2_r\"]\n";
+			}
+
+			std::vector<std::size_t> instances;
+			if (level + 1 < depth && !by_level[level + 1].empty()) {
+				const auto& next = by_level[level + 1];
+				for (std::size_t k = 0; k < params.instances_per_scene; ++k) {
+					const auto child = next[r.below(next.size())];
+					s += "[ext_resource type=\"PackedScene\" uid=\"" + docs_gen_core::encode_uid(scene_uids[child]) + "\" path=\"res://"
+						+ scene_path(child, level + 1) + "\" id=\"" + std::to_string(3 + k) + "_p\"]\n";
+					instances.push_back(k);
+				}
+			}
+			s += '\n';
+
+			s += "[node name=\"Scene" + number(i, 5) + "\" type=\"Node2D\"]\n";
+			if (has_script) s += "script = ExtResource(\"1_s\")\n";
+			if (has_resource) s += "data = ExtResource(\"2_r\")\n";
+			s += '\n';
+
+			// paths[k] is the value of the parent attribute for children of node k
+			std::vector<std::string> paths{ "." };
+			const auto nodes = std::max<std::size_t>(1, params.nodes_per_scene);
+			for (std::size_t n = 1; n < nodes; ++n) {
+				const auto parent = r.below(paths.size());
+				const auto name = "Node_" + std::to_string(n);
+				const auto* type = node_types[r.below(std::size(node_types))];
+				s += "[node name=\"" + name + "\" type=\"" + type + "\" parent=\"" + paths[parent] + "\"]\n";
+				s += "position = Vector2(" + coordinate(r) + ", " + coordinate(r) + ")\n";
+				if (has_script && r.below(4) == 0) s += "script = ExtResource(\"1_s\")\n";
+				s += '\n';
+				paths.push_back(parent == 0 ? name : paths[parent] + '/' + name);
+			}
+
+			for (auto k : instances) {
+				const auto parent = r.below(paths.size());
+				s += "[node name=\"Instance_" + std::to_string(k) + "\" parent=\"" + paths[parent]
+					+ "\" instance=ExtResource(\"" + std::to_string(3 + k) + "_p\")]\n\n";
+			}
+
+			stats.bytes += write_file(root / scene_path(i, level), s);
+			++stats.scene_files;
+		}
+
+		return stats;
+	}
+
+} // docs_gen_bench
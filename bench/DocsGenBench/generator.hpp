@@ -0,0 +1,53 @@
+#ifndef DOCS_GEN_BENCH_GENERATOR_H
+#define DOCS_GEN_BENCH_GENERATOR_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace docs_gen_bench {
+
+	struct project_params {
+		std::string name;
+		std::uint64_t seed = 1;
+
+		std::size_t scenes = 100;
+		std::size_t nodes_per_scene = 20;
+		// number of scene levels, scenes of one level only instance scenes of the next one
+		std::size_t instancing_depth = 4;
+		std::size_t instances_per_scene = 2;
+
+		std::size_t scripts = 50;
+		std::size_t functions_per_script = 8;
+
+		std::size_t resources = 30;
+		std::size_t sub_resources_per_resource = 2;
+	};
+
+	struct project_stats {
+		std::size_t scene_files = 0;
+		std::size_t script_files = 0;
+		std::size_t resource_files = 0;
+		std::uintmax_t bytes = 0;
+
+		[[nodiscard]] std::size_t files() const { return scene_files + script_files + resource_files; }
+	};
+
+	// small, fast, platform independent generator so the same seed gives the same project everywhere
+	class rng {
+		std::uint64_t state_;
+
+	public:
+		explicit rng(std::uint64_t seed) : state_(seed) {}
+
+		std::uint64_t next();
+		std::size_t below(std::size_t bound) { return bound == 0 ? 0 : static_cast<std::size_t>(next() % bound); }
+	};
+
+	// writes a Godot 4 text project (project.godot, .tscn, .gd and .tres files) into root,
+	// which is wiped first; the output only depends on params
+	project_stats generate_project(const std::filesystem::path& root, const project_params& params);
+
+} // docs_gen_bench
+
+#endif // DOCS_GEN_BENCH_GENERATOR_H
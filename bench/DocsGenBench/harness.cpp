@@ -0,0 +1,146 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "dir.hpp"
+#include "log.hpp"
+
+namespace docs_gen_bench {
+
+	namespace {
+
+		using clock = std::chrono::steady_clock;
+
+		double ms_since(const clock::time_point& start) {
+			return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		}
+
+		// keeps the pipeline's progress output out of the measurements
+		class quiet_log {
+			docs_gen_core::logging::level prev_;
+
+		public:
+			quiet_log() : prev_(docs_gen_core::logging::get_level()) {
+				docs_gen_core::logging::set_level(docs_gen_core::logging::level::warning);
+			}
+			~quiet_log() {
+				docs_gen_core::logging::flush();
+				docs_gen_core::logging::set_level(prev_);
+			}
+		};
+
+		double per_second(double count, double ms) {
+			return ms > 0.0 ? count * 1000.0 / ms : 0.0;
+		}
+
+	} // namespace
+
+	bench_result run_benchmark(const std::filesystem::path& root, const project_params& params, std::size_t repeats) {
+		bench_result res;
+		res.params = params;
+		res.repeats = std::max<std::size_t>(1, repeats);
+
+		auto start = clock::now();
+		res.stats = generate_project(root, params);
+		res.generate_ms = ms_since(start);
+
+		res.best = { 1e300, 1e300, 1e300, 1e300 };
+		for (std::size_t i = 0; i < res.repeats; ++i) {
+			phase_times t;
+			{
+				quiet_log guard;
+				docs_gen_core::dir d;
+				if (!d.set_path(root.wstring())) {
+					std::cerr << "[ERROR] invalid path: " << root << '\n';
+					return res;
+				}
+
+				start = clock::now();
+				d.index_files();
+				t.index_ms = ms_since(start);
+
+				start = clock::now();
+				if (!d.parse_files()) {
+					std::cerr << "[ERROR] failed to parse generated project " << root << '\n';
+				}
+				t.parse_ms = ms_since(start);
+
+				start = clock::now();
+				d.resolve_references();
+				t.resolve_ms = ms_since(start);
+
+				start = clock::now();
+				d.gen_docs();
+				t.docs_ms = ms_since(start);
+			}
+
+			res.best.index_ms = std::min(res.best.index_ms, t.index_ms);
+			res.best.parse_ms = std::min(res.best.parse_ms, t.parse_ms);
+			res.best.resolve_ms = std::min(res.best.resolve_ms, t.resolve_ms);
+			res.best.docs_ms = std::min(res.best.docs_ms, t.docs_ms);
+
+			res.mean.index_ms += t.index_ms / res.repeats;
+			res.mean.parse_ms += t.parse_ms / res.repeats;
+			res.mean.resolve_ms += t.resolve_ms / res.repeats;
+			res.mean.docs_ms += t.docs_ms / res.repeats;
+		}
+
+		return res;
+	}
+
+	void print_report(std::ostream& out, const std::vector<bench_result>& results) {
+		out << std::fixed << std::setprecision(2);
+		out << std::left << std::setw(10) << "scale"
+			<< std::right << std::setw(8) << "files"
+			<< std::setw(10) << "MB"
+			<< std::setw(12) << "index ms"
+			<< std::setw(12) << "parse ms"
+			<< std::setw(12) << "resolve ms"
+			<< std::setw(12) << "docs ms"
+			<< std::setw(12) << "total ms"
+			<< std::setw(12) << "parse MB/s"
+			<< std::setw(12) << "files/s" << '\n';
+
+		for (const auto& r : results) {
+			const auto& t = r.best;
+			const auto mb = static_cast<double>(r.stats.bytes) / (1024.0 * 1024.0);
+			out << std::left << std::setw(10) << r.params.name
+				<< std::right << std::setw(8) << r.stats.files()
+				<< std::setw(10) << mb
+				<< std::setw(12) << t.index_ms
+				<< std::setw(12) << t.parse_ms
+				<< std::setw(12) << t.resolve_ms
+				<< std::setw(12) << t.docs_ms
+				<< std::setw(12) << t.total_ms()
+				<< std::setw(12) << per_second(mb, t.parse_ms)
+				<< std::setw(12) << per_second(static_cast<double>(r.stats.files()), t.total_ms()) << '\n';
+		}
+
+		out << "(best of " << (results.empty() ? 0 : results.front().repeats) << " runs per scale)\n";
+	}
+
+	project_params preset(const std::string& name) {
+		project_params p;
+		p.name = name;
+		if (name == "small") {
+			p.scenes = 100; p.nodes_per_scene = 20; p.instancing_depth = 4; p.instances_per_scene = 2;
+			p.scripts = 50; p.functions_per_script = 8;
+			p.resources = 30; p.sub_resources_per_resource = 2;
+		}
+		else if (name == "medium") {
+			p.scenes = 1000; p.nodes_per_scene = 40; p.instancing_depth = 8; p.instances_per_scene = 3;
+			p.scripts = 400; p.functions_per_script = 12;
+			p.resources = 300; p.sub_resources_per_resource = 3;
+		}
+		else if (name == "large") {
+			p.scenes = 10000; p.nodes_per_scene = 60; p.instancing_depth = 12; p.instances_per_scene = 4;
+			p.scripts = 3000; p.functions_per_script = 16;
+			p.resources = 2000; p.sub_resources_per_resource = 4;
+		}
+		return p;
+	}
+
+} // docs_gen_bench
@@ -0,0 +1,39 @@
+#ifndef DOCS_GEN_BENCH_HARNESS_H
+#define DOCS_GEN_BENCH_HARNESS_H
+
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+#include "generator.hpp"
+
+namespace docs_gen_bench {
+
+	struct phase_times {
+		double index_ms = 0.0;
+		double parse_ms = 0.0;
+		double resolve_ms = 0.0;
+		double docs_ms = 0.0;
+
+		[[nodiscard]] double total_ms() const { return index_ms + parse_ms + resolve_ms + docs_ms; }
+	};
+
+	struct bench_result {
+		project_params params;
+		project_stats stats;
+		double generate_ms = 0.0;
+		// best of all repeats, per phase
+		phase_times best;
+		phase_times mean;
+		std::size_t repeats = 0;
+	};
+
+	// generates the project under root and runs the whole pipeline on it `repeats` times
+	bench_result run_benchmark(const std::filesystem::path& root, const project_params& params, std::size_t repeats);
+	void print_report(std::ostream& out, const std::vector<bench_result>& results);
+
+	project_params preset(const std::string& name);
+
+} // docs_gen_bench
+
+#endif // DOCS_GEN_BENCH_HARNESS_H
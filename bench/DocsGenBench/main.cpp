@@ -0,0 +1,102 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "util/util.hpp"
+#include "harness.hpp"
+
+namespace {
+
+	void print_usage() {
+		std::cerr << "[USAGE] <program> [--out <dir>] [--seed <n>] [--repeats <n>] [--scales small,medium,large] [--keep]\n"
+			"\t[--scenes <n>] [--nodes <n>] [--depth <n>] [--instances <n>] [--scripts <n>] [--functions <n>]\n"
+			"\t[--resources <n>] [--sub-resources <n>]\n"
+			"\tany of the size options runs a single \"custom\" scale instead of the presets\n";
+	}
+
+	std::vector<std::string> split_scales(const std::string& s) {
+		std::vector<std::string> res;
+		std::string temp;
+		for (auto c : s) {
+			if (c == ',') {
+				if (!temp.empty()) res.push_back(temp);
+				temp.clear();
+			}
+			else {
+				temp.push_back(c);
+			}
+		}
+		if (!temp.empty()) res.push_back(temp);
+		return res;
+	}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	static_cast<void>(docs_gen_core::util::next_arg(&argc, &argv));
+
+	auto out_dir = std::filesystem::temp_directory_path() / "docs_gen_bench";
+	std::uint64_t seed = 1;
+	std::size_t repeats = 3;
+	bool keep = false;
+	std::vector<std::string> scales{ "small", "medium", "large" };
+	docs_gen_bench::project_params custom = docs_gen_bench::preset("small");
+	custom.name = "custom";
+	bool use_custom = false;
+
+	char* arg;
+	while ((arg = docs_gen_core::util::next_arg(&argc, &argv)) != nullptr) {
+		const std::string opt = arg;
+		if (opt == "--keep") {
+			keep = true;
+			continue;
+		}
+
+		const auto val = docs_gen_core::util::next_arg(&argc, &argv);
+		if (val == nullptr) {
+			print_usage();
+			return -1;
+		}
+
+		if (opt == "--out") out_dir = val;
+		else if (opt == "--seed") seed = std::stoull(val);
+		else if (opt == "--repeats") repeats = std::stoul(val);
+		else if (opt == "--scales") scales = split_scales(val);
+		else if (opt == "--scenes") { custom.scenes = std::stoul(val); use_custom = true; }
+		else if (opt == "--nodes") { custom.nodes_per_scene = std::stoul(val); use_custom = true; }
+		else if (opt == "--depth") { custom.instancing_depth = std::stoul(val); use_custom = true; }
+		else if (opt == "--instances") { custom.instances_per_scene = std::stoul(val); use_custom = true; }
+		else if (opt == "--scripts") { custom.scripts = std::stoul(val); use_custom = true; }
+		else if (opt == "--functions") { custom.functions_per_script = std::stoul(val); use_custom = true; }
+		else if (opt == "--resources") { custom.resources = std::stoul(val); use_custom = true; }
+		else if (opt == "--sub-resources") { custom.sub_resources_per_resource = std::stoul(val); use_custom = true; }
+		else {
+			print_usage();
+			return -1;
+		}
+	}
+
+	std::vector<docs_gen_bench::project_params> runs;
+	if (use_custom) {
+		runs.push_back(custom);
+	}
+	else {
+		for (const auto& s : scales) {
+			runs.push_back(docs_gen_bench::preset(s));
+		}
+	}
+
+	std::vector<docs_gen_bench::bench_result> results;
+	for (auto& p : runs) {
+		p.seed = seed;
+		const auto root = out_dir / p.name;
+		std::cout << "[INFO] Benchmarking scale " << p.name << " in " << root << '\n';
+		results.push_back(docs_gen_bench::run_benchmark(root, p, repeats));
+		if (!keep) {
+			std::filesystem::remove_all(root);
+		}
+	}
+
+	docs_gen_bench::print_report(std::cout, results);
+	return 0;
+}
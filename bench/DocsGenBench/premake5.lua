@@ -1,4 +1,4 @@
-project "NodeTreeTest"
+project "DocsGenBench"
     kind "ConsoleApp"
     language "C++"
     cppdialect "C++17"
@@ -0,0 +1 @@
+include "DocsGenBench"
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "archive.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+#include "deflate.hpp"
+#include "log.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::size_t tar_block = 512;
+		constexpr std::uint32_t zip_max32 = 0xFFFFFFFFu;
+		constexpr std::uint16_t zip_max16 = 0xFFFF;
+		// bit 11: names are UTF-8
+		constexpr std::uint16_t zip_utf8_flag = 0x0800;
+
+		void put_le(std::string& out, std::uint64_t v, std::size_t bytes) {
+			for (std::size_t i = 0; i < bytes; ++i) {
+				out.push_back(static_cast<char>(v >> (8 * i) & 0xFF));
+			}
+		}
+
+		void put_octal(std::string& header, std::size_t offset, std::size_t length, std::uint64_t v) {
+			// length - 1 digits and a NUL
+			for (std::size_t i = length - 1; i-- > 0; ) {
+				header[offset + i] = static_cast<char>('0' + (v & 7));
+				v >>= 3;
+			}
+		}
+
+		void put_field(std::string& header, std::size_t offset, std::size_t length, std::string_view v) {
+			header.replace(offset, std::min(length, v.size()), v.substr(0, length));
+		}
+
+		std::string tar_header(std::string_view name, std::string_view prefix, std::uint64_t size, std::uint64_t mtime, char type) {
+			std::string h(tar_block, '\0');
+			put_field(h, 0, 100, name);
+			put_octal(h, 100, 8, 0644);
+			put_octal(h, 108, 8, 0);
+			put_octal(h, 116, 8, 0);
+			put_octal(h, 124, 12, size);
+			put_octal(h, 136, 12, mtime);
+			put_field(h, 148, 8, "        ");
+			h[156] = type;
+			put_field(h, 257, 6, std::string_view("ustar\0", 6));
+			put_field(h, 263, 2, "00");
+			put_field(h, 345, 155, prefix);
+
+			std::uint32_t sum = 0;
+			for (const auto c : h) {
+				sum += static_cast<unsigned char>(c);
+			}
+			put_octal(h, 148, 7, sum);
+			h[155] = ' ';
+			return h;
+		}
+
+		std::string tar_padding(std::uint64_t size) {
+			return std::string(static_cast<std::size_t>((tar_block - size % tar_block) % tar_block), '\0');
+		}
+
+		// "<length> path=<name>\n" where length counts the whole record, its own digits included
+		std::string pax_path_record(std::string_view name) {
+			const auto body = " path=" + std::string(name) + "\n";
+			auto length = body.size() + 1;
+			while (std::to_string(length).size() + body.size() > length) ++length;
+			return std::to_string(length) + body;
+		}
+
+	} // namespace
+
+	bool archive_writer::open(const std::filesystem::path& path, archive_format format) {
+		out_.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out_.is_open()) {
+			DOCS_GEN_LOG_ERROR(docs, "could not create archive: ", path);
+			return false;
+		}
+
+		format_ = format;
+		offset_ = 0;
+		next_ = 0;
+		pending_.clear();
+		central_.clear();
+
+		// every entry carries the time the archive was started
+		const auto now = std::time(nullptr);
+		mtime_ = static_cast<std::uint64_t>(now);
+		std::tm local{};
+#ifdef WIN
+		localtime_s(&local, &now);
+#else
+		localtime_r(&now, &local);
+#endif
+		dos_time_ = static_cast<std::uint16_t>(local.tm_hour << 11 | local.tm_min << 5 | local.tm_sec / 2);
+		dos_date_ = static_cast<std::uint16_t>(std::max(local.tm_year - 80, 0) << 9 | (local.tm_mon + 1) << 5 | local.tm_mday);
+		return true;
+	}
+
+	void archive_writer::add(std::size_t sequence, std::string name, std::string data) {
+		prepared e;
+		e.name = std::move(name);
+		e.size = data.size();
+		if (format_ != archive_format::tar) {
+			e.crc = crc32(data);
+		}
+		if (format_ == archive_format::zip_deflate) {
+			auto packed = deflate(data);
+			// stored when deflating does not pay, as zip tools do
+			if (packed.size() < data.size()) {
+				e.data = std::move(packed);
+				e.deflated = true;
+			}
+		}
+		if (!e.deflated) {
+			e.data = std::move(data);
+		}
+
+		std::lock_guard lock(mutex_);
+		pending_.emplace(sequence, std::move(e));
+		while (!pending_.empty() && pending_.begin()->first == next_) {
+			write(pending_.begin()->second);
+			pending_.erase(pending_.begin());
+			++next_;
+		}
+	}
+
+	bool archive_writer::close() {
+		if (!out_.is_open())
+			return false;
+
+		std::lock_guard lock(mutex_);
+		// sequence numbers that never arrived leave gaps, the rest is written in order anyway
+		for (const auto& [_, e] : pending_) {
+			write(e);
+			++next_;
+		}
+		pending_.clear();
+
+		if (format_ == archive_format::tar) {
+			put(std::string(2 * tar_block, '\0'));
+		}
+		else {
+			write_zip_directory();
+		}
+
+		const bool ok = static_cast<bool>(out_);
+		out_.close();
+		return ok;
+	}
+
+	archive_format archive_writer::format_for(const std::filesystem::path& path, bool store) {
+		if (path.extension() == ".zip")
+			return store ? archive_format::zip_store : archive_format::zip_deflate;
+		return archive_format::tar;
+	}
+
+	void archive_writer::write(const prepared& e) {
+		if (format_ == archive_format::tar) write_tar(e);
+		else write_zip(e);
+	}
+
+	void archive_writer::write_tar(const prepared& e) {
+		std::string_view name = e.name;
+		std::string_view prefix;
+		if (name.size() > 100) {
+			// ustar splits long names at a '/' into a 155 byte prefix and a 100 byte name
+			const auto slash = name.find('/', name.size() - 101);
+			if (slash != std::string_view::npos && slash <= 155) {
+				prefix = name.substr(0, slash);
+				name = name.substr(slash + 1);
+			}
+			else {
+				// what does not fit goes into a pax extended header for the entry
+				const auto record = pax_path_record(e.name);
+				put(tar_header("PaxHeader", {}, record.size(), mtime_, 'x'));
+				put(record);
+				put(tar_padding(record.size()));
+				name = name.substr(name.size() - 100);
+			}
+		}
+
+		put(tar_header(name, prefix, e.size, mtime_, '0'));
+		put(e.data);
+		put(tar_padding(e.size));
+	}
+
+	void archive_writer::write_zip(const prepared& e) {
+		const auto offset = offset_;
+		std::string h;
+		put_le(h, 0x04034b50, 4);
+		put_le(h, 20, 2);
+		put_le(h, zip_utf8_flag, 2);
+		put_le(h, e.deflated ? 8 : 0, 2);
+		put_le(h, dos_time_, 2);
+		put_le(h, dos_date_, 2);
+		put_le(h, e.crc, 4);
+		put_le(h, e.data.size(), 4);
+		put_le(h, e.size, 4);
+		put_le(h, e.name.size(), 2);
+		put_le(h, 0, 2);
+		h += e.name;
+		put(h);
+		put(e.data);
+		central_.push_back({ e.name, offset, e.size, e.data.size(), e.crc, e.deflated });
+	}
+
+	void archive_writer::write_zip_directory() {
+		const auto directory_offset = offset_;
+		for (const auto& e : central_) {
+			// only the offset can outgrow 32 bits, a single page never does
+			const bool zip64 = e.offset >= zip_max32;
+			std::string h;
+			put_le(h, 0x02014b50, 4);
+			put_le(h, 3 << 8 | 20, 2);
+			put_le(h, zip64 ? 45 : 20, 2);
+			put_le(h, zip_utf8_flag, 2);
+			put_le(h, e.deflated ? 8 : 0, 2);
+			put_le(h, dos_time_, 2);
+			put_le(h, dos_date_, 2);
+			put_le(h, e.crc, 4);
+			put_le(h, e.compressed_size, 4);
+			put_le(h, e.size, 4);
+			put_le(h, e.name.size(), 2);
+			put_le(h, zip64 ? 12 : 0, 2);
+			put_le(h, 0, 2);
+			put_le(h, 0, 2);
+			put_le(h, 0, 2);
+			put_le(h, 0100644u << 16, 4);
+			put_le(h, zip64 ? zip_max32 : e.offset, 4);
+			h += e.name;
+			if (zip64) {
+				put_le(h, 0x0001, 2);
+				put_le(h, 8, 2);
+				put_le(h, e.offset, 8);
+			}
+			put(h);
+		}
+
+		const auto directory_size = offset_ - directory_offset;
+		const auto count = static_cast<std::uint64_t>(central_.size());
+		std::string h;
+		if (count >= zip_max16 || directory_offset >= zip_max32 || directory_size >= zip_max32) {
+			const auto record_offset = offset_;
+			put_le(h, 0x06064b50, 4);
+			put_le(h, 44, 8);
+			put_le(h, 3 << 8 | 45, 2);
+			put_le(h, 45, 2);
+			put_le(h, 0, 4);
+			put_le(h, 0, 4);
+			put_le(h, count, 8);
+			put_le(h, count, 8);
+			put_le(h, directory_size, 8);
+			put_le(h, directory_offset, 8);
+			put_le(h, 0x07064b50, 4);
+			put_le(h, 0, 4);
+			put_le(h, record_offset, 8);
+			put_le(h, 1, 4);
+		}
+		put_le(h, 0x06054b50, 4);
+		put_le(h, 0, 2);
+		put_le(h, 0, 2);
+		put_le(h, std::min<std::uint64_t>(count, zip_max16), 2);
+		put_le(h, std::min<std::uint64_t>(count, zip_max16), 2);
+		put_le(h, std::min<std::uint64_t>(directory_size, zip_max32), 4);
+		put_le(h, std::min<std::uint64_t>(directory_offset, zip_max32), 4);
+		put_le(h, 0, 2);
+		put(h);
+	}
+
+	void archive_writer::put(const std::string& bytes) {
+		out_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		offset_ += bytes.size();
+	}
+
+} // docs_gen_core
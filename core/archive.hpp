@@ -0,0 +1,84 @@
+#ifndef DOCS_GEN_ARCHIVE_H
+#define DOCS_GEN_ARCHIVE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace docs_gen_core {
+
+	enum class archive_format : std::uint8_t {
+		tar,
+		zip_store,
+		zip_deflate
+	};
+
+	// the docs as one tar or zip file instead of a tree of small files
+	//
+	// entries are prepared (checksummed, compressed) on the thread that adds them and appended
+	// to the single output stream in sequence order, so pages rendered in parallel still come
+	// out in the same order every run; an entry that arrives early waits in memory for the ones
+	// before it
+	class archive_writer {
+		struct prepared {
+			std::string name;
+			std::string data;
+			std::uint64_t size = 0;
+			std::uint32_t crc = 0;
+			bool deflated = false;
+		};
+
+		struct central_entry {
+			std::string name;
+			std::uint64_t offset;
+			std::uint64_t size;
+			std::uint64_t compressed_size;
+			std::uint32_t crc;
+			bool deflated;
+		};
+
+		std::ofstream out_;
+		archive_format format_ = archive_format::tar;
+		std::uint64_t offset_ = 0;
+		std::uint64_t mtime_ = 0;
+		std::uint16_t dos_time_ = 0;
+		std::uint16_t dos_date_ = 0;
+
+		std::mutex mutex_;
+		std::map<std::size_t, prepared> pending_;
+		std::size_t next_ = 0;
+		std::vector<central_entry> central_;
+
+	public:
+		archive_writer() = default;
+		archive_writer(const archive_writer&) = delete;
+		archive_writer& operator=(const archive_writer&) = delete;
+
+		[[nodiscard]] bool open(const std::filesystem::path& path, archive_format format);
+		// name is '/' separated and relative to the archive root; every sequence number from 0 up
+		// has to be added once, may be called from several threads
+		void add(std::size_t sequence, std::string name, std::string data);
+		// writes what is still waiting, then the tar end blocks or the zip central directory
+		[[nodiscard]] bool close();
+
+		[[nodiscard]] bool is_open() const { return out_.is_open(); }
+		[[nodiscard]] std::size_t entry_count() const { return next_; }
+
+		// .zip (deflated) for a path ending in .zip, tar otherwise
+		[[nodiscard]] static archive_format format_for(const std::filesystem::path& path, bool store = false);
+
+	private:
+		void write(const prepared& e);
+		void write_tar(const prepared& e);
+		void write_zip(const prepared& e);
+		void write_zip_directory();
+		void put(const std::string& bytes);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_ARCHIVE_H
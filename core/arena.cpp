@@ -0,0 +1,39 @@
+#include "arena.hpp"
+
+#include <memory>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		struct thread_arena {
+			std::unique_ptr<std::byte[]> block{ new std::byte[arena_block_size] };
+			std::pmr::monotonic_buffer_resource resource{ block.get(), arena_block_size, std::pmr::new_delete_resource() };
+			// open scopes, a page being written may parse another file while one is still open
+			std::size_t depth = 0;
+		};
+
+		thread_arena& local_arena() {
+			thread_local thread_arena arena;
+			return arena;
+		}
+
+	} // namespace
+
+	arena_scope::arena_scope() {
+		++local_arena().depth;
+	}
+
+	arena_scope::~arena_scope() {
+		auto& arena = local_arena();
+		if (--arena.depth == 0) {
+			// back to the start of the block, spilled chunks are handed back
+			arena.resource.release();
+		}
+	}
+
+	std::pmr::memory_resource* arena_scope::resource() const {
+		return &local_arena().resource;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,31 @@
+#ifndef DOCS_GEN_ARENA_H
+#define DOCS_GEN_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace docs_gen_core {
+
+	// bytes every parsing thread keeps for its arena
+	constexpr std::size_t arena_block_size = 256 * 1024;
+
+	// per-thread scratch memory for what a parser builds and drops within one file
+	//
+	// a monotonic arena over a block each thread keeps for the whole run: allocating bumps a
+	// pointer, freeing does nothing, and everything goes at once when the outermost scope on the
+	// thread ends. a file that needs more than the block spills into heap chunks that go with it.
+	// nothing the model keeps may come from here, it is reused by the next file
+	class arena_scope {
+	public:
+		arena_scope();
+		arena_scope(const arena_scope&) = delete;
+		arena_scope& operator=(const arena_scope&) = delete;
+		~arena_scope();
+
+		// the calling thread's arena
+		[[nodiscard]] std::pmr::memory_resource* resource() const;
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_ARENA_H
@@ -0,0 +1,76 @@
+#include "batch.hpp"
+
+#include <fstream>
+
+#include "log.hpp"
+#include "trace.hpp"
+
+namespace docs_gen_core {
+
+	batch::batch(std::size_t workers)
+		: pool_(workers) {}
+
+	bool batch::add_project(const std::wstring& root, const std::vector<std::wstring>& ignored_folders) {
+		auto p = std::make_unique<dir>();
+		if (!p->set_path(root)) {
+			DOCS_GEN_LOG_ERROR(general, "invalid project root: ", std::filesystem::path(root));
+			return false;
+		}
+
+		p->set_ignored_folders(ignored_folders);
+		p->set_parse_options(options_);
+		p->set_streaming(streaming_);
+		p->set_expand_instances(expand_depth_);
+		p->set_thread_pool(&pool_);
+		p->set_parse_cache(&cache_);
+		p->set_parse_stats(stats_);
+		p->set_reachable_only(reachable_only_);
+		p->set_entry_points(entry_points_);
+		p->set_shard(shard_index_, shard_count_);
+		p->set_budget(budget_);
+		projects_.push_back(std::move(p));
+		return true;
+	}
+
+	bool batch::add_manifest(const std::filesystem::path& manifest, const std::vector<std::wstring>& ignored_folders) {
+		std::ifstream in(manifest);
+		if (!in.is_open()) {
+			DOCS_GEN_LOG_ERROR(general, "could not open manifest: ", manifest);
+			return false;
+		}
+
+		bool ok = true;
+		std::string line;
+		while (std::getline(in, line)) {
+			const auto first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos || line[first] == '#')
+				continue;
+			const auto last = line.find_last_not_of(" \t\r");
+
+			auto root = std::filesystem::u8path(line.substr(first, last - first + 1));
+			if (root.is_relative()) {
+				root = manifest.parent_path() / root;
+			}
+			ok &= add_project(root.wstring(), ignored_folders);
+		}
+		return ok;
+	}
+
+	void batch::run() {
+		DOCS_GEN_TRACE_SCOPE(span, "batch", "batch");
+		DOCS_GEN_LOG_INFO(general, "Documenting ", projects_.size(), " projects on ", worker_count(), " threads");
+
+		pool_.for_each(projects_.size(), [this](std::size_t i) {
+			auto& p = *projects_[i];
+			DOCS_GEN_TRACE_SCOPE(project_span, "project", "batch");
+			project_span.set_detail(p.get_path());
+			p.construct_file_tree();
+			p.gen_docs();
+		});
+
+		DOCS_GEN_LOG_INFO(general, "Scripts shared between projects: ", cache_.hits(), " cache hits, ", cache_.misses(), " parsed");
+		span.arg("projects", projects_.size());
+		span.arg("cache_hits", cache_.hits());
+	}
+
+} // docs_gen_core
@@ -0,0 +1,75 @@
+#ifndef DOCS_GEN_BATCH_H
+#define DOCS_GEN_BATCH_H
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dir.hpp"
+#include "parse_cache.hpp"
+#include "parse_stats.hpp"
+#include "thread_pool.hpp"
+
+namespace docs_gen_core {
+
+	// documents several projects in one process
+	//
+	// projects are scheduled on one worker pool and their files are parsed on the same pool;
+	// byte-identical scripts (vendored addons) are parsed once for the whole batch;
+	// every project still gets its own <root>/docs, same as a single run
+	class batch {
+		thread_pool pool_;
+		parse_cache cache_;
+		std::vector<std::unique_ptr<dir>> projects_;
+		parse_options options_;
+		bool streaming_ = false;
+		std::size_t expand_depth_ = 0;
+		parse_stats* stats_ = nullptr;
+		bool reachable_only_ = false;
+		std::vector<std::wstring> entry_points_;
+		std::size_t shard_index_ = 0;
+		std::size_t shard_count_ = 1;
+		std::chrono::milliseconds budget_{ 0 };
+
+	public:
+		explicit batch(std::size_t workers = thread_pool::default_workers());
+		batch(const batch&) = delete;
+		batch& operator=(const batch&) = delete;
+
+		// applies to the projects added after the call
+		void set_parse_options(const parse_options& options) { options_ = options; }
+		// applies to the projects added after the call, see dir::set_streaming
+		void set_streaming(bool streaming) { streaming_ = streaming; }
+		// applies to the projects added after the call, see dir::set_expand_instances
+		void set_expand_instances(std::size_t depth) { expand_depth_ = depth; }
+		// applies to the projects added after the call, see dir::set_parse_stats
+		void set_parse_stats(parse_stats* stats) { stats_ = stats; }
+		// applies to the projects added after the call, see dir::set_reachable_only
+		void set_reachable_only(bool reachable) { reachable_only_ = reachable; }
+		// applies to the projects added after the call, res:// paths are taken in each project
+		void set_entry_points(const std::vector<std::wstring>& roots) { entry_points_ = roots; }
+		// applies to the projects added after the call, every project is merged on its own
+		void set_shard(std::size_t index, std::size_t count) {
+			shard_index_ = index;
+			shard_count_ = count;
+		}
+		// applies to the projects added after the call, each project's budget starts with it
+		void set_budget(std::chrono::milliseconds budget) { budget_ = budget; }
+
+		[[nodiscard]] bool add_project(const std::wstring& root, const std::vector<std::wstring>& ignored_folders);
+		// one project root per line, blank lines and lines starting with '#' are skipped,
+		// relative roots are taken relative to the manifest
+		[[nodiscard]] bool add_manifest(const std::filesystem::path& manifest, const std::vector<std::wstring>& ignored_folders);
+
+		void run();
+
+		[[nodiscard]] const std::vector<std::unique_ptr<dir>>& get_projects() const { return projects_; }
+		[[nodiscard]] const parse_cache& get_parse_cache() const { return cache_; }
+		[[nodiscard]] std::size_t worker_count() const { return pool_.worker_count() + 1; }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_BATCH_H
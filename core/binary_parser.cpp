@@ -0,0 +1,967 @@
+#include "binary_parser.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "log.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		// layout constants of Godot's ResourceFormatLoaderBinary and SceneState
+		constexpr std::uint32_t format_flag_named_scene_ids = 1;
+		constexpr std::uint32_t format_flag_uids = 2;
+		constexpr std::uint32_t format_flag_real_t_is_double = 4;
+		constexpr std::uint32_t format_flag_has_script_class = 8;
+		constexpr int reserved_fields = 11;
+		constexpr std::uint32_t format_version_no_nodepath_property = 3;
+
+		enum variant_type : std::uint32_t {
+			variant_nil = 1,
+			variant_bool = 2,
+			variant_int = 3,
+			variant_float = 4,
+			variant_string = 5,
+			variant_vector2 = 10,
+			variant_rect2 = 11,
+			variant_vector3 = 12,
+			variant_plane = 13,
+			variant_quaternion = 14,
+			variant_aabb = 15,
+			variant_basis = 16,
+			variant_transform3d = 17,
+			variant_transform2d = 18,
+			variant_color = 20,
+			variant_node_path = 22,
+			variant_rid = 23,
+			variant_object = 24,
+			variant_input_event = 25,
+			variant_dictionary = 26,
+			variant_array = 30,
+			variant_packed_byte_array = 31,
+			variant_packed_int32_array = 32,
+			variant_packed_float32_array = 33,
+			variant_packed_string_array = 34,
+			variant_packed_vector3_array = 35,
+			variant_packed_color_array = 36,
+			variant_packed_vector2_array = 37,
+			variant_int64 = 40,
+			variant_double = 41,
+			variant_callable = 42,
+			variant_signal = 43,
+			variant_string_name = 44,
+			variant_vector2i = 45,
+			variant_rect2i = 46,
+			variant_vector3i = 47,
+			variant_packed_int64_array = 48,
+			variant_packed_float64_array = 49,
+			variant_vector4 = 50,
+			variant_vector4i = 51,
+			variant_projection = 52,
+			variant_packed_vector4_array = 53,
+		};
+
+		enum object_type : std::uint32_t {
+			object_empty = 0,
+			object_external_resource = 1,
+			object_internal_resource = 2,
+			object_external_resource_index = 3,
+		};
+
+		constexpr std::int32_t scene_flag_id_is_path = 1 << 30;
+		constexpr std::int32_t scene_flag_mask = (1 << 24) - 1;
+		constexpr std::int32_t scene_flag_instance_is_placeholder = 1 << 30;
+		constexpr std::int32_t scene_flag_prop_name_mask = (1 << 30) - 1;
+		constexpr std::int32_t scene_type_instantiated = 0x7FFFFFFF;
+		constexpr int scene_name_index_bits = 18;
+
+		std::wstring format_number(double d, bool is_double) {
+			char buf[32];
+			std::snprintf(buf, sizeof(buf), is_double ? "%.17g" : "%.9g", d);
+			return { buf, buf + std::strlen(buf) };
+		}
+
+		// scalars keep a trailing ".0" the way the text format writes them
+		std::wstring format_scalar(double d, bool is_double) {
+			auto s = format_number(d, is_double);
+			if (s.find_first_of(L".en") == std::wstring::npos) s += L".0";
+			return s;
+		}
+
+		const wchar_t* packed_name(std::uint32_t type) {
+			switch (type) {
+			case variant_packed_byte_array: return L"PackedByteArray";
+			case variant_packed_int32_array: return L"PackedInt32Array";
+			case variant_packed_int64_array: return L"PackedInt64Array";
+			case variant_packed_float32_array: return L"PackedFloat32Array";
+			case variant_packed_float64_array: return L"PackedFloat64Array";
+			case variant_packed_string_array: return L"PackedStringArray";
+			case variant_packed_vector2_array: return L"PackedVector2Array";
+			case variant_packed_vector3_array: return L"PackedVector3Array";
+			case variant_packed_vector4_array: return L"PackedVector4Array";
+			case variant_packed_color_array: return L"PackedColorArray";
+			default: return L"Packed";
+			}
+		}
+
+		// the dictionary value stored under a string key, null if there is none
+		const binary_parser::variant* find_key(const binary_parser::variant& dict, const wchar_t* key) {
+			using kind = binary_parser::variant::kind;
+			if (dict.k != kind::dictionary) return nullptr;
+			for (std::size_t i = 0; i + 1 < dict.items.size(); i += 2) {
+				if (dict.items[i].k == kind::string && dict.items[i].text == key)
+					return &dict.items[i + 1];
+			}
+			return nullptr;
+		}
+
+	} // namespace
+
+	bool is_binary_resource(const std::filesystem::path& path) {
+		const auto ext = path.extension();
+		return ext == ".scn" || ext == ".res";
+	}
+
+	binary_parser::binary_parser(const std::shared_ptr<dott_file>& file, const parse_options& options)
+		: file_(file), options_(options), cancel_(options.cancel), strings_(arena_.resource()), ext_resources_(arena_.resource()),
+		int_resources_(arena_.resource()), bytes_(arena_.resource()), text_(arena_.resource()) {
+		in_.open(file_->get_path(), std::ios::in | std::ios::binary);
+		if (!in_.is_open()) {
+			DOCS_GEN_LOG_ERROR(parse, "could not open file: ", file_->get_path());
+			return;
+		}
+
+		std::error_code ec;
+		size_ = std::filesystem::file_size(file_->get_path(), ec);
+	}
+
+	bool binary_parser::parse_scene_header() {
+		if (!read_header()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary scene file: ", file_->get_path());
+			return false;
+		}
+
+		auto file = dynamic_cast<scene_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		file->set_uid(uid_);
+		return true;
+	}
+
+	bool binary_parser::parse_resource_header() {
+		if (!read_header()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary resource file: ", file_->get_path());
+			return false;
+		}
+
+		auto file = dynamic_cast<resource_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		file->set_uid(uid_);
+		file->set_script_class(script_class_);
+		return true;
+	}
+
+	bool binary_parser::parse_scene_file_contents(const link_context& ctx) {
+		return parse_scene_links(ctx) && parse_scene_body();
+	}
+
+	bool binary_parser::parse_scene_links(const link_context& ctx) {
+		auto file = dynamic_cast<scene_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		DOCS_GEN_LOG_DEBUG(parse, "processing binary scene file ", file->get_path());
+		if (!load_tables()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary scene file: ", file->get_path());
+			return false;
+		}
+		link_ext_resources(ctx);
+		return true;
+	}
+
+	bool binary_parser::parse_scene_body() {
+		auto file = dynamic_cast<scene_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		if (!load_tables()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary scene file: ", file->get_path());
+			return false;
+		}
+		if (compressed_ || int_resources_.empty())
+			return true;
+
+		// the PackedScene is the last internal resource, its "_bundled" dictionary is the node tree
+		std::wstring type;
+		std::uint32_t property_count = 0;
+		if (!open_resource(int_resources_.size() - 1, type, property_count) || type != L"PackedScene") {
+			DOCS_GEN_LOG_WARNING(parse, "binary scene without a PackedScene: ", file->get_path());
+			return true;
+		}
+
+		for (std::uint32_t i = 0; i < property_count; ++i) {
+			const std::wstring name(read_string_ref());
+			const bool bundled = name == L"_bundled";
+			variant v{ arena_.resource() };
+			if (!read_variant(v, bundled)) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (unreadable property ", name, "): ", file->get_path());
+				return true;
+			}
+			if (bundled) {
+				read_node_tree(v);
+				break;
+			}
+		}
+
+		return !cancel_.cancelled();
+	}
+
+	bool binary_parser::parse_resource_file_contents(const link_context& ctx) {
+		return parse_resource_links(ctx) && parse_resource_body();
+	}
+
+	bool binary_parser::parse_resource_links(const link_context& ctx) {
+		auto file = dynamic_cast<resource_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		DOCS_GEN_LOG_DEBUG(parse, "processing binary resource file ", file->get_path());
+		if (!load_tables()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary resource file: ", file->get_path());
+			return false;
+		}
+		link_ext_resources(ctx);
+		return true;
+	}
+
+	bool binary_parser::parse_resource_body() {
+		auto file = dynamic_cast<resource_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		if (!load_tables()) {
+			DOCS_GEN_LOG_ERROR(parse, "corrupted binary resource file: ", file->get_path());
+			return false;
+		}
+		if (compressed_ || int_resources_.empty())
+			return true;
+
+		// internal resources are stored dependencies first, the main resource last
+		for (std::size_t i = 0; i + 1 < int_resources_.size(); ++i) {
+			if (cancel_())
+				return false;
+			resource_file::resource r{};
+			if (!read_resource(i, r)) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary resource file (invalid sub_resource): ", file->get_path());
+				continue;
+			}
+			file->push_sub_resource(std::wstring(int_resources_[i].id), std::make_shared<resource_file::resource>(std::move(r)));
+		}
+
+		resource_file::resource r{};
+		if (!read_resource(int_resources_.size() - 1, r)) {
+			DOCS_GEN_LOG_WARNING(parse, "corrupted binary resource file (invalid resource): ", file->get_path());
+		}
+		file->set_resource(std::move(r));
+		return true;
+	}
+
+	bool binary_parser::load_tables() {
+		if (!tables_read_) {
+			tables_read_ = read_header() && read_tables();
+		}
+		return tables_read_;
+	}
+
+	bool binary_parser::read_header() {
+		in_.clear();
+		in_.seekg(0);
+
+		char magic[4];
+		if (!in_.read(magic, 4))
+			return false;
+
+		if (std::memcmp(magic, "RSCC", 4) == 0) {
+			// the whole stream is block compressed, nothing past the magic can be read without inflating it
+			DOCS_GEN_LOG_WARNING(parse, "compressed binary resource, only indexed by path: ", file_->get_path());
+			compressed_ = true;
+			return true;
+		}
+		if (std::memcmp(magic, "RSRC", 4) != 0)
+			return false;
+
+		big_endian_ = false;
+		big_endian_ = read_u32() != 0;
+		real_is_double_ = read_u32() != 0;
+		static_cast<void>(read_u32()); // engine major
+		static_cast<void>(read_u32()); // engine minor
+		format_ = read_u32();
+		type_ = read_unicode_string();
+		static_cast<void>(read_u64()); // import metadata offset
+
+		const auto flags = read_u32();
+		named_ids_ = flags & format_flag_named_scene_ids;
+		real_is_double_ = real_is_double_ || (flags & format_flag_real_t_is_double);
+		using_uids_ = flags & format_flag_uids;
+		const auto uid = read_u64();
+		uid_ = using_uids_ ? uid : invalid_uid;
+		if (flags & format_flag_has_script_class) {
+			script_class_ = read_unicode_string();
+		}
+		for (int i = 0; i < reserved_fields; ++i) {
+			static_cast<void>(read_u32());
+		}
+
+		return static_cast<bool>(in_);
+	}
+
+	bool binary_parser::read_tables() {
+		if (compressed_)
+			return true;
+
+		// every table entry takes at least 4 bytes, larger counts can only come from a broken file
+		const auto fits = [this](std::uint32_t n) { return n <= size_ / 4; };
+
+		const auto string_count = read_u32();
+		if (!in_ || !fits(string_count))
+			return false;
+		strings_.resize(string_count);
+		for (auto& s : strings_) {
+			s = read_unicode_string();
+		}
+
+		const auto ext_count = read_u32();
+		if (!in_ || !fits(ext_count))
+			return false;
+		ext_resources_.resize(ext_count);
+		for (auto& er : ext_resources_) {
+			er.type = read_unicode_string();
+			er.path = read_unicode_string();
+			if (using_uids_) {
+				er.uid = read_u64();
+			}
+		}
+
+		const auto int_count = read_u32();
+		if (!in_ || !fits(int_count))
+			return false;
+		int_resources_.resize(int_count);
+		for (std::size_t i = 0; i < int_resources_.size(); ++i) {
+			auto& ir = int_resources_[i];
+			ir.id = read_unicode_string();
+			ir.offset = read_u64();
+
+			// "local://Curve_abc12" in the named format, "res://path::3" before it
+			constexpr std::wstring_view local = L"local://";
+			if (ir.id.compare(0, local.size(), local) == 0) {
+				ir.id.erase(0, local.size());
+			}
+			else if (const auto sep = ir.id.rfind(L"::"); sep != std::wstring::npos) {
+				ir.id.erase(0, sep + 2);
+			}
+			if (!named_ids_ && ir.id.empty()) {
+				ir.id = std::to_wstring(i);
+			}
+		}
+
+		return static_cast<bool>(in_);
+	}
+
+	void binary_parser::link_ext_resources(const link_context& ctx) {
+		auto scene = dynamic_cast<scene_file*>(file_.get());
+		auto resource = dynamic_cast<resource_file*>(file_.get());
+
+		for (std::size_t i = 0; i < ext_resources_.size(); ++i) {
+			const auto& er = ext_resources_[i];
+			// binary files refer to external resources by table index
+			const auto id = std::to_wstring(i);
+
+			if (er.type == L"PackedScene") {
+				auto f = std::static_pointer_cast<scene_file>(ctx.resolve(er.uid, er.path, file_kind::scene));
+				if (!f) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered scene file: ", std::wstring_view(er.path));
+					continue;
+				}
+				file_->push_packed_scene(id, f);
+			}
+			else if (er.type == L"Script" || er.type == L"GDScript") {
+				auto f = std::static_pointer_cast<script_file>(ctx.resolve(invalid_uid, er.path, file_kind::script));
+				if (!f) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered script file: ", std::wstring_view(er.path));
+					continue;
+				}
+				if (scene) scene->push_script(id, f);
+				if (resource) resource->push_script(id, f);
+			}
+			else if (auto f = std::static_pointer_cast<resource_file>(ctx.resolve(er.uid, er.path, file_kind::resource))) {
+				// binary files name the concrete class, so any type may be a documented resource
+				file_->push_ext_resource(id, f);
+			}
+			else {
+				constexpr std::wstring_view res = L"res://";
+				std::wstring_view path = er.path;
+				if (path.substr(0, res.size()) == res) {
+					path.remove_prefix(res.size());
+				}
+				file_->push_ext_resource_other(id, { std::wstring(er.type), std::filesystem::path(path) });
+			}
+		}
+		file_->freeze_links();
+	}
+
+	bool binary_parser::open_resource(std::size_t index, std::wstring& type, std::uint32_t& property_count) {
+		if (index >= int_resources_.size() || int_resources_[index].offset >= size_)
+			return false;
+
+		in_.clear();
+		in_.seekg(static_cast<std::streamoff>(int_resources_[index].offset));
+		type = read_unicode_string();
+		property_count = read_u32();
+		return static_cast<bool>(in_);
+	}
+
+	bool binary_parser::read_resource(std::size_t index, resource_file::resource& r) {
+		std::uint32_t property_count = 0;
+		if (!open_resource(index, r.type, property_count))
+			return false;
+
+		const auto cap = options_.max_value_bytes;
+		field_count_ += property_count;
+		for (std::uint32_t i = 0; i < property_count; ++i) {
+			std::wstring name(read_string_ref());
+			variant v{ arena_.resource() };
+			if (!read_variant(v, false))
+				return false;
+
+			if (v.k == variant::kind::ext_resource) {
+				const auto id = std::to_wstring(v.index);
+				if (const auto* ps = file_->get_packed_scenes().find(id)) {
+					r.res_file_fields.push_back({ std::move(name), *ps });
+					continue;
+				}
+
+				if (const auto* sf = static_cast<resource_file*>(file_.get())->get_scripts().find(id)) {
+					r.res_file_fields.push_back({ std::move(name), *sf });
+					continue;
+				}
+
+				if (const auto* rf = file_->get_ext_resources().find(id)) {
+					r.res_file_fields.push_back({ std::move(name), *rf });
+					continue;
+				}
+
+				if (const auto* ero = file_->get_ext_resource_other().find(id)) {
+					r.res_other_fields.push_back({ std::move(name), ero->name });
+				}
+			}
+			else if (v.k == variant::kind::sub_resource) {
+				const auto& srf = static_cast<resource_file*>(file_.get())->get_sub_resources();
+				if (const auto it = srf.find(std::wstring(int_resources_[v.index].id)); it != srf.end()) {
+					r.sub_res_fields.push_back({ std::move(name), it->second });
+				}
+			}
+			else {
+				auto text = to_text(v);
+				if (cap != 0 && text.size() > cap) {
+					const auto elements = v.k == variant::kind::array ? v.items.size()
+						: v.k == variant::kind::dictionary ? v.items.size() / 2
+						: summary_no_count;
+					text = summarize_value(v.k == variant::kind::dictionary ? L"Dictionary" : L"Array", elements, text.size());
+				}
+				r.fields.push_back({ std::move(name), std::move(text) });
+			}
+		}
+		return true;
+	}
+
+	void binary_parser::read_node_tree(const variant& bundled) {
+		auto file = static_cast<scene_file*>(file_.get());
+		const auto* names = find_key(bundled, L"names");
+		const auto* nodes = find_key(bundled, L"nodes");
+		const auto* variants = find_key(bundled, L"variants");
+		const auto* node_count = find_key(bundled, L"node_count");
+		const auto* node_paths = find_key(bundled, L"node_paths");
+		if (!names || !nodes || !variants || !node_count) {
+			DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (incomplete node data): ", file->get_path());
+			return;
+		}
+
+		const auto& n = names->strings;
+		const auto& r = nodes->ints;
+		const auto name_of = [&](std::int32_t i) -> std::wstring {
+			return i >= 0 && static_cast<std::size_t>(i) < n.size() ? std::wstring(n[i]) : std::wstring{};
+		};
+		const auto variant_at = [&](std::int32_t i) -> const variant* {
+			return i >= 0 && static_cast<std::size_t>(i) < variants->items.size() ? &variants->items[i] : nullptr;
+		};
+
+		// "." for the root, then paths relative to it the way .tscn parent attributes are written
+		std::pmr::vector<std::pmr::wstring> paths{ arena_.resource() };
+		auto& tree = file->get_node_tree();
+		std::size_t idx = 0;
+		for (std::int64_t i = 0; i < node_count->integer; ++i) {
+			if (cancel_())
+				return;
+			if (idx + 6 > r.size()) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (truncated node data): ", file->get_path());
+				return;
+			}
+
+			const auto parent = r[idx++];
+			idx++; // owner
+			const auto type = r[idx++];
+			const auto name = name_of(r[idx++] & ((1 << scene_name_index_bits) - 1));
+			const auto instance = r[idx++];
+			// both counts are read from the file, checked against what is left before idx moves
+			const auto stored_properties = r[idx++];
+			if (stored_properties < 0 || static_cast<std::size_t>(stored_properties) > (r.size() - idx) / 2) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (invalid property count): ", file->get_path());
+				return;
+			}
+			const auto property_count = static_cast<std::size_t>(stored_properties);
+			const auto properties = idx;
+			idx += property_count * 2;
+			if (idx >= r.size()) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (truncated node data): ", file->get_path());
+				return;
+			}
+			const auto groups = r[idx];
+			if (groups < 0 || static_cast<std::size_t>(groups) >= r.size() - idx) {
+				DOCS_GEN_LOG_WARNING(parse, "corrupted binary scene file (invalid group count): ", file->get_path());
+				return;
+			}
+			idx += static_cast<std::size_t>(groups) + 1;
+
+			std::wstring parent_path;
+			if (parent >= 0 && (parent & scene_flag_id_is_path)) {
+				const auto p = parent & scene_flag_mask;
+				if (node_paths && static_cast<std::size_t>(p) < node_paths->items.size())
+					parent_path = node_paths->items[p].text;
+			}
+			else if (parent >= 0 && static_cast<std::size_t>(parent) < paths.size()) {
+				parent_path = paths[parent];
+			}
+			auto& path = paths.emplace_back();
+			if (parent < 0) {
+				path = L".";
+			}
+			else if (parent_path == L".") {
+				path = name;
+			}
+			else {
+				path = parent_path;
+				path += L'/';
+				path += name;
+			}
+
+			auto tn = tree.end();
+			if (type != scene_type_instantiated) {
+				tn = tree.insert(name, name_of(type), parent_path);
+			}
+			else if (instance >= 0 && !(instance & scene_flag_instance_is_placeholder)) {
+				const auto* v = variant_at(instance & scene_flag_mask);
+				const auto* scene = v && v->k == variant::kind::ext_resource ? file->get_packed_scenes().find(std::to_wstring(v->index)) : nullptr;
+				if (scene) {
+					tn = tree.insert(name, L"PackedScene", parent_path);
+					if (tn != tree.end())
+						(*tn)->instance = *scene;
+				}
+			}
+			else {
+				tn = tree.insert(name, L"Unknown", parent_path);
+			}
+
+			if (tn == tree.end())
+				continue;
+
+			++node_count_;
+			field_count_ += property_count;
+			for (std::size_t j = 0; j < property_count; ++j) {
+				const auto* v = variant_at(r[properties + j * 2 + 1]);
+				if (!v)
+					continue;
+				if (v->k != variant::kind::ext_resource) {
+					if (options_.node_properties) {
+						(*tn)->properties.emplace_back(name_of(r[properties + j * 2] & scene_flag_prop_name_mask), to_text(*v));
+					}
+					continue;
+				}
+
+				const auto prop = name_of(r[properties + j * 2] & scene_flag_prop_name_mask);
+				const auto id = std::to_wstring(v->index);
+				if (const auto* sf = file->get_packed_scenes().find(id)) {
+					(*tn)->ext_resource_fields.emplace_back(prop, *sf);
+					continue;
+				}
+
+				if (const auto* scf = file->get_scripts().find(id)) {
+					(*tn)->ext_resource_fields.emplace_back(prop, *scf);
+					continue;
+				}
+
+				if (const auto* rf = file->get_ext_resources().find(id)) {
+					(*tn)->ext_resource_fields.emplace_back(prop, *rf);
+				}
+			}
+		}
+	}
+
+	bool binary_parser::read_variant(variant& v, bool keep) {
+		using kind = variant::kind;
+		const auto type = read_u32();
+		if (!in_)
+			return false;
+
+		switch (type) {
+		case variant_nil:
+			v.k = kind::nil;
+			v.text = L"null";
+			break;
+		case variant_bool:
+			v.k = kind::scalar;
+			v.integer = read_u32() != 0;
+			v.text = v.integer ? L"true" : L"false";
+			break;
+		case variant_int:
+			v.k = kind::scalar;
+			v.integer = static_cast<std::int32_t>(read_u32());
+			v.text = std::to_wstring(v.integer);
+			break;
+		case variant_int64:
+			v.k = kind::scalar;
+			v.integer = static_cast<std::int64_t>(read_u64());
+			v.text = std::to_wstring(v.integer);
+			break;
+		case variant_float:
+			v.k = kind::scalar;
+			v.text = format_scalar(read_real(), real_is_double_);
+			break;
+		case variant_double:
+			v.k = kind::scalar;
+			v.text = format_scalar(read_double(), true);
+			break;
+		case variant_string:
+		case variant_string_name:
+			v.k = kind::string;
+			v.text = read_unicode_string();
+			break;
+		case variant_vector2: v.k = kind::scalar; return read_reals(v.text, L"Vector2", 2);
+		case variant_rect2: v.k = kind::scalar; return read_reals(v.text, L"Rect2", 4);
+		case variant_vector3: v.k = kind::scalar; return read_reals(v.text, L"Vector3", 3);
+		case variant_vector4: v.k = kind::scalar; return read_reals(v.text, L"Vector4", 4);
+		case variant_plane: v.k = kind::scalar; return read_reals(v.text, L"Plane", 4);
+		case variant_quaternion: v.k = kind::scalar; return read_reals(v.text, L"Quaternion", 4);
+		case variant_aabb: v.k = kind::scalar; return read_reals(v.text, L"AABB", 6);
+		case variant_transform2d: v.k = kind::scalar; return read_reals(v.text, L"Transform2D", 6);
+		case variant_basis: v.k = kind::scalar; return read_reals(v.text, L"Basis", 9);
+		case variant_transform3d: v.k = kind::scalar; return read_reals(v.text, L"Transform3D", 12);
+		case variant_projection: v.k = kind::scalar; return read_reals(v.text, L"Projection", 16);
+		case variant_color: {
+			v.k = kind::scalar;
+			v.text = L"Color(";
+			for (int i = 0; i < 4; ++i) {
+				if (i) v.text += L", ";
+				v.text += format_number(read_float(), false);
+			}
+			v.text += L")";
+			break;
+		}
+		case variant_vector2i:
+		case variant_rect2i:
+		case variant_vector3i:
+		case variant_vector4i: {
+			const auto n = type == variant_vector2i ? 2 : type == variant_vector3i ? 3 : 4;
+			v.k = kind::scalar;
+			v.text = type == variant_vector2i ? L"Vector2i(" : type == variant_rect2i ? L"Rect2i(" : type == variant_vector3i ? L"Vector3i(" : L"Vector4i(";
+			for (int i = 0; i < n; ++i) {
+				if (i) v.text += L", ";
+				v.text += std::to_wstring(static_cast<std::int32_t>(read_u32()));
+			}
+			v.text += L")";
+			break;
+		}
+		case variant_node_path: {
+			v.k = kind::node_path;
+			const auto name_count = read_u16();
+			std::uint32_t subname_count = read_u16();
+			const bool absolute = subname_count & 0x8000;
+			subname_count &= 0x7FFF;
+			if (format_ < format_version_no_nodepath_property) {
+				subname_count += 1;
+			}
+
+			if (absolute) v.text = L"/";
+			for (std::uint32_t i = 0; i < name_count; ++i) {
+				if (i) v.text += L"/";
+				v.text += read_string_ref();
+			}
+			for (std::uint32_t i = 0; i < subname_count; ++i) {
+				v.text += L":";
+				v.text += read_string_ref();
+			}
+			break;
+		}
+		case variant_rid:
+			v.k = kind::scalar;
+			v.text = L"RID()";
+			static_cast<void>(read_u32());
+			break;
+		case variant_callable:
+		case variant_signal:
+		case variant_input_event:
+			v.k = kind::nil;
+			v.text = L"null";
+			break;
+		case variant_object: {
+			const auto object = read_u32();
+			switch (object) {
+			case object_empty:
+				v.k = kind::nil;
+				v.text = L"null";
+				break;
+			case object_internal_resource:
+				v.index = read_u32();
+				if (v.index >= int_resources_.size())
+					return false;
+				v.k = kind::sub_resource;
+				break;
+			case object_external_resource_index:
+				v.index = read_u32();
+				if (v.index >= ext_resources_.size())
+					return false;
+				v.k = kind::ext_resource;
+				break;
+			case object_external_resource: {
+				// pre 3.x layout with the type and path inline, only the path can be shown
+				static_cast<void>(read_unicode_string());
+				v.k = kind::string;
+				v.text = read_unicode_string();
+				break;
+			}
+			default:
+				return false;
+			}
+			break;
+		}
+		case variant_dictionary:
+		case variant_array: {
+			// the top bit marks shared containers
+			const auto count = read_u32() & 0x7FFFFFFF;
+			const auto per_item = type == variant_dictionary ? 2u : 1u;
+			if (!in_ || count > size_ / 4)
+				return false;
+			v.k = type == variant_dictionary ? kind::dictionary : kind::array;
+			v.items.resize(static_cast<std::size_t>(count) * per_item);
+			for (auto& item : v.items) {
+				if (!read_variant(item, keep))
+					return false;
+			}
+			break;
+		}
+		case variant_packed_string_array: {
+			const auto count = read_u32();
+			if (!in_ || count > size_ / 4)
+				return false;
+			v.k = kind::packed;
+			const auto start = static_cast<std::uint64_t>(in_.tellg());
+			for (std::uint32_t i = 0; i < count; ++i) {
+				if (keep) {
+					v.strings.emplace_back(read_unicode_string());
+				}
+				else if (!skip(read_u32())) {
+					return false;
+				}
+			}
+			v.text = summarize_value(packed_name(type), count, static_cast<std::uint64_t>(in_.tellg()) - start);
+			break;
+		}
+		case variant_packed_byte_array:
+		case variant_packed_int32_array:
+		case variant_packed_int64_array:
+		case variant_packed_float32_array:
+		case variant_packed_float64_array:
+		case variant_packed_vector2_array:
+		case variant_packed_vector3_array:
+		case variant_packed_vector4_array:
+		case variant_packed_color_array: {
+			const auto count = read_u32();
+			const std::uint64_t real = real_is_double_ ? 8 : 4;
+			std::uint64_t stride = 1;
+			switch (type) {
+			case variant_packed_int32_array: case variant_packed_float32_array: stride = 4; break;
+			case variant_packed_int64_array: case variant_packed_float64_array: stride = 8; break;
+			case variant_packed_vector2_array: stride = 2 * real; break;
+			case variant_packed_vector3_array: stride = 3 * real; break;
+			case variant_packed_vector4_array: stride = 4 * real; break;
+			case variant_packed_color_array: stride = 16; break;
+			default: break;
+			}
+
+			auto bytes = count * stride;
+			// byte arrays are padded to 4
+			if (type == variant_packed_byte_array && bytes % 4) bytes += 4 - bytes % 4;
+			if (!in_ || bytes > size_)
+				return false;
+
+			v.k = kind::packed;
+			v.text = summarize_value(packed_name(type), count, count * stride);
+			if (keep && type == variant_packed_int32_array) {
+				v.ints.resize(count);
+				for (auto& x : v.ints) x = static_cast<std::int32_t>(read_u32());
+			}
+			else if (!skip(bytes)) {
+				return false;
+			}
+			break;
+		}
+		default:
+			DOCS_GEN_LOG_DEBUG(parse, "unsupported binary variant type ", type, " in ", file_->get_path());
+			return false;
+		}
+
+		return static_cast<bool>(in_);
+	}
+
+	std::wstring binary_parser::to_text(const variant& v) const {
+		using kind = variant::kind;
+		// into the model, so built as std::wstring rather than on the arena
+		const auto wrap = [](const wchar_t* open, std::wstring_view text, const wchar_t* close) {
+			std::wstring s = open;
+			s += text;
+			s += close;
+			return s;
+		};
+		switch (v.k) {
+		case kind::string: return wrap(L"\"", v.text, L"\"");
+		case kind::node_path: return wrap(L"NodePath(\"", v.text, L"\")");
+		case kind::ext_resource: return wrap(L"ExtResource(\"", std::to_wstring(v.index), L"\")");
+		case kind::sub_resource: return wrap(L"SubResource(\"", int_resources_[v.index].id, L"\")");
+		case kind::array: {
+			std::wstring s = L"[";
+			for (std::size_t i = 0; i < v.items.size(); ++i) {
+				if (i) s += L", ";
+				s += to_text(v.items[i]);
+			}
+			return s + L"]";
+		}
+		case kind::dictionary: {
+			if (v.items.empty()) return L"{}";
+			std::wstring s = L"{ ";
+			for (std::size_t i = 0; i + 1 < v.items.size(); i += 2) {
+				if (i) s += L", ";
+				s += to_text(v.items[i]) + L": " + to_text(v.items[i + 1]);
+			}
+			return s + L" }";
+		}
+		default: return std::wstring(v.text);
+		}
+	}
+
+	bool binary_parser::read_reals(std::pmr::wstring& text, const wchar_t* type, std::size_t n) {
+		text = type;
+		text += L"(";
+		for (std::size_t i = 0; i < n; ++i) {
+			if (i) text += L", ";
+			text += format_number(read_real(), real_is_double_);
+		}
+		text += L")";
+		return static_cast<bool>(in_);
+	}
+
+	bool binary_parser::skip(std::uint64_t bytes) {
+		const auto here = static_cast<std::uint64_t>(in_.tellg());
+		if (!in_ || here + bytes > size_)
+			return false;
+		in_.seekg(static_cast<std::streamoff>(bytes), std::ios::cur);
+		return static_cast<bool>(in_);
+	}
+
+	std::uint16_t binary_parser::read_u16() {
+		unsigned char b[2] = {};
+		in_.read(reinterpret_cast<char*>(b), 2);
+		return big_endian_ ? static_cast<std::uint16_t>(b[0] << 8 | b[1]) : static_cast<std::uint16_t>(b[1] << 8 | b[0]);
+	}
+
+	std::uint32_t binary_parser::read_u32() {
+		unsigned char b[4] = {};
+		in_.read(reinterpret_cast<char*>(b), 4);
+		std::uint32_t v = 0;
+		for (int i = 0; i < 4; ++i) {
+			v |= static_cast<std::uint32_t>(b[big_endian_ ? 3 - i : i]) << (8 * i);
+		}
+		return v;
+	}
+
+	std::uint64_t binary_parser::read_u64() {
+		const std::uint64_t a = read_u32();
+		const std::uint64_t b = read_u32();
+		return big_endian_ ? (a << 32 | b) : (b << 32 | a);
+	}
+
+	double binary_parser::read_real() {
+		return real_is_double_ ? read_double() : read_float();
+	}
+
+	float binary_parser::read_float() {
+		const auto bits = read_u32();
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	double binary_parser::read_double() {
+		const auto bits = read_u64();
+		double d;
+		std::memcpy(&d, &bits, sizeof(d));
+		return d;
+	}
+
+	std::wstring_view binary_parser::read_unicode_string() {
+		const auto n = read_u32();
+		if (!in_ || n > size_)
+			return {};
+		return read_bytes_as_string(n);
+	}
+
+	std::wstring_view binary_parser::read_string_ref() {
+		const auto id = read_u32();
+		if (id & 0x80000000) {
+			const auto n = id & 0x7FFFFFFF;
+			return n > size_ ? std::wstring_view{} : read_bytes_as_string(n);
+		}
+		return id < strings_.size() ? std::wstring_view(strings_[id]) : std::wstring_view{};
+	}
+
+	std::wstring_view binary_parser::read_bytes_as_string(std::uint32_t n) {
+		bytes_.resize(n);
+		in_.read(bytes_.data(), n);
+		// stored null terminated as utf-8, and widened byte by byte so every character stays in
+		// 0..255: path_resolver narrows the characters of a res:// path back to the same bytes to
+		// match its utf-8 keys, and node_tree puts names into node paths as those bytes
+		const auto end = bytes_.find('\0');
+		if (end != std::string::npos) bytes_.resize(end);
+		text_.resize(bytes_.size());
+		std::transform(bytes_.begin(), bytes_.end(), text_.begin(), [](char c) {
+			return static_cast<wchar_t>(static_cast<unsigned char>(c));
+		});
+		return text_;
+	}
+
+} // docs_gen_core
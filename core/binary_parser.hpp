@@ -0,0 +1,186 @@
+#ifndef DOCS_GEN_BINARY_PARSER_H
+#define DOCS_GEN_BINARY_PARSER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arena.hpp"
+#include "file.hpp"
+#include "parser.hpp"
+
+namespace docs_gen_core {
+
+	// .scn and .res, Godot's binary counterparts of .tscn and .tres
+	[[nodiscard]] bool is_binary_resource(const std::filesystem::path& path);
+
+	// reads binary ("RSRC") scenes and resources into the same model the text parser fills
+	//
+	// only the header, the string/external/internal resource tables and the property lists are
+	// read; packed array payloads (meshes, images, baked data) are seeked over, so a file costs
+	// about the same no matter how much data it carries. compressed files ("RSCC") are indexed
+	// by path only
+	//
+	// the tables and decoded values only live as long as the parser, they come from the thread's
+	// arena; what goes into the model is copied out as std::wstring
+	class binary_parser {
+	public:
+		// a decoded property value, containers and packed arrays are only kept when asked for
+		struct variant {
+			using allocator_type = std::pmr::polymorphic_allocator<variant>;
+
+			enum class kind : std::uint8_t {
+				nil,
+				scalar,
+				string,
+				ext_resource,
+				sub_resource,
+				node_path,
+				array,
+				dictionary,
+				packed,
+			};
+
+			kind k = kind::nil;
+			// scalars as the .tscn writer would print them, the raw text of strings and node paths,
+			// a summary for packed arrays
+			std::pmr::wstring text;
+			std::int64_t integer = 0;
+			// external/internal resource table index for the resource kinds
+			std::uint32_t index = 0;
+			// arrays hold their items, dictionaries key, value, key, value...
+			std::pmr::vector<variant> items;
+			// the contents of int32 and string packed arrays when they were kept
+			std::pmr::vector<std::int32_t> ints;
+			std::pmr::vector<std::pmr::wstring> strings;
+
+			explicit variant(const allocator_type& alloc = {})
+				: text(alloc), items(alloc), ints(alloc), strings(alloc) {}
+			variant(const variant& other, const allocator_type& alloc)
+				: k(other.k), text(other.text, alloc), integer(other.integer), index(other.index),
+				items(other.items, alloc), ints(other.ints, alloc), strings(other.strings, alloc) {}
+			variant(variant&& other, const allocator_type& alloc)
+				: k(other.k), text(std::move(other.text), alloc), integer(other.integer), index(other.index),
+				items(std::move(other.items), alloc), ints(std::move(other.ints), alloc), strings(std::move(other.strings), alloc) {}
+			variant(const variant&) = default;
+			variant(variant&&) noexcept = default;
+			variant& operator=(const variant&) = default;
+			variant& operator=(variant&&) noexcept = default;
+		};
+
+	private:
+		struct ext_resource {
+			using allocator_type = std::pmr::polymorphic_allocator<ext_resource>;
+
+			std::pmr::wstring type;
+			std::pmr::wstring path;
+			std::uint64_t uid = invalid_uid;
+
+			explicit ext_resource(const allocator_type& alloc = {})
+				: type(alloc), path(alloc) {}
+			ext_resource(const ext_resource& other, const allocator_type& alloc)
+				: type(other.type, alloc), path(other.path, alloc), uid(other.uid) {}
+			ext_resource(ext_resource&& other, const allocator_type& alloc)
+				: type(std::move(other.type), alloc), path(std::move(other.path), alloc), uid(other.uid) {}
+		};
+
+		struct int_resource {
+			using allocator_type = std::pmr::polymorphic_allocator<int_resource>;
+
+			std::pmr::wstring id;
+			std::uint64_t offset = 0;
+
+			explicit int_resource(const allocator_type& alloc = {})
+				: id(alloc) {}
+			int_resource(const int_resource& other, const allocator_type& alloc)
+				: id(other.id, alloc), offset(other.offset) {}
+			int_resource(int_resource&& other, const allocator_type& alloc)
+				: id(std::move(other.id), alloc), offset(other.offset) {}
+		};
+
+		// first, so it outlives every container below that allocates from it
+		arena_scope arena_;
+		std::shared_ptr<dott_file> file_;
+		parse_options options_;
+		cancel_poll cancel_;
+		std::ifstream in_;
+		std::uint64_t size_ = 0;
+
+		bool big_endian_ = false;
+		bool real_is_double_ = false;
+		bool named_ids_ = false;
+		bool using_uids_ = false;
+		bool compressed_ = false;
+		bool tables_read_ = false;
+		std::uint32_t format_ = 0;
+		std::wstring type_;
+		std::uint64_t uid_ = invalid_uid;
+		std::wstring script_class_;
+		std::size_t node_count_ = 0;
+		std::size_t field_count_ = 0;
+
+		std::pmr::vector<std::pmr::wstring> strings_;
+		std::pmr::vector<ext_resource> ext_resources_;
+		std::pmr::vector<int_resource> int_resources_;
+		// what the string readers hand out, valid until the next read
+		std::pmr::string bytes_;
+		std::pmr::wstring text_;
+
+	public:
+		explicit binary_parser(const std::shared_ptr<dott_file>& file, const parse_options& options = {});
+
+		// external plus internal resources, the closest thing to a .tscn section
+		[[nodiscard]] std::size_t get_section_count() const { return ext_resources_.size() + int_resources_.size(); }
+		[[nodiscard]] std::size_t get_node_count() const { return node_count_; }
+		// node and resource properties read so far
+		[[nodiscard]] std::size_t get_field_count() const { return field_count_; }
+
+		bool parse_scene_header();
+		bool parse_resource_header();
+		bool parse_scene_file_contents(const link_context& ctx);
+		bool parse_resource_file_contents(const link_context& ctx);
+
+		// same split as dott_parser: the external resource table, then the internal resources
+		bool parse_scene_links(const link_context& ctx);
+		bool parse_resource_links(const link_context& ctx);
+		bool parse_scene_body();
+		bool parse_resource_body();
+
+	private:
+		// header and tables, read once per parser
+		bool load_tables();
+		bool read_header();
+		bool read_tables();
+		void link_ext_resources(const link_context& ctx);
+
+		// seeks to an internal resource and reads its type and property count
+		bool open_resource(std::size_t index, std::wstring& type, std::uint32_t& property_count);
+		bool read_resource(std::size_t index, resource_file::resource& r);
+		void read_node_tree(const variant& bundled);
+
+		bool read_variant(variant& v, bool keep);
+		[[nodiscard]] std::wstring to_text(const variant& v) const;
+		bool read_reals(std::pmr::wstring& text, const wchar_t* type, std::size_t n);
+		bool skip(std::uint64_t bytes);
+
+		[[nodiscard]] std::uint16_t read_u16();
+		[[nodiscard]] std::uint32_t read_u32();
+		[[nodiscard]] std::uint64_t read_u64();
+		[[nodiscard]] double read_real();
+		[[nodiscard]] float read_float();
+		[[nodiscard]] double read_double();
+		// length prefixed, null terminated; the view is only good until the next read
+		[[nodiscard]] std::wstring_view read_unicode_string();
+		// index into the string table, or an inline string when the top bit is set
+		[[nodiscard]] std::wstring_view read_string_ref();
+		[[nodiscard]] std::wstring_view read_bytes_as_string(std::uint32_t n);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_BINARY_PARSER_H
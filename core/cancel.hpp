@@ -0,0 +1,62 @@
+#ifndef DOCS_GEN_CANCEL_H
+#define DOCS_GEN_CANCEL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace docs_gen_core {
+
+	// a deadline the parsers poll from inside their loops, for --budget
+	//
+	// cancelled() is one relaxed load and cheap enough for every section; expired() also reads the
+	// clock and latches the flag once the deadline passed, callers do that every few dozen polls.
+	// a token without a deadline only ends through cancel()
+	class cancel_token {
+		using clock = std::chrono::steady_clock;
+
+		clock::time_point deadline_ = clock::time_point::max();
+		mutable std::atomic<bool> cancelled_{ false };
+
+	public:
+		cancel_token() = default;
+		explicit cancel_token(clock::duration budget) : deadline_(clock::now() + budget) {}
+		cancel_token(const cancel_token&) = delete;
+		cancel_token& operator=(const cancel_token&) = delete;
+
+		void cancel() const { cancelled_.store(true, std::memory_order_relaxed); }
+
+		[[nodiscard]] bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+		[[nodiscard]] bool expired() const {
+			if (cancelled()) return true;
+			if (clock::now() < deadline_) return false;
+			cancel();
+			return true;
+		}
+
+		[[nodiscard]] clock::time_point get_deadline() const { return deadline_; }
+	};
+
+	// what a parser loop calls once per section, node or line; true once it should stop
+	class cancel_poll {
+		// polls between clock reads
+		static constexpr std::uint32_t clock_interval = 64;
+
+		const cancel_token* token_ = nullptr;
+		std::uint32_t polls_ = 0;
+
+	public:
+		cancel_poll() = default;
+		explicit cancel_poll(const cancel_token* token) : token_(token) {}
+
+		bool operator()() {
+			if (!token_) return false;
+			return ++polls_ % clock_interval == 0 ? token_->expired() : token_->cancelled();
+		}
+
+		[[nodiscard]] bool cancelled() const { return token_ && token_->cancelled(); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_CANCEL_H
@@ -0,0 +1,160 @@
+#include "class_registry.hpp"
+
+#include "log.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		// drops a trailing comment and the surrounding whitespace
+		std::wstring_view trim_declaration(std::wstring_view s) {
+			if (const auto hash = s.find('#'); hash != std::wstring_view::npos) {
+				s = s.substr(0, hash);
+			}
+			const auto first = s.find_first_not_of(L" \t\r\n");
+			if (first == std::wstring_view::npos)
+				return {};
+			const auto last = s.find_last_not_of(L" \t\r\n");
+			return s.substr(first, last - first + 1);
+		}
+
+		enum class visit : std::uint8_t {
+			unvisited,
+			visiting,
+			done
+		};
+
+	} // namespace
+
+	void class_registry::reset(std::size_t file_count) {
+		entries_.assign(file_count, {});
+		by_name_.clear();
+	}
+
+	void class_registry::clear() {
+		entries_.clear();
+		by_name_.clear();
+	}
+
+	void class_registry::set_declaration(std::size_t id, std::wstring_view class_name, std::wstring_view extends) {
+		if (id >= entries_.size()) return;
+		auto& e = entries_[id];
+		e.name = trim_declaration(class_name);
+		e.extends = trim_declaration(extends);
+		e.declared = true;
+	}
+
+	void class_registry::resolve(const path_resolver& paths, const std::vector<std::shared_ptr<file>>& files) {
+		by_name_.clear();
+		by_name_.reserve(entries_.size());
+		// registered in id order so a duplicated class_name resolves the same way every run
+		for (std::size_t id = 0; id < entries_.size(); ++id) {
+			const auto& e = entries_[id];
+			if (!e.declared || e.name.empty()) continue;
+			if (!by_name_.emplace(e.name, id).second) {
+				DOCS_GEN_LOG_WARNING(link, "class_name ", e.name, " declared again by ", files[id]->get_path());
+			}
+		}
+
+		for (std::size_t id = 0; id < entries_.size(); ++id) {
+			auto& e = entries_[id];
+			e.parent = file::npos;
+			if (!e.declared || e.extends.empty()) continue;
+
+			if (e.extends.front() == '"' || e.extends.front() == '\'') {
+				const auto path = std::wstring_view(e.extends).substr(1, e.extends.size() - 2);
+				const auto target = paths.resolve(path);
+				if (target < files.size() && files[target]->get_kind() == file_kind::script)
+					e.parent = target;
+			}
+			else if (const auto it = by_name_.find(e.extends); it != by_name_.end()) {
+				e.parent = it->second;
+			}
+			if (e.parent == id) {
+				e.parent = file::npos;
+			}
+		}
+
+		// each script is pushed once; a walk ends at a root, at a script an earlier walk resolved,
+		// or at one on its own path, which closes a cycle
+		std::vector<visit> state(entries_.size(), visit::unvisited);
+		std::vector<std::size_t> path;
+		for (std::size_t start = 0; start < entries_.size(); ++start) {
+			if (!entries_[start].declared || state[start] != visit::unvisited) continue;
+
+			auto cur = start;
+			while (cur != file::npos && state[cur] == visit::unvisited) {
+				state[cur] = visit::visiting;
+				path.push_back(cur);
+				cur = entries_[cur].parent;
+			}
+
+			if (cur != file::npos && state[cur] == visit::visiting) {
+				// every member of the cycle sees the others above it, and nothing beyond
+				std::size_t first = path.size();
+				while (path[--first] != cur) {}
+				const auto cycle_size = static_cast<std::uint32_t>(path.size() - first);
+				for (auto i = first; i < path.size(); ++i) {
+					auto& e = entries_[path[i]];
+					e.depth = cycle_size - 1;
+					e.root = file::npos;
+					state[path[i]] = visit::done;
+				}
+				path.resize(first);
+			}
+
+			while (!path.empty()) {
+				const auto id = path.back();
+				path.pop_back();
+				auto& e = entries_[id];
+				if (e.parent == file::npos) {
+					e.depth = 0;
+					e.root = id;
+				}
+				else {
+					const auto& p = entries_[e.parent];
+					e.depth = p.depth + 1;
+					e.root = p.root;
+				}
+				state[id] = visit::done;
+			}
+		}
+	}
+
+	std::size_t class_registry::find(std::wstring_view class_name) const {
+		// heterogeneous lookup needs C++20, the probe string stays short
+		const auto it = by_name_.find(std::wstring(class_name));
+		return it == by_name_.end() ? file::npos : it->second;
+	}
+
+	std::wstring_view class_registry::get_name(std::size_t id) const {
+		return id < entries_.size() ? std::wstring_view(entries_[id].name) : std::wstring_view{};
+	}
+
+	std::size_t class_registry::get_parent(std::size_t id) const {
+		return id < entries_.size() ? entries_[id].parent : file::npos;
+	}
+
+	std::vector<std::size_t> class_registry::get_chain(std::size_t id) const {
+		std::vector<std::size_t> res;
+		if (id >= entries_.size()) return res;
+
+		// depth counts the distinct scripts above id, which also bounds the walk around a cycle
+		res.reserve(entries_[id].depth);
+		for (auto cur = entries_[id].parent; cur != file::npos && res.size() < entries_[id].depth; cur = entries_[cur].parent) {
+			res.push_back(cur);
+		}
+		return res;
+	}
+
+	std::wstring_view class_registry::get_native_base(std::size_t id) const {
+		if (id >= entries_.size() || entries_[id].root == file::npos) return {};
+		const auto& root = entries_[entries_[id].root];
+		return root.extends;
+	}
+
+	bool class_registry::is_in_cycle(std::size_t id) const {
+		return id < entries_.size() && entries_[id].declared && entries_[id].root == file::npos;
+	}
+
+} // docs_gen_core
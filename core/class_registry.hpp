@@ -0,0 +1,66 @@
+#ifndef DOCS_GEN_CLASS_REGISTRY_H
+#define DOCS_GEN_CLASS_REGISTRY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "file.hpp"
+#include "path_resolver.hpp"
+
+namespace docs_gen_core {
+
+	// class_name -> script lookup and the inheritance chain of every script
+	//
+	// the declarations are copied out of the scripts while they are parsed, so the registry stays
+	// valid after a streaming run released the script classes. resolve() links every script to its
+	// parent script and memoizes depth and root in one pass over the scripts: each one is walked
+	// once, later walks stop at the first script that is already resolved
+	class class_registry {
+		struct entry {
+			std::wstring name;
+			// trimmed extends text: a class name, a quoted res:// path, or a builtin type
+			std::wstring extends;
+			std::size_t parent = file::npos;
+			// topmost script of the chain, npos when the chain loops
+			std::size_t root = file::npos;
+			// number of scripts above this one
+			std::uint32_t depth = 0;
+			bool declared = false;
+		};
+
+		std::vector<entry> entries_;
+		std::unordered_map<std::wstring, std::size_t> by_name_;
+
+	public:
+		class_registry() = default;
+
+		// sizes the table for file ids [0, file_count), declarations of distinct ids may then be set
+		// from several threads
+		void reset(std::size_t file_count);
+		void clear();
+		void set_declaration(std::size_t id, std::wstring_view class_name, std::wstring_view extends);
+		void resolve(const path_resolver& paths, const std::vector<std::shared_ptr<file>>& files);
+
+		// script id declaring class_name, file::npos if there is none
+		[[nodiscard]] std::size_t find(std::wstring_view class_name) const;
+		// the class_name id declares, empty for unnamed scripts
+		[[nodiscard]] std::wstring_view get_name(std::size_t id) const;
+		// script id id extends, file::npos for builtins and unknown parents
+		[[nodiscard]] std::size_t get_parent(std::size_t id) const;
+		// the scripts above id, nearest first
+		[[nodiscard]] std::vector<std::size_t> get_chain(std::size_t id) const;
+		// the builtin type at the top of the chain ("Node2D"), empty when the chain loops
+		[[nodiscard]] std::wstring_view get_native_base(std::size_t id) const;
+		// id is part of an inheritance cycle or extends one
+		[[nodiscard]] bool is_in_cycle(std::size_t id) const;
+
+		[[nodiscard]] std::size_t size() const { return by_name_.size(); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_CLASS_REGISTRY_H
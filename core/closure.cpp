@@ -0,0 +1,188 @@
+#include "closure.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace docs_gen_core {
+
+	void dependency_closure::build(const std::vector<std::shared_ptr<file>>& files) {
+		clear();
+		const auto n = files.size();
+		constexpr auto unvisited = std::numeric_limits<std::uint32_t>::max();
+
+		// forward edges in compressed form
+		std::vector<std::uint32_t> edge_offsets(n + 1, 0);
+		std::vector<std::uint32_t> edges;
+		std::vector<std::size_t> refs;
+		kinds_.assign(n, file_kind::other);
+		for (std::size_t i = 0; i < n; ++i) {
+			edge_offsets[i] = static_cast<std::uint32_t>(edges.size());
+			if (!files[i]) continue;
+
+			kinds_[i] = files[i]->get_kind();
+
+			refs.clear();
+			collect_direct_references(*files[i], refs);
+			for (auto to : refs) {
+				if (to < n) edges.push_back(static_cast<std::uint32_t>(to));
+			}
+		}
+		edge_offsets[n] = static_cast<std::uint32_t>(edges.size());
+
+		// Tarjan with an explicit call stack, instancing chains can be deeper than the native one
+		std::vector<std::uint32_t> index(n, unvisited);
+		std::vector<std::uint32_t> low(n, 0);
+		std::vector<bool> on_stack(n, false);
+		std::vector<std::uint32_t> scc_stack;
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> call_stack;
+		std::uint32_t next_index = 0;
+
+		component_of_.assign(n, unvisited);
+		member_offsets_.push_back(0);
+		members_.reserve(n);
+
+		for (std::uint32_t root = 0; root < n; ++root) {
+			if (index[root] != unvisited) continue;
+
+			call_stack.emplace_back(root, edge_offsets[root]);
+			index[root] = low[root] = next_index++;
+			scc_stack.push_back(root);
+			on_stack[root] = true;
+
+			while (!call_stack.empty()) {
+				auto& [v, e] = call_stack.back();
+				if (e < edge_offsets[v + 1]) {
+					const auto w = edges[e++];
+					if (index[w] == unvisited) {
+						index[w] = low[w] = next_index++;
+						scc_stack.push_back(w);
+						on_stack[w] = true;
+						call_stack.emplace_back(w, edge_offsets[w]);
+					}
+					else if (on_stack[w]) {
+						low[v] = std::min(low[v], index[w]);
+					}
+					continue;
+				}
+
+				const auto finished = v;
+				call_stack.pop_back();
+				if (!call_stack.empty()) {
+					auto& parent = call_stack.back().first;
+					low[parent] = std::min(low[parent], low[finished]);
+				}
+
+				if (low[finished] != index[finished]) continue;
+
+				const auto c = static_cast<std::uint32_t>(summaries_.size());
+				std::uint32_t w;
+				do {
+					w = scc_stack.back();
+					scc_stack.pop_back();
+					on_stack[w] = false;
+					component_of_[w] = c;
+					members_.push_back(w);
+				} while (w != finished);
+				std::sort(members_.begin() + member_offsets_.back(), members_.end());
+				member_offsets_.push_back(static_cast<std::uint32_t>(members_.size()));
+				summaries_.emplace_back();
+				cyclic_.push_back(false);
+			}
+		}
+
+		// components come out of Tarjan in reverse topological order, so successor closures
+		// are always complete by the time a component is processed
+		const auto component_count = summaries_.size();
+		std::vector<std::uint32_t> seen(n, unvisited);
+		std::vector<std::uint32_t> merged(component_count, unvisited);
+		closure_offsets_.reserve(component_count + 1);
+		closure_offsets_.push_back(0);
+
+		for (std::uint32_t c = 0; c < component_count; ++c) {
+			const auto first = closures_.size();
+			const auto push = [&](std::uint32_t id) {
+				if (seen[id] == c) return;
+				seen[id] = c;
+				closures_.push_back(id);
+			};
+
+			const auto member_count = member_offsets_[c + 1] - member_offsets_[c];
+			bool cyclic = member_count > 1;
+			merged[c] = c;
+			for (auto m = member_offsets_[c]; m < member_offsets_[c + 1]; ++m) {
+				const auto v = members_[m];
+				push(v);
+
+				for (auto e = edge_offsets[v]; e < edge_offsets[v + 1]; ++e) {
+					const auto w = edges[e];
+					if (w == v) cyclic = true;
+
+					const auto d = component_of_[w];
+					if (merged[d] == c) continue;
+					merged[d] = c;
+					for (auto x = closure_offsets_[d]; x < closure_offsets_[d + 1]; ++x) {
+						push(closures_[x]);
+					}
+				}
+			}
+
+			std::sort(closures_.begin() + first, closures_.end());
+			closure_offsets_.push_back(static_cast<std::uint32_t>(closures_.size()));
+
+			auto& s = summaries_[c];
+			for (auto x = first; x < closures_.size(); ++x) {
+				switch (kinds_[closures_[x]]) {
+				case file_kind::scene: ++s.scenes; break;
+				case file_kind::script: ++s.scripts; break;
+				case file_kind::resource: ++s.resources; break;
+				default: break;
+				}
+			}
+			cyclic_[c] = cyclic;
+		}
+	}
+
+	void dependency_closure::clear() {
+		kinds_.clear();
+		component_of_.clear();
+		member_offsets_.clear();
+		members_.clear();
+		closure_offsets_.clear();
+		closures_.clear();
+		summaries_.clear();
+		cyclic_.clear();
+	}
+
+	id_range dependency_closure::get_closure(std::size_t id) const {
+		if (id >= component_of_.size()) return {};
+		const auto c = component_of_[id];
+		return { closures_.data() + closure_offsets_[c], closures_.data() + closure_offsets_[c + 1] };
+	}
+
+	dependency_closure::summary dependency_closure::get_summary(std::size_t id) const {
+		if (id >= component_of_.size()) return {};
+		auto s = summaries_[component_of_[id]];
+		switch (kinds_[id]) {
+		case file_kind::scene: --s.scenes; break;
+		case file_kind::script: --s.scripts; break;
+		case file_kind::resource: --s.resources; break;
+		default: break;
+		}
+		return s;
+	}
+
+	id_range dependency_closure::get_cycle(std::size_t id) const {
+		if (!is_in_cycle(id)) return {};
+		const auto c = component_of_[id];
+		return { members_.data() + member_offsets_[c], members_.data() + member_offsets_[c + 1] };
+	}
+
+	bool dependency_closure::is_in_cycle(std::size_t id) const {
+		return id < component_of_.size() && cyclic_[component_of_[id]];
+	}
+
+	bool dependency_closure::in_same_cycle(std::size_t a, std::size_t b) const {
+		return is_in_cycle(a) && b < component_of_.size() && component_of_[a] == component_of_[b];
+	}
+
+} // docs_gen_core
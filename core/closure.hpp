@@ -0,0 +1,63 @@
+#ifndef DOCS_GEN_CLOSURE_H
+#define DOCS_GEN_CLOSURE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "file.hpp"
+#include "ref_index.hpp"
+
+namespace docs_gen_core {
+
+	// transitive dependencies of every file in the scene/resource graph
+	//
+	// strongly connected components are found once (iterative Tarjan) and the closure is
+	// computed per component in the order Tarjan emits them, which is a reverse topological
+	// order of the condensation, so every successor closure is already memoized when needed
+	class dependency_closure {
+	public:
+		struct summary {
+			std::size_t scenes = 0;
+			std::size_t scripts = 0;
+			std::size_t resources = 0;
+		};
+
+	private:
+		std::vector<file_kind> kinds_;
+		std::vector<std::uint32_t> component_of_;
+
+		// members of component c: members_[member_offsets_[c] .. member_offsets_[c + 1])
+		std::vector<std::uint32_t> member_offsets_;
+		std::vector<std::uint32_t> members_;
+
+		// closure of component c, sorted, including the members of c
+		std::vector<std::uint32_t> closure_offsets_;
+		std::vector<std::uint32_t> closures_;
+
+		std::vector<summary> summaries_;
+		std::vector<bool> cyclic_;
+
+	public:
+		dependency_closure() = default;
+
+		// files must be indexed by their id (files[i]->get_id() == i), null entries are skipped
+		void build(const std::vector<std::shared_ptr<file>>& files);
+		void clear();
+
+		// every file reachable from id, id itself included
+		[[nodiscard]] id_range get_closure(std::size_t id) const;
+		// what id pulls in, not counting itself
+		[[nodiscard]] summary get_summary(std::size_t id) const;
+		// files that form a reference cycle with id (id included), empty if there is none
+		[[nodiscard]] id_range get_cycle(std::size_t id) const;
+		[[nodiscard]] bool is_in_cycle(std::size_t id) const;
+		// a and b reach each other
+		[[nodiscard]] bool in_same_cycle(std::size_t a, std::size_t b) const;
+
+		[[nodiscard]] std::size_t component_count() const { return summaries_.size(); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_CLOSURE_H
@@ -0,0 +1,177 @@
+#include "deflate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::size_t window_size = 32 * 1024;
+		constexpr std::size_t min_match = 3;
+		constexpr std::size_t max_match = 258;
+		constexpr std::size_t max_chain = 32;
+		constexpr std::size_t hash_bits = 14;
+
+		constexpr std::array<std::uint16_t, 29> length_base = {
+			3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+		};
+		constexpr std::array<std::uint8_t, 29> length_extra = {
+			0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+		};
+		constexpr std::array<std::uint16_t, 30> distance_base = {
+			1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+			4097, 6145, 8193, 12289, 16385, 24577,
+		};
+		constexpr std::array<std::uint8_t, 30> distance_extra = {
+			0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+		};
+
+		class bit_writer {
+			std::string& out_;
+			std::uint64_t bits_ = 0;
+			unsigned count_ = 0;
+
+		public:
+			explicit bit_writer(std::string& out) : out_(out) {}
+
+			// value goes out least significant bit first
+			void put(std::uint32_t value, unsigned n) {
+				bits_ |= static_cast<std::uint64_t>(value) << count_;
+				count_ += n;
+				while (count_ >= 8) {
+					out_.push_back(static_cast<char>(bits_ & 0xFF));
+					bits_ >>= 8;
+					count_ -= 8;
+				}
+			}
+
+			// Huffman codes are defined most significant bit first
+			void put_code(std::uint32_t code, unsigned n) {
+				std::uint32_t reversed = 0;
+				for (unsigned i = 0; i < n; ++i) {
+					reversed = reversed << 1 | (code >> i & 1);
+				}
+				put(reversed, n);
+			}
+
+			void flush() {
+				if (count_ > 0) {
+					out_.push_back(static_cast<char>(bits_ & 0xFF));
+				}
+				bits_ = 0;
+				count_ = 0;
+			}
+		};
+
+		void put_literal(bit_writer& w, unsigned symbol) {
+			if (symbol < 144) w.put_code(0x30 + symbol, 8);
+			else if (symbol < 256) w.put_code(0x190 + symbol - 144, 9);
+			else if (symbol < 280) w.put_code(symbol - 256, 7);
+			else w.put_code(0xC0 + symbol - 280, 8);
+		}
+
+		void put_match(bit_writer& w, std::size_t length, std::size_t distance) {
+			std::size_t l = length_base.size() - 1;
+			while (length_base[l] > length) --l;
+			put_literal(w, static_cast<unsigned>(257 + l));
+			w.put(static_cast<std::uint32_t>(length - length_base[l]), length_extra[l]);
+
+			std::size_t d = distance_base.size() - 1;
+			while (distance_base[d] > distance) --d;
+			w.put_code(static_cast<std::uint32_t>(d), 5);
+			w.put(static_cast<std::uint32_t>(distance - distance_base[d]), distance_extra[d]);
+		}
+
+		std::uint32_t hash3(const unsigned char* p) {
+			const auto v = static_cast<std::uint32_t>(p[0]) << 16 | static_cast<std::uint32_t>(p[1]) << 8 | p[2];
+			return (v * 2654435761u) >> (32 - hash_bits);
+		}
+
+		const std::array<std::uint32_t, 256>& crc_table() {
+			static const auto table = [] {
+				std::array<std::uint32_t, 256> t{};
+				for (std::uint32_t i = 0; i < 256; ++i) {
+					auto c = i;
+					for (int k = 0; k < 8; ++k) {
+						c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					}
+					t[i] = c;
+				}
+				return t;
+			}();
+			return table;
+		}
+
+	} // namespace
+
+	std::string deflate(std::string_view data) {
+		std::string out;
+		out.reserve(data.size() / 2 + 16);
+		bit_writer w{ out };
+		// one final block with the fixed codes
+		w.put(1, 1);
+		w.put(1, 2);
+
+		const auto* s = reinterpret_cast<const unsigned char*>(data.data());
+		const auto n = data.size();
+		constexpr std::int32_t none = -1;
+		std::vector<std::int32_t> head(std::size_t{ 1 } << hash_bits, none);
+		std::vector<std::int32_t> prev(n, none);
+		const auto insert = [&](std::size_t pos) {
+			if (pos + min_match > n) return;
+			auto& h = head[hash3(s + pos)];
+			prev[pos] = h;
+			h = static_cast<std::int32_t>(pos);
+		};
+
+		for (std::size_t i = 0; i < n; ) {
+			std::size_t best_length = 0;
+			std::size_t best_distance = 0;
+			if (i + min_match <= n) {
+				const auto limit = std::min(max_match, n - i);
+				auto candidate = head[hash3(s + i)];
+				for (std::size_t chain = 0; candidate != none && chain < max_chain; ++chain) {
+					const auto c = static_cast<std::size_t>(candidate);
+					if (i - c > window_size) break;
+					std::size_t l = 0;
+					while (l < limit && s[c + l] == s[i + l]) ++l;
+					if (l > best_length) {
+						best_length = l;
+						best_distance = i - c;
+						if (l == limit) break;
+					}
+					candidate = prev[c];
+				}
+			}
+
+			if (best_length >= min_match) {
+				put_match(w, best_length, best_distance);
+				for (std::size_t k = 0; k < best_length; ++k) {
+					insert(i + k);
+				}
+				i += best_length;
+			}
+			else {
+				put_literal(w, s[i]);
+				insert(i);
+				++i;
+			}
+		}
+
+		put_literal(w, 256);
+		w.flush();
+		return out;
+	}
+
+	std::uint32_t crc32(std::string_view data, std::uint32_t crc) {
+		const auto& table = crc_table();
+		crc = ~crc;
+		for (const auto c : data) {
+			crc = table[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+} // docs_gen_core
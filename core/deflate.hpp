@@ -0,0 +1,21 @@
+#ifndef DOCS_GEN_DEFLATE_H
+#define DOCS_GEN_DEFLATE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace docs_gen_core {
+
+	// raw deflate (RFC 1951) of data, what a zip entry with method 8 holds
+	//
+	// greedy LZ77 over hash chains and the fixed Huffman codes, one block; pages are a few KB of
+	// repetitive markdown, where a dynamic code table would mostly cost its own header
+	[[nodiscard]] std::string deflate(std::string_view data);
+
+	// CRC-32 as zip and gzip use it (reflected, polynomial 0xEDB88320)
+	[[nodiscard]] std::uint32_t crc32(std::string_view data, std::uint32_t crc = 0);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_DEFLATE_H
@@ -1,10 +1,155 @@
 #include "dir.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cwctype>
+#include <fstream>
+#include <locale>
+#include <sstream>
 
+#include "binary_parser.hpp"
+#include "entry_points.hpp"
+#include "log.hpp"
 #include "parser.hpp"
+#include "prefetch.hpp"
+#include "property_value.hpp"
+#include "trace.hpp"
 
 namespace docs_gen_core {
+
+	namespace {
+
+		template <typename Span>
+		void describe_file_span(Span& span, const file& f) {
+			if (!span.active()) return;
+			span.set_detail(f.get_path());
+			std::error_code ec;
+			const auto size = std::filesystem::file_size(f.get_path(), ec);
+			span.arg("bytes", ec ? 0 : static_cast<std::uint64_t>(size));
+		}
+
+		// files one parse with stats when --stats asked for them
+		template <typename Parser>
+		void record_parse(parse_stats* stats, const file& f, const Parser& p, std::uint64_t start_ns) {
+			if (stats) stats->record(f, p.get_section_count(), p.get_node_count(), p.get_field_count(), start_ns);
+		}
+
+		void record_script(parse_stats* stats, const script_file& f, std::uint64_t start_ns) {
+			if (!stats) return;
+			const auto& sc = f.get_script_class();
+			std::uint64_t fields = sc.functions.size();
+			for (const auto& cat : sc.categories) {
+				fields += cat.variables.size();
+			}
+			stats->record(f, 0, 0, fields, start_ns);
+		}
+
+		// the header and links passes only look at the top of each file
+		constexpr std::uint64_t head_prefetch_bytes = 64 * 1024;
+
+		// what a page buffer starts with, most pages fit
+		constexpr std::size_t page_capacity = 4 * 1024;
+
+		template <typename Queue>
+		void append_paths(std::vector<std::filesystem::path>& out, const Queue& queue) {
+			for (const auto& f : queue) {
+				out.push_back(f->get_path());
+			}
+		}
+
+		// the files of a pass in the order its indices hand them out
+		template <typename... Queues>
+		std::vector<std::filesystem::path> paths_of(const Queues&... queues) {
+			std::vector<std::filesystem::path> res;
+			res.reserve((queues.size() + ...));
+			(append_paths(res, queues), ...);
+			return res;
+		}
+
+		// obsidian colors scenes, scripts and resources apart by their tags
+		// TODO develop a proper way of item coloring in obsidian
+		constexpr std::string_view obsidian_graph =
+			R"({"colorGroups":[{"query":"tag:#scene","color":{"a":1,"rgb":14048348}},{"query":"tag:#script","color":{"a":1,"rgb":6577366}},{"query":"tag:#resource","color":{"a":1,"rgb":4521728}}]})";
+
+		// the bytes a wofstream with the global locale would write for page
+		std::string narrow_page(const std::wstring& page) {
+			const auto& cvt = std::use_facet<std::codecvt<wchar_t, char, std::mbstate_t>>(std::locale());
+			std::string res(page.size() * static_cast<std::size_t>(cvt.max_length()), '\0');
+			std::mbstate_t state{};
+			const wchar_t* from_next = nullptr;
+			char* to_next = nullptr;
+			// like the stream, stops at the first character the locale can not encode
+			cvt.out(state, page.data(), page.data() + page.size(), from_next, res.data(), res.data() + res.size(), to_next);
+			res.resize(static_cast<std::size_t>(to_next - res.data()));
+			return res;
+		}
+
+		// where the shards leave their partial indexes, below the docs folder
+		constexpr const char* shard_dir_name = ".shards";
+		// what a budgeted run did not get to, below the docs folder
+		constexpr const char* skipped_manifest_name = ".skipped.txt";
+
+		// fnv-1a over the project relative path and kind of every indexed file, in id order;
+		// shards and the merge only fit together when they indexed the same tree
+		std::uint64_t tree_fingerprint(const std::filesystem::path& root, const std::vector<std::shared_ptr<file>>& files) {
+			std::uint64_t h = 14695981039346656037ull;
+			const auto mix = [&h](unsigned char b) {
+				h ^= b;
+				h *= 1099511628211ull;
+			};
+			for (const auto& f : files) {
+				for (const auto c : path_resolver::normalize(root, f->get_path())) {
+					mix(static_cast<unsigned char>(c));
+				}
+				mix(0);
+				mix(static_cast<unsigned char>(f->get_kind()));
+			}
+			return h;
+		}
+
+		// the text parser of the calling thread, reopened for every file so its buffers are reused
+		struct thread_text_parser {
+			dott_parser parser;
+			bool busy = false;
+		};
+
+		thread_text_parser& local_text_parser() {
+			thread_local thread_text_parser p;
+			return p;
+		}
+
+		// .scn/.res go through the binary reader, .tscn/.tres through the text one; a text scene
+		// body big enough to split is tokenized on pool
+		template <typename Fn>
+		bool with_parser(const std::shared_ptr<dott_file>& f, const parse_options& options, Fn&& fn, thread_pool* pool = nullptr) {
+			if (is_binary_resource(f->get_path())) {
+				binary_parser p{ f, options };
+				return fn(p);
+			}
+
+			auto& local = local_text_parser();
+			if (local.busy) {
+				// a page being written parses another scene while the thread's parser is out
+				dott_parser p{ f, options };
+				p.set_thread_pool(pool);
+				return fn(p);
+			}
+
+			struct release {
+				thread_text_parser& local;
+				~release() {
+					local.parser.close();
+					local.busy = false;
+				}
+			} guard{ local };
+			local.busy = true;
+			local.parser.open(f, options);
+			local.parser.set_thread_pool(pool);
+			return fn(local.parser);
+		}
+
+	} // namespace
+
 	bool dir::set_path(const std::wstring& path) {
 		const auto temp = std::filesystem::path(path);
 
@@ -17,10 +162,38 @@ namespace docs_gen_core {
 	}
 
 	void dir::construct_file_tree() {
-		std::vector<std::shared_ptr<scene_file>> scene_files;
-		std::vector<std::shared_ptr<resource_file>> resource_files;
+		// the budget covers the prescan as well
+		deadline_ = budgeted() ? std::make_unique<cancel_token>(budget_) : nullptr;
+		index_files();
+		// without a pool the files are still parsed one at a time, but a scene that splits gets
+		// workers for its chunks, as write_archive does for compressing
+		if (!pool_ && !split_pool_ && has_split_scene())
+			split_pool_ = std::make_unique<thread_pool>();
+		if (budgeted()) {
+			// the scene and resource files are read by gen_docs, as many as the deadline allows
+			if (!parse_script_declarations())
+				return;
+		}
+		else if (!(shard_count_ > 1 ? parse_shard() : reachable_only_ ? parse_reachable() : streaming_ ? parse_links() : parse_files()))
+			return;
+		resolve_references();
+	}
+
+	void dir::index_files() {
+		scene_queue_.clear();
+		resource_queue_.clear();
+		file_tree_.clear();
+		script_files_.clear();
+		resource_files_.clear();
+		files_.clear();
+		paths_.clear();
+		ref_index_.clear();
+		closure_.clear();
+		classes_.clear();
 
-		std::cout << "[INFO] Indexing all files in directory\n";
+		DOCS_GEN_TRACE_SCOPE(span, "index_files", "index");
+		DOCS_GEN_LOG_INFO(index, "Indexing all files in directory");
+		std::vector<std::pair<std::string, std::filesystem::path>> found;
 		for (auto dir_entry = std::filesystem::recursive_directory_iterator(path_); dir_entry != std::filesystem::recursive_directory_iterator(); ++dir_entry) {
 			if (util::is_dir(*dir_entry) && util::is_dir_blacklisted(dir_entry->path().filename().wstring(), ignored_folders_)) {
 				dir_entry.disable_recursion_pending();
@@ -28,303 +201,890 @@ namespace docs_gen_core {
 			}
 
 			if (util::is_file(*dir_entry)) {
-				if (dir_entry->path().extension() == ".gd"/* || dir_entry->path().extension() == ".cs"*/) {
-					auto f = script_file(dir_entry->path());
-					script_files_[dir_entry->path().relative_path().wstring()] = std::make_shared<script_file>(f);
+				const auto ext = dir_entry->path().extension();
+				if (ext == ".gd"/* || ext == ".cs"*/ || ext == ".tscn" || ext == ".scn" || ext == ".tres" || ext == ".res") {
+					found.emplace_back(path_resolver::normalize(path_, dir_entry->path()), dir_entry->path());
 				}
+			}
+		}
+
+		// ids follow the project relative paths instead of the directory listing, so every machine
+		// numbers the same tree the same way and the shards of a run agree on them
+		std::sort(found.begin(), found.end());
+		for (const auto& [_, p] : found) {
+			const auto ext = p.extension();
+			if (ext == ".gd") {
+				auto sf = std::make_shared<script_file>(p);
+				push_file(sf);
+				script_files_.push_back(sf);
+			}
+			else if (ext == ".tscn" || ext == ".scn") {
+				scene_queue_.push_back(std::make_shared<scene_file>(p));
+				push_file(scene_queue_.back());
+			}
+			else {
+				resource_queue_.push_back(std::make_shared<resource_file>(p));
+				push_file(resource_queue_.back());
+			}
+		}
+		paths_.build(path_, files_);
+		classes_.reset(files_.size());
+		DOCS_GEN_LOG_INFO(index, "Finished indexing all files in directory");
+		span.arg("files", files_.size());
+	}
+
+	bool dir::has_split_scene() const {
+		if (options_.split_bytes == 0)
+			return false;
+		return std::any_of(scene_queue_.begin(), scene_queue_.end(), [&](const auto& scene) {
+			std::error_code ec;
+			const auto size = std::filesystem::file_size(scene->get_path(), ec);
+			return !ec && !is_binary_resource(scene->get_path()) && size >= 2 * options_.split_bytes;
+		});
+	}
+
+	bool dir::parse_files() {
+		DOCS_GEN_TRACE_SCOPE(span, "parse_files", "parse");
+		// headers of both kinds go first so that every uid is known before any file gets linked
+		return parse_headers() && parse_contents(true);
+	}
+
+	bool dir::parse_contents(bool links) {
+		const link_context ctx{ file_tree_, resource_files_, paths_, files_ };
+		// files only write into themselves and read the tables above, so they parse independently
+		std::atomic<bool> failed{ false };
+
+		DOCS_GEN_LOG_INFO(parse, "Parsing scene files");
+		{
+			DOCS_GEN_TRACE_SCOPE(pass, "parse_scene_contents", "parse");
+			prefetcher ahead{ paths_of(scene_queue_), options_.prefetch_depth };
+			parallel_for(pool_, scene_queue_.size(), [&](std::size_t i) {
+				if (failed.load(std::memory_order_relaxed)) return;
+				ahead.claim(i);
+				const auto& val = scene_queue_[i];
+				DOCS_GEN_TRACE_SCOPE(span, "parse_scene", "parse");
+				describe_file_span(span, *val);
+				const auto start = stats_ ? parse_stats::now_ns() : 0;
+				const bool ok = with_parser(val, options_, [&](auto& p) {
+					const bool parsed = links ? p.parse_scene_file_contents(ctx) : p.parse_scene_body();
+					span.arg("sections", p.get_section_count());
+					record_parse(stats_, *val, p, start);
+					return parsed;
+				}, split_pool());
+				if (!ok)
+					failed = true;
+			});
+		}
+		if (failed)
+			return false;
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing scene files");
+
+		DOCS_GEN_LOG_INFO(parse, "Parsing resource files");
+		{
+			DOCS_GEN_TRACE_SCOPE(pass, "parse_resource_contents", "parse");
+			prefetcher ahead{ paths_of(resource_queue_), options_.prefetch_depth };
+			parallel_for(pool_, resource_queue_.size(), [&](std::size_t i) {
+				if (failed.load(std::memory_order_relaxed)) return;
+				ahead.claim(i);
+				const auto& val = resource_queue_[i];
+				DOCS_GEN_TRACE_SCOPE(span, "parse_resource", "parse");
+				describe_file_span(span, *val);
+				const auto start = stats_ ? parse_stats::now_ns() : 0;
+				const bool ok = with_parser(val, options_, [&](auto& p) {
+					const bool parsed = links ? p.parse_resource_file_contents(ctx) : p.parse_resource_body();
+					span.arg("sections", p.get_section_count());
+					record_parse(stats_, *val, p, start);
+					return parsed;
+				});
+				if (!ok)
+					failed = true;
+			});
+		}
+		if (failed)
+			return false;
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing resource files");
+
+		DOCS_GEN_LOG_INFO(parse, "Parsing script files");
+		{
+			DOCS_GEN_TRACE_SCOPE(pass, "parse_scripts", "parse");
+			prefetcher ahead{ paths_of(script_files_), options_.prefetch_depth };
+			parallel_for(pool_, script_files_.size(), [&](std::size_t i) {
+				ahead.claim(i);
+				const auto& val = script_files_[i];
+				DOCS_GEN_TRACE_SCOPE(span, "parse_script", "parse");
+				describe_file_span(span, *val);
+				const auto start = stats_ ? parse_stats::now_ns() : 0;
+				if (cache_) {
+					cache_->parse_script(val);
+				}
+				else {
+					script_parser p{ val };
+					p.parse();
+				}
+				record_script(stats_, *val, start);
+				const auto& sc = val->get_script_class();
+				classes_.set_declaration(val->get_id(), sc.name, sc.parent);
+				span.arg("functions", sc.functions.size());
+			});
+		}
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing script files");
+		return true;
+	}
+
+	bool dir::parse_links() {
+		DOCS_GEN_TRACE_SCOPE(span, "parse_links", "parse");
+		return parse_headers() && parse_link_pass() && parse_script_declarations();
+	}
+
+	bool dir::parse_link_pass() {
+		const link_context ctx{ file_tree_, resource_files_, paths_, files_ };
+		std::atomic<bool> failed{ false };
+
+		DOCS_GEN_LOG_INFO(parse, "Parsing scene and resource links");
+		prefetcher ahead{ paths_of(scene_queue_, resource_queue_), options_.prefetch_depth, head_prefetch_bytes };
+		parallel_for(pool_, scene_queue_.size() + resource_queue_.size(), [&](std::size_t i) {
+			if (failed.load(std::memory_order_relaxed)) return;
+			ahead.claim(i);
+			if (i < scene_queue_.size()) {
+				const auto& val = scene_queue_[i];
+				DOCS_GEN_TRACE_SCOPE(file_span, "parse_scene_links", "parse");
+				describe_file_span(file_span, *val);
+				if (!with_parser(val, options_, [&](auto& p) { return p.parse_scene_links(ctx); }))
+					failed = true;
+				return;
+			}
+
+			const auto& val = resource_queue_[i - scene_queue_.size()];
+			DOCS_GEN_TRACE_SCOPE(file_span, "parse_resource_links", "parse");
+			describe_file_span(file_span, *val);
+			if (!with_parser(val, options_, [&](auto& p) { return p.parse_resource_links(ctx); }))
+				failed = true;
+		});
+		if (failed)
+			return false;
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing scene and resource links");
+		return true;
+	}
+
+	bool dir::parse_shard() {
+		DOCS_GEN_TRACE_SCOPE(span, "parse_shard", "parse");
+		// the prescan covers the whole project: uids and paths for the links, class names for the
+		// types on script pages
+		if (!parse_headers() || !parse_script_declarations())
+			return false;
+
+		// expanded instances are cut at reference cycles, which takes every edge of the project
+		const bool whole_graph = expand_depth_ > 0;
+		if (whole_graph && !parse_link_pass())
+			return false;
+
+		const auto other = [this](const auto& f) { return !in_slice(f->get_id()); };
+		scene_queue_.erase(std::remove_if(scene_queue_.begin(), scene_queue_.end(), other), scene_queue_.end());
+		resource_queue_.erase(std::remove_if(resource_queue_.begin(), resource_queue_.end(), other), resource_queue_.end());
+		script_files_.erase(std::remove_if(script_files_.begin(), script_files_.end(), other), script_files_.end());
+		DOCS_GEN_LOG_INFO(parse, "Shard ", shard_index_ + 1, "/", shard_count_, " takes ",
+			scene_queue_.size() + resource_queue_.size() + script_files_.size(), " of ", files_.size(), " files");
+
+		if (streaming_)
+			return whole_graph || parse_link_pass();
+		return parse_contents(!whole_graph);
+	}
 
-				if (dir_entry->path().extension() == ".tscn") {
-					auto f = scene_file(dir_entry->path());
-					scene_files.push_back(std::make_shared<scene_file>(f));
+	bool dir::parse_reachable() {
+		DOCS_GEN_TRACE_SCOPE(span, "parse_reachable", "parse");
+		// every header still goes first, a uid may point anywhere in the project
+		if (!parse_headers() || !walk_entry_points())
+			return false;
+		return streaming_ ? parse_script_declarations() : parse_contents(false);
+	}
+
+	bool dir::walk_entry_points() {
+		DOCS_GEN_TRACE_SCOPE(span, "walk_entry_points", "parse");
+		const auto roots = entry_points_.empty() ? read_entry_points(path_ / "project.godot") : entry_points_;
+		if (roots.empty()) {
+			DOCS_GEN_LOG_WARNING(parse, "no entry points, neither given nor in project.godot: ", path_);
+		}
+
+		std::vector<char> reached(files_.size(), 0);
+		std::vector<std::size_t> frontier;
+		for (const auto& root : roots) {
+			const auto id = resolve_entry_point(root);
+			if (id == file::npos) {
+				DOCS_GEN_LOG_WARNING(parse, "entry point not found: ", root);
+				continue;
+			}
+			if (!reached[id]) {
+				reached[id] = 1;
+				frontier.push_back(id);
+			}
+		}
+
+		DOCS_GEN_LOG_INFO(parse, "Parsing links reachable from ", frontier.size(), " entry points");
+		const link_context ctx{ file_tree_, resource_files_, paths_, files_ };
+		std::atomic<bool> failed{ false };
+		std::vector<std::shared_ptr<dott_file>> level;
+		std::vector<std::size_t> targets;
+		// one level of the walk at a time, the links of a level are parsed in parallel and name
+		// the next one; scripts end a path, they are not linked through ext_resources
+		while (!frontier.empty()) {
+			level.clear();
+			for (const auto id : frontier) {
+				if (auto df = std::dynamic_pointer_cast<dott_file>(files_[id])) {
+					level.push_back(std::move(df));
 				}
+			}
 
-				if (dir_entry->path().extension() == ".tres") {
-					auto f = resource_file(dir_entry->path());
-					resource_files.push_back(std::make_shared<resource_file>(f));
+			prefetcher ahead{ paths_of(level), options_.prefetch_depth, head_prefetch_bytes };
+			parallel_for(pool_, level.size(), [&](std::size_t i) {
+				if (failed.load(std::memory_order_relaxed)) return;
+				ahead.claim(i);
+				const auto& val = level[i];
+				DOCS_GEN_TRACE_SCOPE(file_span, "parse_links", "parse");
+				describe_file_span(file_span, *val);
+				const bool scene = val->get_kind() == file_kind::scene;
+				if (!with_parser(val, options_, [&](auto& p) { return scene ? p.parse_scene_links(ctx) : p.parse_resource_links(ctx); }))
+					failed = true;
+			});
+			if (failed)
+				return false;
+
+			frontier.clear();
+			for (const auto& f : level) {
+				targets.clear();
+				collect_direct_references(*f, targets);
+				for (const auto id : targets) {
+					if (!reached[id]) {
+						reached[id] = 1;
+						frontier.push_back(id);
+					}
 				}
 			}
 		}
-		std::cout << "[INFO] Finished indexing all files in directory\n";
 
-		std::cout << "[INFO] Parsing scene files\n";
-		for (auto& val : scene_files) {
-			dott_parser p{ val };
-			if (!p.parse_scene_header())
-				return;
-			file_tree_[val->get_uid()] = val;
+		// pages are written from the queues and tables, so what was not reached gets none
+		const auto unreached = [&](const auto& f) { return !reached[f->get_id()]; };
+		scene_queue_.erase(std::remove_if(scene_queue_.begin(), scene_queue_.end(), unreached), scene_queue_.end());
+		resource_queue_.erase(std::remove_if(resource_queue_.begin(), resource_queue_.end(), unreached), resource_queue_.end());
+		script_files_.erase(std::remove_if(script_files_.begin(), script_files_.end(), unreached), script_files_.end());
+
+		uid_map<std::shared_ptr<scene_file>> scenes;
+		scenes.reserve(scene_queue_.size());
+		for (const auto& [uid, f] : file_tree_) {
+			if (reached[f->get_id()]) scenes.insert_or_assign(uid, f);
 		}
+		file_tree_ = std::move(scenes);
 
-		for (auto& val : scene_files) {
-			dott_parser p{ val };
-			p.set_root_path(path_);
-			if (!p.parse_scene_file_contents(file_tree_, script_files_, resource_files_))
-				return;
+		uid_map<std::shared_ptr<resource_file>> resources;
+		resources.reserve(resource_queue_.size());
+		for (const auto& [uid, f] : resource_files_) {
+			if (reached[f->get_id()]) resources.insert_or_assign(uid, f);
 		}
-		std::cout << "[INFO] Finished parsing scene files\n";
+		resource_files_ = std::move(resources);
 
-		std::cout << "[INFO] Parsing resource files\n";
-		for (auto& val : resource_files) {
-			dott_parser p{ val };
-			if (!p.parse_resource_header())
-				return;
-			resource_files_[val->get_uid()] = val;
+		const auto count = scene_queue_.size() + resource_queue_.size() + script_files_.size();
+		DOCS_GEN_LOG_INFO(parse, "Reached ", count, " of ", files_.size(), " files");
+		span.arg("reached", count);
+		return true;
+	}
+
+	std::size_t dir::resolve_entry_point(std::wstring_view root) const {
+		constexpr std::wstring_view uid_scheme = L"uid://";
+		if (root.substr(0, uid_scheme.size()) == uid_scheme) {
+			const auto uid = decode_uid(root);
+			if (const auto* f = file_tree_.find(uid))
+				return (*f)->get_id();
+			if (const auto* f = resource_files_.find(uid))
+				return (*f)->get_id();
+			return file::npos;
+		}
+		return paths_.resolve(root);
+	}
+
+	bool dir::parse_script_declarations() {
+		DOCS_GEN_LOG_INFO(parse, "Parsing script declarations");
+		{
+			DOCS_GEN_TRACE_SCOPE(pass, "parse_script_declarations", "parse");
+			prefetcher script_ahead{ paths_of(script_files_), options_.prefetch_depth };
+			parallel_for(pool_, script_files_.size(), [&](std::size_t i) {
+				script_ahead.claim(i);
+				const auto& val = script_files_[i];
+				std::wstring name;
+				std::wstring extends;
+				script_parser p{ val };
+				if (p.parse_declaration(name, extends)) {
+					classes_.set_declaration(val->get_id(), name, extends);
+				}
+			});
 		}
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing script declarations");
+		return true;
+	}
 
-		for (auto& val : resource_files) {
-			dott_parser p{ val };
-			p.set_root_path(path_);
-			if (!p.parse_resource_file_contents(file_tree_, script_files_, resource_files_))
+	bool dir::parse_headers() {
+		DOCS_GEN_TRACE_SCOPE(pass, "parse_headers", "parse");
+		DOCS_GEN_LOG_INFO(parse, "Parsing scene and resource headers");
+		std::atomic<bool> failed{ false };
+		prefetcher ahead{ paths_of(scene_queue_, resource_queue_), options_.prefetch_depth, head_prefetch_bytes };
+		parallel_for(pool_, scene_queue_.size() + resource_queue_.size(), [&](std::size_t i) {
+			if (failed.load(std::memory_order_relaxed)) return;
+			ahead.claim(i);
+			if (i < scene_queue_.size()) {
+				const auto& val = scene_queue_[i];
+				DOCS_GEN_TRACE_SCOPE(span, "parse_scene_header", "parse");
+				describe_file_span(span, *val);
+				if (!with_parser(val, options_, [](auto& p) { return p.parse_scene_header(); }))
+					failed = true;
 				return;
+			}
+
+			const auto& val = resource_queue_[i - scene_queue_.size()];
+			DOCS_GEN_TRACE_SCOPE(span, "parse_resource_header", "parse");
+			describe_file_span(span, *val);
+			if (!with_parser(val, options_, [](auto& p) { return p.parse_resource_header(); }))
+				failed = true;
+		});
+		if (failed)
+			return false;
+
+		// registered in queue order so a duplicated uid resolves the same way every run
+		file_tree_.reserve(scene_queue_.size());
+		resource_files_.reserve(resource_queue_.size());
+		for (const auto& val : scene_queue_) {
+			file_tree_.insert_or_assign(val->get_uid(), val);
+		}
+		for (const auto& val : resource_queue_) {
+			resource_files_.insert_or_assign(val->get_uid(), val);
+		}
+		DOCS_GEN_LOG_INFO(parse, "Finished parsing scene and resource headers");
+		return true;
+	}
+
+	void dir::resolve_references() {
+		DOCS_GEN_TRACE_SCOPE(span, "resolve_references", "link");
+		// a budgeted run has not read any links yet, the class names are all it has
+		if (!budgeted()) {
+			DOCS_GEN_LOG_INFO(link, "Building reverse reference index");
+			{
+				DOCS_GEN_TRACE_SCOPE(index_span, "build_ref_index", "link");
+				ref_index_.build(files_);
+				index_span.arg("edges", ref_index_.edge_count());
+			}
+			DOCS_GEN_LOG_INFO(link, "Finished building reverse reference index");
+
+			DOCS_GEN_LOG_INFO(link, "Resolving transitive dependencies");
+			{
+				DOCS_GEN_TRACE_SCOPE(closure_span, "build_closure", "link");
+				closure_.build(files_);
+				closure_span.arg("components", closure_.component_count());
+			}
+			DOCS_GEN_LOG_INFO(link, "Finished resolving transitive dependencies");
 		}
-		std::cout << "[INFO] Finished parsing resource files\n";
 
-		std::cout << "[INFO] Parsing script files\n";
-		for (auto& [_, val] : script_files_) {
-			script_parser p{ val };
-			p.parse();
+		DOCS_GEN_LOG_INFO(link, "Resolving class inheritance");
+		{
+			DOCS_GEN_TRACE_SCOPE(classes_span, "resolve_classes", "link");
+			classes_.resolve(paths_, files_);
+			classes_span.arg("classes", classes_.size());
 		}
-		std::cout << "[INFO] Finished parsing script files\n";
+		DOCS_GEN_LOG_INFO(link, "Finished resolving class inheritance");
+	}
+
+	std::shared_ptr<file> dir::get_file(std::size_t id) const {
+		if (id >= files_.size()) return nullptr;
+		return files_[id];
+	}
+
+	std::vector<std::shared_ptr<file>> dir::get_referrers(const file& f) const {
+		std::vector<std::shared_ptr<file>> res;
+		const auto refs = ref_index_.get_referrers(f.get_id());
+		res.reserve(refs.size());
+		for (auto id : refs) {
+			res.push_back(files_[id]);
+		}
+		return res;
 	}
 
 	void dir::gen_docs() {
+		DOCS_GEN_TRACE_SCOPE(span, "gen_docs", "docs");
+		if (!archive_path_.empty()) {
+			write_archive();
+			return;
+		}
+
 		auto docs_dir = path_ / "docs";
-		if (std::filesystem::exists(docs_dir)) {
+		// a budgeted run only replaces the pages it gets to
+		if (!budgeted() && std::filesystem::exists(docs_dir)) {
 			std::filesystem::remove_all(docs_dir);
 		}
 
 		std::filesystem::create_directory(docs_dir);
+		{
+			std::lock_guard lock(expanded_mutex_);
+			expanded_.clear();
+		}
 
-		std::cout << "[INFO] Writing scene files\n";
-		for (const auto& [_, file] : file_tree_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().wstring() + L".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
+		if (budgeted()) {
+			write_budgeted(docs_dir);
+		}
+		else if (streaming_) {
+			stream_pages(docs_dir);
+		}
+		else {
+			DOCS_GEN_LOG_INFO(docs, "Writing scene files");
+			for (const auto& [_, file] : file_tree_) {
+				if (in_slice(file->get_id())) write_scene_page(docs_dir, *file);
+			}
 
-			out.write(L"#scene\n", 7);
+			DOCS_GEN_LOG_INFO(docs, "Writing resource files");
+			for (const auto& [_, file] : resource_files_) {
+				if (in_slice(file->get_id())) write_resource_page(docs_dir, *file);
+			}
 
-			out.write(L"# Node Tree\n", 12);
-			auto& nodes = file->get_node_tree();
-			for (auto it = nodes.begin(); it != nodes.end(); ++it) {
-				for (std::size_t i = 0; i < (*it)->depth - 1; ++i) {
-					out.put('\t');
-				}
-				out.write(L"- ", 2);
-				out.write((*it)->name.data(), (*it)->name.size());
-				out.put('\n');
-				
-				for (const auto& [f, s] : (*it)->ext_resource_fields) {
-					if (!s.expired()) {
-						for (std::size_t i = 0; i < (*it)->depth; ++i) {
-							out.put('\t');
-						}
-						out.write(L"  *", 3);
-						out.write(f.c_str(), f.size());
-						out.write(L"*: ", 3);
-						write_named_file_link(out, docs_dir, s.lock()->get_path());
-						out.put('\n');
-					}
-				}
+			DOCS_GEN_LOG_INFO(docs, "Writing script files");
+			for (const auto& file : script_files_) {
+				write_script_page(docs_dir, *file);
 			}
+		}
+
+		if (shard_count_ > 1) {
+			write_shard_index(docs_dir);
+		}
+
+		auto obsidian_dir = docs_dir / ".obsidian";
+		std::filesystem::create_directory(obsidian_dir);
+		
+		std::ofstream out{ obsidian_dir / "graph.json", std::ios::out | std::ios::binary };
+		out.write(obsidian_graph.data(), obsidian_graph.size());
+		out.close();
+	}
+
+	void dir::write_archive() {
+		DOCS_GEN_TRACE_SCOPE(span, "write_archive", "docs");
+		{
+			std::lock_guard lock(expanded_mutex_);
+			expanded_.clear();
+		}
 
-			out.write(L"# External Resources\n", 21);
-			out.write(L"## Scenes\n", 10);
-			for (const auto& [_, child] : file->get_packed_scenes()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, child->get_path());
-				out.put('\n');
+		archive_writer archive;
+		if (!archive.open(archive_path_, archive_format_))
+			return;
+
+		// compressing is most of the work, a single project run gets workers for it too
+		std::unique_ptr<thread_pool> local_pool;
+		auto* const pool = pool_;
+		if (!pool_) {
+			local_pool = std::make_unique<thread_pool>();
+			pool_ = local_pool.get();
+		}
+
+		// the page writers only render; the links inside pages do not depend on where they land
+		archive_ = &archive;
+		stream_pages(path_ / "docs");
+		archive.add(archive.entry_count(), "docs/.obsidian/graph.json", std::string(obsidian_graph));
+		archive_ = nullptr;
+		pool_ = pool;
+
+		const auto entries = archive.entry_count();
+		if (!archive.close()) {
+			DOCS_GEN_LOG_ERROR(docs, "could not write archive: ", archive_path_);
+			return;
+		}
+		DOCS_GEN_LOG_INFO(docs, "Wrote ", entries, " entries to ", archive_path_);
+		span.arg("entries", entries);
+	}
+
+	void dir::stream_pages(const std::filesystem::path& docs_path) {
+		DOCS_GEN_TRACE_SCOPE(span, "stream_pages", "docs");
+		DOCS_GEN_LOG_INFO(docs, streaming_ ? "Parsing and writing files" : "Writing files");
+
+		// the same pages the batch writer produces, one per uid for scenes and resources
+		std::vector<std::shared_ptr<file>> pages;
+		pages.reserve(file_tree_.size() + resource_files_.size() + script_files_.size());
+		for (const auto& [_, f] : file_tree_) if (in_slice(f->get_id())) pages.push_back(f);
+		for (const auto& [_, f] : resource_files_) if (in_slice(f->get_id())) pages.push_back(f);
+		for (const auto& f : script_files_) pages.push_back(f);
+
+		// when streaming each file is parsed, written and released before its worker takes the next
+		// one, so only as many bodies are alive as there are workers
+		prefetcher ahead{ streaming_ ? paths_of(pages) : std::vector<std::filesystem::path>{}, options_.prefetch_depth };
+		parallel_for(pool_, pages.size(), [&](std::size_t i) {
+			if (streaming_) ahead.claim(i);
+			const auto& f = pages[i];
+			if (!streaming_) {
+				if (const auto sf = std::dynamic_pointer_cast<scene_file>(f)) write_scene_page(docs_path, *sf, i);
+				else if (const auto rf = std::dynamic_pointer_cast<resource_file>(f)) write_resource_page(docs_path, *rf, i);
+				else if (const auto script = std::dynamic_pointer_cast<script_file>(f)) write_script_page(docs_path, *script, i);
+				return;
 			}
 
-			out.write(L"## Scripts\n", 11);
-			for (const auto& [_, script] : file->get_scripts()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, script->get_path());
-				out.put('\n');
+			if (const auto sf = std::dynamic_pointer_cast<scene_file>(f)) {
+				{
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_scene_body", "parse");
+					describe_file_span(parse_span, *sf);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					with_parser(sf, options_, [&](auto& p) {
+						const bool parsed = p.parse_scene_body();
+						record_parse(stats_, *sf, p, start);
+						return parsed;
+					}, split_pool());
+				}
+				write_scene_page(docs_path, *sf, i);
+				sf->release_contents();
 			}
-			
-			out.write(L"## Resources\n", 13);
-			for (const auto& [_, resource] : file->get_ext_resources()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, resource->get_path());
-				out.put('\n');
+			else if (const auto rf = std::dynamic_pointer_cast<resource_file>(f)) {
+				{
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_resource_body", "parse");
+					describe_file_span(parse_span, *rf);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					with_parser(rf, options_, [&](auto& p) {
+						const bool parsed = p.parse_resource_body();
+						record_parse(stats_, *rf, p, start);
+						return parsed;
+					});
+				}
+				write_resource_page(docs_path, *rf, i);
+				rf->release_contents();
 			}
-			for (const auto& [_, resource] : file->get_ext_resource_other()) {
-				out.write(L"- ", 2);
-				out.write(resource.name.data(), resource.name.size());
-				out.write(L": ", 2);
-				out.write(resource.type.data(), resource.type.size());
-				out.put('\n');
+			else if (const auto script = std::dynamic_pointer_cast<script_file>(f)) {
+				{
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_script", "parse");
+					describe_file_span(parse_span, *script);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					if (cache_) {
+						cache_->parse_script(script);
+					}
+					else {
+						script_parser p{ script };
+						p.parse();
+					}
+					record_script(stats_, *script, start);
+				}
+				write_script_page(docs_path, *script, i);
+				script->release_contents();
 			}
+		});
+		span.arg("pages", pages.size());
+	}
 
-			out.close();
+	void dir::write_budgeted(const std::filesystem::path& docs_path) {
+		DOCS_GEN_TRACE_SCOPE(span, "write_budgeted", "docs");
+		DOCS_GEN_LOG_INFO(docs, "Parsing and writing files within ", budget_.count(), " ms");
+		const auto& deadline = *deadline_;
+		auto options = options_;
+		options.cancel = &deadline;
+		const link_context ctx{ file_tree_, resource_files_, paths_, files_ };
+
+		// newest first, what was just edited is what is about to be looked up
+		std::vector<std::pair<std::filesystem::file_time_type, std::size_t>> order;
+		order.reserve(files_.size());
+		for (const auto& f : files_) {
+			std::error_code ec;
+			const auto time = std::filesystem::last_write_time(f->get_path(), ec);
+			order.emplace_back(ec ? std::filesystem::file_time_type::min() : time, f->get_id());
 		}
+		std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+			return a.first != b.first ? a.first > b.first : a.second < b.second;
+		});
 
-		std::cout << "[INFO] Writing resource files\n";
-		for (const auto& [_, file] : resource_files_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().wstring() + L".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
-
-			out.write(L"#resource\n", 10);
-			write_tres_resource(out, file, docs_dir);
-
-			out.write(L"# External Resources\n", 21);
-			out.write(L"## Scripts\n", 11);
-			for (const auto& [_, script] : file->get_scripts()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, script->get_path());
-				out.put('\n');
-			}
-			
-			out.write(L"## Scenes\n", 10);
-			for (const auto& [_, child] : file->get_packed_scenes()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, child->get_path());
-				out.put('\n');
-			}
-			
-			out.write(L"## Resources\n", 13);
-			for (const auto& [_, resource] : file->get_ext_resources()) {
-				out.write(L"- ", 2);
-				write_named_file_link(out, docs_dir, resource->get_path());
-				out.put('\n');
-			}
-			for (const auto& [_, resource] : file->get_ext_resource_other()) {
-				out.write(L"- ", 2);
-				out.write(resource.name.data(), resource.name.size());
-				out.write(L": ", 2);
-				out.write(resource.type.data(), resource.type.size());
-				out.put('\n');
-			}
-			
-			out.close();
-		}
-
-		std::cout << "[INFO] Writing script files\n";
-		for (const auto& [_, file] : script_files_) {
-			auto doc_path = file->get_path();
-			doc_path = std::filesystem::relative(doc_path, path_);
-			doc_path = docs_dir / doc_path;
-			std::filesystem::create_directories(doc_path.parent_path());
-			doc_path.replace_filename(doc_path.filename().string() + ".md");
-			std::wofstream out{ doc_path, std::ios::out | std::ios::binary };
-			
-			const auto& sc = file->get_script_class();
-
-			out.write(L"#script", 7);
-			for (const auto& tag : sc.tags) {
-				out.write(L" #", 2);
-				out.write(tag.data(), tag.size());
-			}
-			out.put('\n');
-			
-			out.write(L"## Extends ", 11);
-			out.write(sc.parent.data(), sc.parent.size());
-			out.put('\n');
-
-			out.write(L"## Class ", 9);
-			out.write(sc.name.data(), sc.name.size());
-			out.put('\n');
-
-			if (!sc.short_desc.empty()) {
-				out.put('\t');
-				out.write(sc.short_desc.data(), sc.short_desc.size());
-				out.put('\n');
-			}
-
-			out.write(L"## Variables\n", 13);
-			for (const auto& cat : sc.categories) {
-				if (!cat.name.empty()) {
-					out.write(L"- ", 2);
-					out.write(L"### ", 4);
-					out.write(cat.name.data(), cat.name.size());
-					out.put('\n');
+		enum class state : std::uint8_t { skipped, queued, written, cancelled };
+		std::vector<state> states(files_.size(), state::skipped);
+		// a few files per worker at a time, so the references of a round are picked up soon after
+		const auto round_size = 4 * ((pool_ ? pool_->worker_count() : 0) + 1);
+		std::vector<std::size_t> round;
+		std::vector<std::size_t> next;
+		std::vector<std::size_t> targets;
+		std::size_t seed = 0;
+		std::size_t written = 0;
+		// one reader for the whole run, every round appends its files to it
+		prefetcher ahead{ {}, options_.prefetch_depth };
+		std::vector<std::filesystem::path> round_paths;
+		while (!deadline.expired()) {
+			// what the last round references goes first, then the next newest files
+			round.swap(next);
+			next.clear();
+			while (round.size() < round_size && seed < order.size()) {
+				const auto id = order[seed++].second;
+				if (states[id] != state::skipped) continue;
+				states[id] = state::queued;
+				round.push_back(id);
+			}
+			if (round.empty())
+				break;
+
+			round_paths.clear();
+			for (const auto id : round) round_paths.push_back(files_[id]->get_path());
+			const auto first = ahead.append(round_paths);
+			parallel_for(pool_, round.size(), [&](std::size_t i) {
+				// a file not started by the deadline stays queued and is listed as skipped
+				if (deadline.expired()) return;
+				ahead.claim(first + i);
+				const auto& f = files_[round[i]];
+				bool parsed = true;
+				if (const auto sf = std::dynamic_pointer_cast<scene_file>(f)) {
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_scene", "parse");
+					describe_file_span(parse_span, *sf);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					parsed = with_parser(sf, options, [&](auto& p) {
+						const bool ok = p.parse_scene_header() && p.parse_scene_links(ctx) && p.parse_scene_body();
+						record_parse(stats_, *sf, p, start);
+						return ok;
+					}, split_pool());
+					if (parsed || !deadline.cancelled()) write_scene_page(docs_path, *sf);
+					sf->release_contents();
 				}
-				else {
-					out.write(L"- ", 2);
-					out.write(L"### Default Export Group\n", 25);
+				else if (const auto rf = std::dynamic_pointer_cast<resource_file>(f)) {
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_resource", "parse");
+					describe_file_span(parse_span, *rf);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					parsed = with_parser(rf, options, [&](auto& p) {
+						const bool ok = p.parse_resource_header() && p.parse_resource_links(ctx) && p.parse_resource_body();
+						record_parse(stats_, *rf, p, start);
+						return ok;
+					});
+					if (parsed || !deadline.cancelled()) write_resource_page(docs_path, *rf);
+					rf->release_contents();
 				}
-				
-				for (const auto& var : cat.variables) {
-					out.put('\t');
-					out.write(L"- ", 2);
-					if (var.name[0] == '_') {
-						out.put('\\');
+				else if (const auto script = std::dynamic_pointer_cast<script_file>(f)) {
+					DOCS_GEN_TRACE_SCOPE(parse_span, "parse_script", "parse");
+					describe_file_span(parse_span, *script);
+					const auto start = stats_ ? parse_stats::now_ns() : 0;
+					if (cache_) {
+						// whole, a cache entry is never left half read
+						cache_->parse_script(script);
 					}
-					out.write(var.name.data(), var.name.size());
-					out.write(L" : ", 3);
-					out.write(var.type.data(), var.type.size());
-					out.put('\n');
-
-					if (!var.short_desc.empty()) {
-						out.write(L"\t\t", 2);
-						out.write(var.short_desc.data(), var.short_desc.size());
-						out.put('\n');
+					else {
+						script_parser p{ script, &deadline };
+						parsed = p.parse();
 					}
+					record_script(stats_, *script, start);
+					if (parsed || !deadline.cancelled()) write_script_page(docs_path, *script);
+					script->release_contents();
 				}
-			}
+				// a file that fails to parse gets its page anyway, as it does when streaming
+				states[round[i]] = parsed || !deadline.cancelled() ? state::written : state::cancelled;
+			});
 
-			out.write(L"## Functions\n", 13);
-			for (const auto& func : sc.functions) {
-				out.write(L"- ", 2);
-				if (func.name[0] == '_') {
-					out.put('\\');
+			for (const auto id : round) {
+				if (states[id] != state::written)
+					continue;
+				++written;
+				// later rounds link through the uids read so far, by path otherwise
+				const auto& f = files_[id];
+				if (const auto sf = std::dynamic_pointer_cast<scene_file>(f)) {
+					file_tree_.insert_or_assign(sf->get_uid(), sf);
+				}
+				else if (const auto rf = std::dynamic_pointer_cast<resource_file>(f)) {
+					resource_files_.insert_or_assign(rf->get_uid(), rf);
 				}
-				out.write(func.name.data(), func.name.size());
-				out.put('\n');
+				else {
+					continue;
+				}
+
+				targets.clear();
+				collect_direct_references(*f, targets);
+				for (const auto to : targets) {
+					if (states[to] != state::skipped) continue;
+					states[to] = state::queued;
+					next.push_back(to);
+				}
+			}
+		}
+		span.arg("pages", written);
+
+		std::error_code ec;
+		const auto manifest = docs_path / skipped_manifest_name;
+		if (written == files_.size()) {
+			std::filesystem::remove(manifest, ec);
+			DOCS_GEN_LOG_INFO(docs, "Wrote all ", written, " pages within the budget");
+			return;
+		}
+
+		// newest first, the order the next budgeted run starts from too
+		std::ofstream out{ manifest, std::ios::out | std::ios::binary };
+		out << "docs_gen budget " << budget_.count() << " ms: " << written << " of " << files_.size() << " pages written, "
+			<< files_.size() - written << " skipped\n";
+		out << "# pages below are missing or left from an earlier run; a run without --budget writes every page\n";
+		for (const auto& [_, id] : order) {
+			if (states[id] == state::written)
+				continue;
+			out << (states[id] == state::cancelled ? "cancelled" : "skipped") << " res://"
+				<< path_resolver::normalize(path_, files_[id]->get_path()) << '\n';
+		}
+		DOCS_GEN_LOG_WARNING(docs, "budget of ", budget_.count(), " ms used up after ", written, " of ", files_.size(),
+			" pages, the rest are listed in ", manifest);
+	}
+
+	void dir::write_shard_index(const std::filesystem::path& docs_path) const {
+		const auto shards_dir = docs_path / shard_dir_name;
+		std::filesystem::create_directories(shards_dir);
+		const auto name = "shard-" + std::to_string(shard_index_ + 1) + "-of-" + std::to_string(shard_count_) + ".idx";
+		std::ofstream out{ shards_dir / name, std::ios::out | std::ios::binary };
+
+		out << "docs_gen shard " << shard_index_ + 1 << ' ' << shard_count_ << ' ' << files_.size() << ' '
+			<< std::hex << tree_fingerprint(path_, files_) << std::dec << '\n';
+
+		// the pages written here, their tails are left to the merge
+		std::vector<std::size_t> pages;
+		for (const auto& [_, f] : file_tree_) if (in_slice(f->get_id())) pages.push_back(f->get_id());
+		for (const auto& [_, f] : resource_files_) if (in_slice(f->get_id())) pages.push_back(f->get_id());
+		for (const auto& f : script_files_) pages.push_back(f->get_id());
+		std::sort(pages.begin(), pages.end());
+		for (const auto id : pages) {
+			out << "p " << id << '\n';
+		}
+
+		// the forward edges of the files parsed here, every edge of the project is in one shard
+		std::vector<std::size_t> refs;
+		for (const auto& f : files_) {
+			const auto kind = f->get_kind();
+			if (!in_slice(f->get_id()) || (kind != file_kind::scene && kind != file_kind::resource))
+				continue;
+			refs.clear();
+			collect_direct_references(*f, refs);
+			out << "e " << f->get_id();
+			for (const auto to : refs) {
+				out << ' ' << to;
+			}
+			out << '\n';
+		}
+	}
+
+	bool dir::merge_shards() {
+		DOCS_GEN_TRACE_SCOPE(span, "merge_shards", "docs");
+		index_files();
+		const auto docs_dir = path_ / "docs";
+		const auto shards_dir = docs_dir / shard_dir_name;
+
+		std::vector<std::filesystem::path> parts;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(shards_dir, ec)) {
+			if (entry.path().extension() == ".idx") parts.push_back(entry.path());
+		}
+		if (ec || parts.empty()) {
+			DOCS_GEN_LOG_ERROR(docs, "no shard indexes in ", shards_dir);
+			return false;
+		}
+		std::sort(parts.begin(), parts.end());
+
+		DOCS_GEN_LOG_INFO(docs, "Merging ", parts.size(), " shards");
+		const auto fingerprint = tree_fingerprint(path_, files_);
+		std::size_t count = 0;
+		std::vector<bool> seen;
+		std::vector<std::size_t> pages;
+		std::vector<std::vector<std::size_t>> edges(files_.size());
+		for (const auto& part : parts) {
+			std::ifstream in(part, std::ios::in | std::ios::binary);
+			std::string magic, word;
+			std::size_t index = 0, n = 0, file_count = 0;
+			std::uint64_t fp = 0;
+			if (!(in >> magic >> word >> index >> n >> file_count >> std::hex >> fp >> std::dec) || magic != "docs_gen" || word != "shard") {
+				DOCS_GEN_LOG_ERROR(docs, "not a shard index: ", part);
+				return false;
+			}
+			if (count == 0) {
+				count = n;
+				seen.assign(count, false);
+			}
+			if (n != count || index == 0 || index > count || seen[index - 1]) {
+				DOCS_GEN_LOG_ERROR(docs, "shard ", index, "/", n, " does not belong with the others: ", part);
+				return false;
+			}
+			if (file_count != files_.size() || fp != fingerprint) {
+				DOCS_GEN_LOG_ERROR(docs, "shard ", index, "/", n, " indexed a different tree than ", path_);
+				return false;
+			}
+			seen[index - 1] = true;
 
-				if (!func.short_desc.empty()) {
-					out.put('\t');
-					out.write(func.short_desc.data(), func.short_desc.size());
-					out.put('\n');
+			std::string line;
+			while (std::getline(in, line)) {
+				std::istringstream ls(line);
+				std::string tag;
+				std::size_t id = 0;
+				if (!(ls >> tag >> id))
+					continue;
+				if (id >= files_.size()) {
+					DOCS_GEN_LOG_ERROR(docs, "corrupted shard index: ", part);
+					return false;
+				}
+				if (tag == "p") {
+					pages.push_back(id);
 				}
-				
-				out.write(L"\tArguments\n", 11);
-				for (const auto& arg : func.arguments) {
-					out.write(L"\t- ", 3);
-					if (arg.name[0] == '_') {
-						out.put('\\');
+				else if (tag == "e") {
+					for (std::size_t to; ls >> to; ) {
+						if (to < files_.size()) edges[id].push_back(to);
 					}
-					out.write(arg.name.data(), arg.name.size());
-					out.write(L" : ", 3);
-					out.write(arg.type.data(), arg.type.size());
-					out.put('\n');
 				}
-				out.write(L"\tReturn type: ", 14);
-				out.write(func.return_type.data(), func.return_type.size());
-				out.put('\n');
 			}
-			out.close();
+		}
+		for (std::size_t i = 0; i < count; ++i) {
+			if (!seen[i]) {
+				DOCS_GEN_LOG_ERROR(docs, "shard ", i + 1, "/", count, " is missing from ", shards_dir);
+				return false;
+			}
 		}
 
-		// TODO develop a proper way of item coloring in obsidian
-		auto obsidian_dir = docs_dir / ".obsidian";
-		std::filesystem::create_directory(obsidian_dir);
-		
-		std::ofstream out{ obsidian_dir / "graph.json", std::ios::out | std::ios::binary };
-		
-		std::string temp =
-			R"({"colorGroups":[{"query":"tag:#scene","color":{"a":1,"rgb":14048348}},{"query":"tag:#script","color":{"a":1,"rgb":6577366}},{"query":"tag:#resource","color":{"a":1,"rgb":4521728}}]})";
-		out.write(temp.data(), temp.size());
-		out.close();
+		// the edges go back into the freshly indexed files, the graph is then built as in one run
+		for (std::size_t from = 0; from < files_.size(); ++from) {
+			const auto df = std::dynamic_pointer_cast<dott_file>(files_[from]);
+			if (!df) continue;
+			for (std::size_t k = 0; k < edges[from].size(); ++k) {
+				const auto& target = files_[edges[from][k]];
+				const auto key = std::to_wstring(k);
+				switch (target->get_kind()) {
+				case file_kind::scene:
+					df->push_packed_scene(key, std::static_pointer_cast<scene_file>(target));
+					break;
+				case file_kind::resource:
+					df->push_ext_resource(key, std::static_pointer_cast<resource_file>(target));
+					break;
+				case file_kind::script:
+					if (const auto sf = std::dynamic_pointer_cast<scene_file>(df)) sf->push_script(key, std::static_pointer_cast<script_file>(target));
+					if (const auto rf = std::dynamic_pointer_cast<resource_file>(df)) rf->push_script(key, std::static_pointer_cast<script_file>(target));
+					break;
+				default:
+					break;
+				}
+			}
+			df->freeze_links();
+		}
+		ref_index_.build(files_);
+		closure_.build(files_);
+
+		for (const auto id : pages) {
+			const auto& f = *files_[id];
+			auto doc_path = docs_dir / std::filesystem::relative(f.get_path(), path_);
+			doc_path.replace_filename(doc_path.filename().wstring() + L".md");
+			if (!std::filesystem::exists(doc_path)) {
+				DOCS_GEN_LOG_ERROR(docs, "page missing, copy the docs of every shard together first: ", doc_path);
+				return false;
+			}
+
+			markdown_buffer out;
+			if (f.get_kind() != file_kind::script) {
+				write_dependencies(out, f);
+			}
+			write_referrers(out, f);
+			const auto bytes = narrow_page(out.str());
+			std::ofstream page{ doc_path, std::ios::out | std::ios::app | std::ios::binary };
+			page.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+
+		std::filesystem::remove_all(shards_dir);
+		DOCS_GEN_LOG_INFO(docs, "Merged ", pages.size(), " pages");
+		span.arg("pages", pages.size());
+		return true;
 	}
 
 	bool dir::is_ignored(const std::filesystem::path& path) const {
 		for (const auto& ignored : ignored_folders_) {
 			if (path.compare(ignored) == 0) {
-				std::cout << "\tshould be ignored\n";
+				DOCS_GEN_LOG_DEBUG(index, path, " should be ignored");
 				return true;
 			}
 
 			auto rel = std::filesystem::relative(path, ignored);
-			std::cout << path << '\n';
 			if (!rel.empty() && rel.native()[0] != '.') {
-				std::cout << "\tshould be ignored\n";
+				DOCS_GEN_LOG_DEBUG(index, path, " should be ignored");
 				return true;
 			}
 		}
@@ -332,102 +1092,400 @@ namespace docs_gen_core {
 		return false;
 	}
 
-	void dir::write_named_file_link(std::wofstream& out, const std::filesystem::path& docs_path,
-		const std::filesystem::path& file_path) const {
-		auto doc_path = std::filesystem::relative(file_path, path_);
-		doc_path = docs_path / doc_path;
-		doc_path.replace_filename(doc_path.filename().wstring() + L".md");
-		const auto file_name = doc_path.filename().wstring();
-		const auto link_name = doc_path.stem().wstring();
-		out.put('[');
-		out.write(link_name.c_str(), link_name.size());
-		out.write(L"](", 2);
-		out.write(file_name.c_str(), file_name.size());
-		out.put(')');
-	}
-
-	void dir::write_tres_resource(std::wofstream& out, const std::weak_ptr<resource_file>& file, const std::filesystem::path& docs_path) const {
-		if (file.expired()) return;
-		const auto& f = file.lock();
-		
-		out.write(L"# Using\n", 8);
-		write_tres_resource_(out, docs_path, f->get_resource());
+	void dir::write_named_file_link(markdown_buffer& out, const std::filesystem::path& file_path) const {
+		write_file_link(out, file_path, {});
+	}
 
-		out.write(L"## Sub_Resources\n", 17);
-		for (const auto& [_, res] : f->get_sub_resources()) {
-			write_tres_resource_(out, docs_path, *res.get(), true);
-		}
+	void dir::write_file_link(markdown_buffer& out, const std::filesystem::path& file_path, std::wstring_view label) const {
+		// pages mirror the project tree and links are by file name, so the source file name is all
+		// a link needs; no relative() call, which touches the file system, per link
+		const auto source_name = file_path.filename().wstring();
+		out.append(L'[', label.empty() ? std::wstring_view(source_name) : label, L"](", source_name, L".md)");
 	}
 
-	void dir::write_tres_resource_(std::wofstream& out, const std::filesystem::path& docs_path,
-		const resource_file::resource& res, bool sub_res) const {
-		if (sub_res) {
-			out.write(res.type.data(), res.type.size());
-			out.put('\n');
-		}
-		for (const auto& [name, ext_res] : res.res_file_fields) {
-			if (sub_res) {
-				out.write(L"\t- ", 3);
+	void dir::write_type(markdown_buffer& out, std::wstring_view type) const {
+		const auto is_ident = [](wchar_t c) { return c == '_' || std::iswalnum(c); };
+
+		// "Array[Enemy]" links Enemy, builtins and unknown names are written as they are
+		for (std::size_t i = 0; i < type.size(); ) {
+			if (!is_ident(type[i])) {
+				out.append(type[i++]);
+				continue;
+			}
+
+			auto j = i;
+			while (j < type.size() && is_ident(type[j])) ++j;
+			const auto ident = type.substr(i, j - i);
+			if (const auto id = classes_.find(ident); id != file::npos) {
+				write_file_link(out, files_[id]->get_path(), ident);
 			}
 			else {
-				out.write(L"- ", 2);
+				out.append(ident);
 			}
-			out.write(name.data(), name.size());
-			out.write(L": ", 2);
+			i = j;
+		}
+	}
 
-			if (ext_res.expired()) {
-				out.write(L"Unknown file\n", 13);
+	void dir::write_expanded_instance(markdown_buffer& out, std::size_t from,
+		const node_tree::tree_node& node, std::size_t indent, std::size_t depth) const {
+		if (depth == 0) return;
+		const auto scene = std::dynamic_pointer_cast<scene_file>(node.instance.lock());
+		if (!scene) return;
+
+		// cut wherever the instanced scene leads back to the instancing one; this depends on the
+		// two scenes only, so a memoized subtree reads the same from every page
+		const auto id = scene->get_id();
+		if (id == from || closure_.in_same_cycle(from, id)) {
+			out.tabs(indent).append(L"- *cycle*: ");
+			write_named_file_link(out, scene->get_path());
+			out.append(L'\n');
+			return;
+		}
+
+		const auto subtree = expanded_subtree(scene, depth);
+		const std::wstring_view text = *subtree;
+		for (std::size_t start = 0; start < text.size(); ) {
+			const auto end = text.find('\n', start) + 1;
+			out.tabs(indent).append(text.substr(start, end - start));
+			start = end;
+		}
+	}
+
+	std::shared_ptr<const std::wstring> dir::expanded_subtree(const std::shared_ptr<scene_file>& scene, std::size_t depth) const {
+		const auto key = static_cast<std::uint64_t>(scene->get_id()) << 16 | std::min<std::size_t>(depth, 0xFFFF);
+		{
+			std::lock_guard lock(expanded_mutex_);
+			if (const auto it = expanded_.find(key); it != expanded_.end())
+				return it->second;
+		}
+
+		// a streaming run released (or has not parsed yet) the other trees and a shard only parsed
+		// its own, the scene is read again on its own for as long as its subtree is being rendered
+		auto source = scene;
+		if (streaming_ || budgeted() || !in_slice(scene->get_id())) {
+			source = std::make_shared<scene_file>(scene->get_path());
+			const link_context ctx{ file_tree_, resource_files_, paths_, files_ };
+			// the budget stops pages from being started, one that is being written is finished
+			auto options = options_;
+			options.cancel = nullptr;
+			with_parser(source, options, [&](auto& p) { return p.parse_scene_file_contents(ctx); }, split_pool());
+		}
+
+		// the instanced root is the instancing node itself, its children start at indent 0
+		markdown_buffer out;
+		auto& nodes = source->get_node_tree();
+		for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+			const auto& node = **it;
+			if (node.depth < 2) continue;
+			out.tabs(node.depth - 2).append(L"- ", node.name, L'\n');
+			write_expanded_instance(out, scene->get_id(), node, node.depth - 1, depth - 1);
+		}
+
+		auto res = std::make_shared<const std::wstring>(out.take());
+		std::lock_guard lock(expanded_mutex_);
+		return expanded_.emplace(key, std::move(res)).first->second;
+	}
+
+	void dir::write_inheritance(markdown_buffer& out, const script_file& file) const {
+		const auto chain = classes_.get_chain(file.get_id());
+		if (chain.empty()) return;
+
+		// "Player < Enemy < Node2D", nearest parent first
+		out.append(L"## Inherits ");
+		for (std::size_t i = 0; i < chain.size(); ++i) {
+			if (i != 0) {
+				out.append(L" < ");
 			}
-			else {
-				write_named_file_link(out, docs_path, ext_res.lock()->get_path());
-				out.put('\n');
+			write_file_link(out, files_[chain[i]]->get_path(), classes_.get_name(chain[i]));
+		}
+		if (classes_.is_in_cycle(file.get_id())) {
+			out.append(L" (cycle)");
+		}
+		else if (const auto base = classes_.get_native_base(file.get_id()); !base.empty()) {
+			out.append(L" < ", base);
+		}
+		out.append(L'\n');
+	}
+
+	void dir::write_page(const std::filesystem::path& docs_path, const file& f, const markdown_buffer& page, std::size_t sequence) const {
+		auto bytes = narrow_page(page.str());
+		if (archive_) {
+			archive_->add(sequence, "docs/" + path_resolver::normalize(path_, f.get_path()) + ".md", std::move(bytes));
+			return;
+		}
+
+		auto doc_path = docs_path / std::filesystem::relative(f.get_path(), path_);
+		std::filesystem::create_directories(doc_path.parent_path());
+		doc_path.replace_filename(doc_path.filename().wstring() + L".md");
+		std::ofstream out{ doc_path, std::ios::out | std::ios::binary };
+		out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	void dir::push_file(const std::shared_ptr<file>& f) {
+		f->set_id(files_.size());
+		files_.push_back(f);
+	}
+
+	void dir::write_scene_page(const std::filesystem::path& docs_path, scene_file& file, std::size_t sequence) const {
+		DOCS_GEN_TRACE_SCOPE(page_span, "write_scene_page", "docs");
+		page_span.set_detail(file.get_path());
+		markdown_buffer out{ page_capacity };
+
+		out.append(L"#scene\n", L"# Node Tree\n");
+		auto& nodes = file.get_node_tree();
+		for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+			const auto depth = (*it)->depth;
+			out.tabs(depth - 1).append(L"- ", (*it)->name, L'\n');
+
+			for (const auto& [f, s] : (*it)->ext_resource_fields) {
+				if (!s.expired()) {
+					out.tabs(depth).append(L"  *", f, L"*: ");
+					write_named_file_link(out, s.lock()->get_path());
+					out.append(L'\n');
+				}
 			}
+			// decoded here, only the values a page shows are ever parsed
+			for (const auto& [name, text] : (*it)->properties) {
+				const auto value = decode_value(text);
+				if (value.kind == value_kind::other)
+					continue;
+				out.tabs(depth).append(L"  *", name, L"*: ");
+				write_value(out, value);
+				out.append(L'\n');
+			}
+			write_expanded_instance(out, file.get_id(), **it, depth, expand_depth_);
 		}
-		
-		for (const auto& [name, ext_other_res] : res.res_other_fields) {
-			if (sub_res) {
-				out.write(L"\t- ", 3);
+
+		out.append(L"# External Resources\n", L"## Scenes\n");
+		for (const auto& [_, child] : file.get_packed_scenes()) {
+			out.append(L"- ");
+			write_named_file_link(out, child->get_path());
+			out.append(L'\n');
+		}
+
+		out.append(L"## Scripts\n");
+		for (const auto& [_, script] : file.get_scripts()) {
+			out.append(L"- ");
+			write_named_file_link(out, script->get_path());
+			out.append(L'\n');
+		}
+
+		out.append(L"## Resources\n");
+		for (const auto& [_, resource] : file.get_ext_resources()) {
+			out.append(L"- ");
+			write_named_file_link(out, resource->get_path());
+			out.append(L'\n');
+		}
+		for (const auto& [_, resource] : file.get_ext_resource_other()) {
+			out.append(L"- ", resource.name, L": ", resource.type, L'\n');
+		}
+
+		// a shard leaves what needs the whole graph to merge_shards, a budgeted run never has it
+		if (whole_graph()) {
+			write_dependencies(out, file);
+			write_referrers(out, file);
+		}
+
+		write_page(docs_path, file, out, sequence);
+	}
+
+	void dir::write_resource_page(const std::filesystem::path& docs_path, const resource_file& file, std::size_t sequence) const {
+		DOCS_GEN_TRACE_SCOPE(page_span, "write_resource_page", "docs");
+		page_span.set_detail(file.get_path());
+		markdown_buffer out{ page_capacity };
+
+		out.append(L"#resource\n");
+		write_tres_resource(out, file);
+
+		out.append(L"# External Resources\n", L"## Scripts\n");
+		for (const auto& [_, script] : file.get_scripts()) {
+			out.append(L"- ");
+			write_named_file_link(out, script->get_path());
+			out.append(L'\n');
+		}
+
+		out.append(L"## Scenes\n");
+		for (const auto& [_, child] : file.get_packed_scenes()) {
+			out.append(L"- ");
+			write_named_file_link(out, child->get_path());
+			out.append(L'\n');
+		}
+
+		out.append(L"## Resources\n");
+		for (const auto& [_, resource] : file.get_ext_resources()) {
+			out.append(L"- ");
+			write_named_file_link(out, resource->get_path());
+			out.append(L'\n');
+		}
+		for (const auto& [_, resource] : file.get_ext_resource_other()) {
+			out.append(L"- ", resource.name, L": ", resource.type, L'\n');
+		}
+
+		// a shard leaves what needs the whole graph to merge_shards, a budgeted run never has it
+		if (whole_graph()) {
+			write_dependencies(out, file);
+			write_referrers(out, file);
+		}
+
+		write_page(docs_path, file, out, sequence);
+	}
+
+	void dir::write_script_page(const std::filesystem::path& docs_path, const script_file& file, std::size_t sequence) const {
+		DOCS_GEN_TRACE_SCOPE(page_span, "write_script_page", "docs");
+		page_span.set_detail(file.get_path());
+		markdown_buffer out{ page_capacity };
+
+		const auto& sc = file.get_script_class();
+
+		out.append(L"#script");
+		for (const auto& tag : sc.tags) {
+			out.append(L" #", tag);
+		}
+		out.append(L'\n');
+
+		out.append(L"## Extends ");
+		if (const auto parent = classes_.get_parent(file.get_id()); parent != file::npos) {
+			write_file_link(out, files_[parent]->get_path(), sc.parent);
+		}
+		else {
+			out.append(sc.parent);
+		}
+		out.append(L'\n');
+		write_inheritance(out, file);
+
+		out.append(L"## Class ", sc.name, L'\n');
+
+		if (!sc.short_desc.empty()) {
+			out.append(L'\t', sc.short_desc, L'\n');
+		}
+
+		out.append(L"## Variables\n");
+		for (const auto& cat : sc.categories) {
+			if (!cat.name.empty()) {
+				out.append(L"- ### ", cat.name, L'\n');
 			}
 			else {
-				out.write(L"- ", 2);
+				out.append(L"- ### Default Export Group\n");
+			}
+
+			for (const auto& var : cat.variables) {
+				out.append(L"\t- ");
+				if (var.name[0] == '_') {
+					out.append(L'\\');
+				}
+				out.append(var.name, L" : ");
+				write_type(out, var.type);
+				out.append(L'\n');
+
+				if (!var.short_desc.empty()) {
+					out.append(L"\t\t", var.short_desc, L'\n');
+				}
 			}
-			out.write(name.data(), name.size());
-			out.write(L": ", 2);
-			out.write(ext_other_res.data(), ext_other_res.size());
-			out.put('\n');
 		}
 
-		for (const auto& [name, ext_res] : res.sub_res_fields) {
-			if (sub_res) {
-				out.write(L"\t- ", 3);
+		out.append(L"## Functions\n");
+		for (const auto& func : sc.functions) {
+			out.append(L"- ");
+			if (func.name[0] == '_') {
+				out.append(L'\\');
 			}
-			else {
-				out.write(L"- ", 2);
+			out.append(func.name, L'\n');
+
+			if (!func.short_desc.empty()) {
+				out.append(L'\t', func.short_desc, L'\n');
 			}
-			out.write(name.data(), name.size());
-			out.write(L": ", 2);
 
+			out.append(L"\tArguments\n");
+			for (const auto& arg : func.arguments) {
+				out.append(L"\t- ");
+				if (arg.name[0] == '_') {
+					out.append(L'\\');
+				}
+				out.append(arg.name, L" : ");
+				write_type(out, arg.type);
+				out.append(L'\n');
+			}
+			out.append(L"\tReturn type: ");
+			write_type(out, func.return_type);
+			out.append(L'\n');
+		}
+
+		if (whole_graph()) {
+			write_referrers(out, file);
+		}
+		write_page(docs_path, file, out, sequence);
+	}
+
+	void dir::write_dependencies(markdown_buffer& out, const file& f) const {
+		const auto s = closure_.get_summary(f.get_id());
+		out.append(L"# Dependencies\n", L"- Scenes: ").number(s.scenes).append(L'\n');
+		out.append(L"- Scripts: ").number(s.scripts).append(L'\n');
+		out.append(L"- Resources: ").number(s.resources).append(L'\n');
+
+		const auto cycle = closure_.get_cycle(f.get_id());
+		if (!cycle.empty()) {
+			out.append(L"## Cycle\n");
+			for (auto id : cycle) {
+				out.append(L"- ");
+				write_named_file_link(out, files_[id]->get_path());
+				out.append(L'\n');
+			}
+		}
+	}
+
+	void dir::write_referrers(markdown_buffer& out, const file& f) const {
+		out.append(L"# Referenced by\n");
+		for (auto id : ref_index_.get_referrers(f.get_id())) {
+			out.append(L"- ");
+			write_named_file_link(out, files_[id]->get_path());
+			out.append(L'\n');
+		}
+	}
+
+	void dir::write_tres_resource(markdown_buffer& out, const resource_file& file) const {
+		out.append(L"# Using\n");
+		write_tres_resource_(out, file.get_resource());
+
+		out.append(L"## Sub_Resources\n");
+		for (const auto& [_, res] : file.get_sub_resources()) {
+			write_tres_resource_(out, *res.get(), true);
+		}
+	}
+
+	void dir::write_tres_resource_(markdown_buffer& out, const resource_file::resource& res, bool sub_res) const {
+		if (sub_res) {
+			out.append(res.type, L'\n');
+		}
+		// the list item every field starts with, one level deeper below a sub_resource
+		const std::wstring_view item = sub_res ? std::wstring_view(L"\t- ") : std::wstring_view(L"- ");
+		for (const auto& [name, ext_res] : res.res_file_fields) {
+			out.append(item, name, L": ");
 			if (ext_res.expired()) {
-				out.write(L"Unknown sub_resource\n", 13);
+				out.append(L"Unknown file\n");
 			}
 			else {
-				const auto& r = ext_res.lock();
-				out.write(r->type.data(), r->type.size());
-				out.put('\n');
+				write_named_file_link(out, ext_res.lock()->get_path());
+				out.append(L'\n');
 			}
 		}
 
-		for (const auto& [name, val] : res.fields) {
-			if (sub_res) {
-				out.write(L"\t- ", 3);
+		for (const auto& f : res.res_other_fields) {
+			out.append(item, f.name, L": ", f.value, L'\n');
+		}
+
+		for (const auto& [name, ext_res] : res.sub_res_fields) {
+			out.append(item, name, L": ");
+			if (ext_res.expired()) {
+				out.append(L"Unknown sub_resource\n");
 			}
 			else {
-				out.write(L"- ", 2);
+				out.append(ext_res.lock()->type, L'\n');
 			}
-			out.write(name.data(), name.size());
-			out.write(L": ", 2);
-			out.write(val.data(), val.size());
-			out.put('\n');
+		}
+
+		// summarized values are written as their summary, the full text stays in the source file
+		for (const auto& f : res.fields) {
+			out.append(item, f.name, L": ", f.value, L'\n');
 		}
 	}
 
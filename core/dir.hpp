@@ -1,13 +1,27 @@
 #ifndef DOCS_GEN_DIR_H
 #define DOCS_GEN_DIR_H
 
+#include <chrono>
 #include <filesystem>
 #include <vector>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
+#include "archive.hpp"
+#include "cancel.hpp"
+#include "class_registry.hpp"
+#include "closure.hpp"
 #include "file.hpp"
+#include "markdown.hpp"
+#include "parse_cache.hpp"
+#include "parse_stats.hpp"
+#include "parser.hpp"
+#include "path_resolver.hpp"
+#include "ref_index.hpp"
+#include "thread_pool.hpp"
+#include "uid.hpp"
 
 namespace docs_gen_core {
 
@@ -15,9 +29,45 @@ namespace docs_gen_core {
 		std::filesystem::path path_;
 		std::vector<std::wstring> ignored_folders_;
 
-		std::unordered_map<std::wstring, std::shared_ptr<scene_file>> file_tree_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> script_files_;
-		std::unordered_map<std::wstring, std::shared_ptr<resource_file>> resource_files_;
+		uid_map<std::shared_ptr<scene_file>> file_tree_;
+		std::vector<std::shared_ptr<script_file>> script_files_;
+		uid_map<std::shared_ptr<resource_file>> resource_files_;
+
+		std::vector<std::shared_ptr<file>> files_;
+		std::vector<std::shared_ptr<scene_file>> scene_queue_;
+		std::vector<std::shared_ptr<resource_file>> resource_queue_;
+		path_resolver paths_;
+		ref_index ref_index_;
+		dependency_closure closure_;
+		class_registry classes_;
+		parse_options options_;
+		bool streaming_ = false;
+		std::size_t expand_depth_ = 0;
+		bool reachable_only_ = false;
+		std::vector<std::wstring> entry_points_;
+		// this run parses and writes the files whose id % shard_count_ is shard_index_
+		std::size_t shard_index_ = 0;
+		std::size_t shard_count_ = 1;
+		// gen_docs writes one archive here instead of the docs folder when set
+		std::filesystem::path archive_path_;
+		archive_format archive_format_ = archive_format::tar;
+		// the archive gen_docs is writing, null otherwise
+		archive_writer* archive_ = nullptr;
+		// how long construct_file_tree + gen_docs may take, 0 has no limit
+		std::chrono::milliseconds budget_{ 0 };
+		// set by construct_file_tree when there is a budget
+		std::unique_ptr<cancel_token> deadline_;
+
+		// rendered subtrees of instanced scenes keyed by scene id and depth, see set_expand_instances
+		mutable std::mutex expanded_mutex_;
+		mutable std::unordered_map<std::uint64_t, std::shared_ptr<const std::wstring>> expanded_;
+
+		// not owned, shared between the projects of a batch
+		thread_pool* pool_ = nullptr;
+		parse_cache* cache_ = nullptr;
+		parse_stats* stats_ = nullptr;
+		// big text scenes of a run without pool_ are split on this one, see construct_file_tree
+		std::unique_ptr<thread_pool> split_pool_;
 
 	public:
 		dir() = default;
@@ -31,19 +81,122 @@ namespace docs_gen_core {
 		[[nodiscard]] bool set_path(const std::wstring& path);
 		void set_ignored_folders(const std::vector<std::wstring>& folders) { ignored_folders_ = folders; }
 		void push_ignored_folder(const std::wstring& folder) { ignored_folders_.push_back(folder); }
-
+		void set_parse_options(const parse_options& options) { options_ = options; }
+		// files are parsed on pool when set, serially otherwise
+		void set_thread_pool(thread_pool* pool) { pool_ = pool; }
+		// scripts are looked up by content in cache when set
+		void set_parse_cache(parse_cache* cache) { cache_ = cache; }
+		// every parsed scene, resource and script body is recorded into stats when set
+		void set_parse_stats(parse_stats* stats) { stats_ = stats; }
+		// construct_file_tree only reads the external resources of each file, gen_docs then parses,
+		// writes and releases one file at a time, so memory follows the files in flight instead of
+		// the project size
+		void set_streaming(bool streaming) { streaming_ = streaming; }
+		// scene pages render the nodes of instanced scenes under the instancing node, recursively up
+		// to depth levels of instancing, 0 shows only the instancing node
+		void set_expand_instances(std::size_t depth) { expand_depth_ = depth; }
+		// only the files the entry points reach through ext_resources are parsed and documented;
+		// without entry points set they are read from project.godot, see read_entry_points
+		void set_reachable_only(bool reachable) { reachable_only_ = reachable; }
+		// "res://...", "uid://..." or a path relative to the project root
+		void set_entry_points(const std::vector<std::wstring>& roots) { entry_points_ = roots; }
+		void push_entry_point(const std::wstring& root) { entry_points_.push_back(root); }
+		// index of count (from 0); the run prescans the whole project but parses and writes only its
+		// slice, the pages miss their dependency and referrer sections until merge_shards adds them
+		void set_shard(std::size_t index, std::size_t count) {
+			shard_count_ = count > 0 ? count : 1;
+			shard_index_ = index % shard_count_;
+		}
+		// construct_file_tree only indexes the project and reads the script declarations; gen_docs then
+		// parses and writes the most recently modified files first, each followed by what it
+		// references, until budget has passed since construct_file_tree began. files cut off mid
+		// parse get no page, the pages of earlier runs stay, and what is missing is listed in
+		// docs/.skipped.txt. 0 turns the budget off
+		void set_budget(std::chrono::milliseconds budget) { budget_ = budget; }
+		// pages and .obsidian/graph.json go into one tar or zip file at path, below a "docs/" folder,
+		// rendered and compressed in parallel and written in a fixed order; an empty path writes the
+		// docs folder again
+		void set_archive(const std::filesystem::path& path, archive_format format) {
+			archive_path_ = path;
+			archive_format_ = format;
+		}
+
+		// index_files + parse_files (parse_links when streaming, parse_reachable when reachable only,
+		// parse_shard when sharded, the script declarations only with a budget) + resolve_references
 		void construct_file_tree();
+		void index_files();
+		[[nodiscard]] bool parse_files();
+		// headers and external resources only
+		[[nodiscard]] bool parse_links();
+		// headers, then the links of what the entry points reach, then the bodies of those files
+		// (left to gen_docs when streaming)
+		[[nodiscard]] bool parse_reachable();
+		// headers and class names of every file, links and bodies of the shard's slice only
+		[[nodiscard]] bool parse_shard();
+		void resolve_references();
 		void gen_docs();
+		// after the docs folders of all shards were copied into <root>/docs: reads their partial
+		// indexes, rebuilds the reference graph and appends the sections that need it to every page;
+		// the result is what a single run writes
+		[[nodiscard]] bool merge_shards();
+
+		[[nodiscard]] const std::filesystem::path& get_path() const { return path_; }
+		[[nodiscard]] const std::vector<std::shared_ptr<file>>& get_files() const { return files_; }
+
+		[[nodiscard]] std::shared_ptr<file> get_file(std::size_t id) const;
+		[[nodiscard]] const path_resolver& get_path_resolver() const { return paths_; }
+		[[nodiscard]] const ref_index& get_ref_index() const { return ref_index_; }
+		[[nodiscard]] const dependency_closure& get_dependency_closure() const { return closure_; }
+		[[nodiscard]] const class_registry& get_class_registry() const { return classes_; }
+		[[nodiscard]] std::vector<std::shared_ptr<file>> get_referrers(const file& f) const;
 
 	private:
 		[[nodiscard]] bool is_ignored(const std::filesystem::path& path) const;
+		void push_file(const std::shared_ptr<file>& f);
+		[[nodiscard]] bool parse_headers();
+		// scene and resource bodies, with their links unless a links pass already read them
+		[[nodiscard]] bool parse_contents(bool links);
+		[[nodiscard]] bool parse_link_pass();
+		[[nodiscard]] bool parse_script_declarations();
+		// parses links level by level from the entry points, then drops every file not reached
+		[[nodiscard]] bool walk_entry_points();
+		[[nodiscard]] std::size_t resolve_entry_point(std::wstring_view root) const;
+		// a text scene big enough for the parser to cut its body into chunks
+		[[nodiscard]] bool has_split_scene() const;
+		[[nodiscard]] thread_pool* split_pool() const { return pool_ ? pool_ : split_pool_.get(); }
 		
-		void write_named_file_link(std::wofstream& out, const std::filesystem::path& docs_path,
-			const std::filesystem::path& file_path) const;
-		void write_tres_resource(std::wofstream& out, const std::weak_ptr<resource_file>& file,
-			const std::filesystem::path& docs_path) const;
-		void write_tres_resource_(std::wofstream& out, const std::filesystem::path& docs_path,
-			const resource_file::resource& res, bool sub_res = false) const;
+		// every page in parallel, each parsed first when streaming; page i is archive entry i
+		void stream_pages(const std::filesystem::path& docs_path);
+		void write_archive();
+		// the newest files and their references in rounds until the deadline, see set_budget
+		void write_budgeted(const std::filesystem::path& docs_path);
+		[[nodiscard]] bool in_slice(std::size_t id) const { return id % shard_count_ == shard_index_; }
+		[[nodiscard]] bool budgeted() const { return budget_.count() > 0; }
+		// the reference graph covers every file, pages get their dependency and referrer sections
+		[[nodiscard]] bool whole_graph() const { return shard_count_ <= 1 && !budgeted(); }
+		// the pages and forward edges of this shard, for merge_shards
+		void write_shard_index(const std::filesystem::path& docs_path) const;
+
+		// page into a file below docs_path mirroring the page's source, or into the archive as
+		// entry sequence when writing one
+		void write_page(const std::filesystem::path& docs_path, const file& f, const markdown_buffer& page, std::size_t sequence) const;
+		void write_scene_page(const std::filesystem::path& docs_path, scene_file& file, std::size_t sequence = 0) const;
+		void write_resource_page(const std::filesystem::path& docs_path, const resource_file& file, std::size_t sequence = 0) const;
+		void write_script_page(const std::filesystem::path& docs_path, const script_file& file, std::size_t sequence = 0) const;
+		void write_named_file_link(markdown_buffer& out, const std::filesystem::path& file_path) const;
+		void write_file_link(markdown_buffer& out, const std::filesystem::path& file_path, std::wstring_view label) const;
+		// a type annotation with every registered class name in it linked to its script
+		void write_type(markdown_buffer& out, std::wstring_view type) const;
+		// the nodes node brings in through its instanced scene, indent tabs deep; from is the scene
+		// node belongs to
+		void write_expanded_instance(markdown_buffer& out, std::size_t from,
+			const node_tree::tree_node& node, std::size_t indent, std::size_t depth) const;
+		[[nodiscard]] std::shared_ptr<const std::wstring> expanded_subtree(const std::shared_ptr<scene_file>& scene, std::size_t depth) const;
+		void write_inheritance(markdown_buffer& out, const script_file& file) const;
+		void write_tres_resource(markdown_buffer& out, const resource_file& file) const;
+		void write_tres_resource_(markdown_buffer& out, const resource_file::resource& res, bool sub_res = false) const;
+		void write_dependencies(markdown_buffer& out, const file& f) const;
+		void write_referrers(markdown_buffer& out, const file& f) const;
 	};
 
 	namespace util {
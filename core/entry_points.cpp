@@ -0,0 +1,79 @@
+#include "entry_points.hpp"
+
+#include <fstream>
+#include <string_view>
+
+#include "log.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		std::string_view trim(std::string_view s) {
+			const auto first = s.find_first_not_of(" \t\r");
+			if (first == std::string_view::npos) return {};
+			const auto last = s.find_last_not_of(" \t\r");
+			return s.substr(first, last - first + 1);
+		}
+
+		// "\"*res://a.gd\"" -> "res://a.gd"
+		std::string_view unquote(std::string_view value) {
+			if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+				value = value.substr(1, value.size() - 2);
+			}
+			if (!value.empty() && value.front() == '*') {
+				value.remove_prefix(1);
+			}
+			return value;
+		}
+
+	} // namespace
+
+	std::vector<std::wstring> read_entry_points(const std::filesystem::path& project_file) {
+		std::vector<std::wstring> res;
+		std::ifstream in(project_file, std::ios::in | std::ios::binary);
+		if (!in.is_open()) {
+			DOCS_GEN_LOG_WARNING(index, "could not open project file: ", project_file);
+			return res;
+		}
+
+		std::wstring main_scene;
+		std::vector<std::wstring> autoloads;
+		std::string section;
+		std::string line;
+		while (std::getline(in, line)) {
+			const auto l = trim(line);
+			if (l.empty() || l.front() == ';')
+				continue;
+			if (l.front() == '[') {
+				section = std::string(l);
+				continue;
+			}
+
+			const auto eq = l.find('=');
+			if (eq == std::string_view::npos)
+				continue;
+			const auto key = trim(l.substr(0, eq));
+			const auto value = unquote(trim(l.substr(eq + 1)));
+			if (value.empty())
+				continue;
+
+			// widened byte by byte, the same way the parsers read res:// paths
+			if (section == "[application]" && key == "run/main_scene") {
+				main_scene.assign(value.begin(), value.end());
+			}
+			else if (section == "[autoload]") {
+				autoloads.emplace_back(value.begin(), value.end());
+			}
+		}
+
+		if (!main_scene.empty()) {
+			res.push_back(std::move(main_scene));
+		}
+		for (auto& a : autoloads) {
+			res.push_back(std::move(a));
+		}
+		return res;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,19 @@
+#ifndef DOCS_GEN_ENTRY_POINTS_H
+#define DOCS_GEN_ENTRY_POINTS_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// where a Godot project starts, as project.godot lists it: run/main_scene first, then every
+	// [autoload] entry in file order
+	//
+	// values come back as written, "res://..." or "uid://...", with the '*' that marks an autoload
+	// singleton dropped; empty when the file is missing or names nothing
+	[[nodiscard]] std::vector<std::wstring> read_entry_points(const std::filesystem::path& project_file);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_ENTRY_POINTS_H
@@ -1,6 +1,6 @@
 #include "file.hpp"
 
-#include <iostream>
+#include "log.hpp"
 
 namespace docs_gen_core {
 
@@ -11,11 +11,11 @@ namespace docs_gen_core {
 	}
 
 	file::file(const file& other)
-		: path_(other.path_), title_(other.title_) {
+		: path_(other.path_), title_(other.title_), id_(other.id_) {
 	}
 
 	file::file(file&& other) noexcept
-		: path_(std::move(other.path_)), title_(std::move(other.title_)) {
+		: path_(std::move(other.path_)), title_(std::move(other.title_)), id_(other.id_) {
 	}
 
 	script_file::script_file(const std::filesystem::path& path)
@@ -77,40 +77,33 @@ namespace docs_gen_core {
 	}
 
 	void dott_file::push_packed_scene(const std::wstring& key, const std::shared_ptr<scene_file>& child) {
-		if (packed_scenes_.find(key) != packed_scenes_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource PackedScene ";
-			std::wcerr << packed_scenes_[key]->get_path();
-			std::cerr << '\n';
-#endif
+		if (const auto* old = packed_scenes_.find(key)) {
+			DOCS_GEN_LOG_WARNING(parse, "overwriting external resource PackedScene ", (*old)->get_path());
 		}
 		
-		packed_scenes_[key] = child;
+		packed_scenes_.insert_or_assign(key, child);
 	}
 
 	void dott_file::push_ext_resource(const std::wstring& key, const std::shared_ptr<resource_file>& resource) {
-		if (ext_resources_.find(key) != ext_resources_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource Resource ";
-			std::wcerr << ext_resources_[key];
-			std::cerr << '\n';
-#endif
+		if (const auto* old = ext_resources_.find(key)) {
+			DOCS_GEN_LOG_WARNING(parse, "overwriting external resource Resource ", (*old)->get_path());
 		}
 		
-		ext_resources_[key] = resource;
+		ext_resources_.insert_or_assign(key, resource);
 	}
 
 	void dott_file::push_ext_resource_other(const std::wstring& key, const ext_resource_other& resource) {
-		if (ext_resources_other_.find(key) != ext_resources_other_.end()) {
-			const auto& res = ext_resources_other_[key];
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource ";
-			std::wcerr << res.type << ' ' << res.name;
-			std::cerr << '\n';
-#endif
+		if (const auto* res = ext_resources_other_.find(key)) {
+			DOCS_GEN_LOG_WARNING(parse, "overwriting external resource ", res->type, ' ', res->name);
 		}
 		
-		ext_resources_other_[key] = resource;
+		ext_resources_other_.insert_or_assign(key, resource);
+	}
+
+	void dott_file::freeze_links() {
+		packed_scenes_.freeze();
+		ext_resources_.freeze();
+		ext_resources_other_.freeze();
 	}
 
 	resource_file::resource_file(const std::filesystem::path& path)
@@ -122,7 +115,7 @@ namespace docs_gen_core {
 	}
 
 	resource_file::resource_file(resource_file&& other) noexcept
-		: uid_(std::move(other.uid_)) {
+		: uid_(other.uid_) {
 		path_ = std::move(other.path_);
 		title_ = std::move(other.title_);
 		packed_scenes_ = std::move(other.packed_scenes_);
@@ -150,29 +143,31 @@ namespace docs_gen_core {
 	}
 
 	void resource_file::push_script(const std::wstring& key, const std::shared_ptr<script_file>& s) {
-		if (scripts_.find(key) != scripts_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource Script ";
-			std::wcerr << scripts_[key]->get_path();
-			std::cerr << '\n';
-#endif
+		if (const auto* old = scripts_.find(key)) {
+			DOCS_GEN_LOG_WARNING(parse, "overwriting external resource Script ", (*old)->get_path());
 		}
 		
-		scripts_[key] = s;
+		scripts_.insert_or_assign(key, s);
+	}
+
+	void resource_file::freeze_links() {
+		dott_file::freeze_links();
+		scripts_.freeze();
 	}
 
 	void resource_file::push_sub_resource(const std::wstring& key, const std::shared_ptr<resource>& resource) {
 		if (sub_resources_.find(key) != sub_resources_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting sub_resource ";
-			std::wcerr << resource->type;
-			std::cerr << '\n';
-#endif
+			DOCS_GEN_LOG_WARNING(parse, "overwriting sub_resource ", resource->type);
 		}
 		
 		sub_resources_[key] = resource;
 	}
 
+	void resource_file::release_contents() {
+		sub_resources_.clear();
+		resource_ = {};
+	}
+
 	scene_file::scene_file(const std::filesystem::path& path)
 		: dott_file(path) {
 	}
@@ -182,7 +177,7 @@ namespace docs_gen_core {
 	}
 
 	scene_file::scene_file(scene_file&& other) noexcept
-		: uid_(std::move(other.uid_)), node_tree_(std::move(other.node_tree_)) {
+		: uid_(other.uid_), node_tree_(std::move(other.node_tree_)) {
 		path_ = std::move(other.path_);
 		title_ = std::move(other.title_);
 		packed_scenes_ = std::move(other.packed_scenes_);
@@ -207,21 +202,22 @@ namespace docs_gen_core {
 		packed_scenes_ = std::move(other.packed_scenes_);
 		ext_resources_ = std::move(other.ext_resources_);
 		scripts_ = std::move(other.scripts_);
-		uid_ = std::move(other.uid_);
+		uid_ = other.uid_;
 		node_tree_ = std::move(other.node_tree_);
 		return *this;
 	}
 
 	void scene_file::push_script(const std::wstring& key, const std::shared_ptr<script_file>& script) {
-		if (scripts_.find(key) != scripts_.end()) {
-#ifndef RELEASE
-			std::cerr << "[WARNING] overwriting external resource Script ";
-			std::wcerr << scripts_[key]->get_path();
-			std::cerr << '\n';
-#endif
+		if (const auto* old = scripts_.find(key)) {
+			DOCS_GEN_LOG_WARNING(parse, "overwriting external resource Script ", (*old)->get_path());
 		}
 		
-		scripts_[key] = script;
+		scripts_.insert_or_assign(key, script);
+	}
+
+	void scene_file::freeze_links() {
+		dott_file::freeze_links();
+		scripts_.freeze();
 	}
 	
 } // docs_gen_core
@@ -1,20 +1,35 @@
 #ifndef DOCS_GEN_FILE_H
 #define DOCS_GEN_FILE_H
 
+#include <cstdint>
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
+#include "link_table.hpp"
 #include "node.hpp"
+#include "uid.hpp"
 
 namespace docs_gen_core {
 
+	enum class file_kind : std::uint8_t {
+		other,
+		script,
+		scene,
+		resource
+	};
+
 	class file {
+	public:
+		static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
 	protected:
 		std::filesystem::path path_;
 		std::wstring title_;
+		std::size_t id_ = npos;
 
 		file() = default;
 		explicit file(const std::filesystem::path& path);
@@ -28,6 +43,9 @@ namespace docs_gen_core {
 		
 		[[nodiscard]] const std::filesystem::path& get_path() const { return path_; }
 		[[nodiscard]] const std::wstring& get_title() const { return title_; }
+		[[nodiscard]] virtual file_kind get_kind() const { return file_kind::other; }
+		[[nodiscard]] std::size_t get_id() const { return id_; }
+		void set_id(std::size_t id) { id_ = id; }
 	};
 
 	struct script_class {
@@ -74,6 +92,9 @@ namespace docs_gen_core {
 		void set_script_class(const script_class& c) { class_ = c; }
 		void set_script_class(script_class&& c) { class_ = std::move(c); }
 		[[nodiscard]] const script_class& get_script_class() const { return class_; }
+		// frees the parsed declarations once the page is written, see dir::set_streaming
+		void release_contents() { class_ = {}; }
+		[[nodiscard]] file_kind get_kind() const override { return file_kind::script; }
 	};
 
 	class scene_file;
@@ -96,9 +117,9 @@ namespace docs_gen_core {
 
 	class dott_file : public file {
 	protected:
-		std::unordered_map<std::wstring, std::shared_ptr<scene_file>> packed_scenes_;
-		std::unordered_map<std::wstring, std::shared_ptr<resource_file>> ext_resources_;
-		std::unordered_map<std::wstring, ext_resource_other> ext_resources_other_;
+		link_table<std::shared_ptr<scene_file>> packed_scenes_;
+		link_table<std::shared_ptr<resource_file>> ext_resources_;
+		link_table<ext_resource_other> ext_resources_other_;
 
 		dott_file() = default;
 		explicit dott_file(const std::filesystem::path& path);
@@ -113,13 +134,12 @@ namespace docs_gen_core {
 		void push_packed_scene(const std::wstring& key, const std::shared_ptr<scene_file>& child);
 		void push_ext_resource(const std::wstring& key, const std::shared_ptr<resource_file>& resource);
 		void push_ext_resource_other(const std::wstring& key, const ext_resource_other& resource);
+		// called by the parser once the links pass is done, the tables are read only from then on
+		virtual void freeze_links();
 
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& get_packed_scenes() const { return packed_scenes_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& get_packed_scenes() { return packed_scenes_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& get_ext_resources() const { return ext_resources_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& get_ext_resources() { return ext_resources_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, ext_resource_other>& get_ext_resource_other() const { return ext_resources_other_; }
-		[[nodiscard]] std::unordered_map<std::wstring, ext_resource_other>& get_ext_resource_other() { return ext_resources_other_; }
+		[[nodiscard]] const link_table<std::shared_ptr<scene_file>>& get_packed_scenes() const { return packed_scenes_; }
+		[[nodiscard]] const link_table<std::shared_ptr<resource_file>>& get_ext_resources() const { return ext_resources_; }
+		[[nodiscard]] const link_table<ext_resource_other>& get_ext_resource_other() const { return ext_resources_other_; }
 	};
 
 	class resource_file final : public dott_file {
@@ -127,6 +147,7 @@ namespace docs_gen_core {
 		struct resource {
 			struct field {
 				std::wstring name;
+				// a summary when the value was too large to keep, see parse_options::max_value_bytes
 				std::wstring value;
 			};
 			struct sub_res_field {
@@ -146,9 +167,9 @@ namespace docs_gen_core {
 		};
 
 	private:
-		std::wstring uid_;
+		std::uint64_t uid_ = invalid_uid;
 		std::wstring script_class_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> scripts_;
+		link_table<std::shared_ptr<script_file>> scripts_;
 
 		std::unordered_map<std::wstring, std::shared_ptr<resource>> sub_resources_;
 		resource resource_;
@@ -163,22 +184,27 @@ namespace docs_gen_core {
 		resource_file& operator=(const resource_file& other);
 		resource_file& operator=(resource_file&& other) noexcept;
 
-		void set_uid(const std::wstring& s) { uid_ = s; }
+		void set_uid(std::uint64_t uid) { uid_ = uid; }
 		void set_script_class(const std::wstring& s) { script_class_ = s; }
 		void push_script(const std::wstring& key, const std::shared_ptr<script_file>& s);
 		void push_sub_resource(const std::wstring& key, const std::shared_ptr<resource>& resource);
+		void freeze_links() override;
 		void set_resource(const resource& resource) { resource_ = resource; }
+		void set_resource(resource&& resource) { resource_ = std::move(resource); }
 
-		[[nodiscard]] const std::wstring& get_uid() const { return uid_; }
+		[[nodiscard]] std::uint64_t get_uid() const { return uid_; }
 		[[nodiscard]] const std::wstring& get_script_class() const { return script_class_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
+		[[nodiscard]] const link_table<std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
 		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<resource>>& get_sub_resources() const { return sub_resources_; }
 		[[nodiscard]] const resource& get_resource() const { return resource_; }
+		[[nodiscard]] file_kind get_kind() const override { return file_kind::resource; }
+		// frees the properties and sub_resources, the external resources (the edges) stay
+		void release_contents();
 	};
 
 	class scene_file final : public dott_file {
-		std::wstring uid_;
-		std::unordered_map<std::wstring, std::shared_ptr<script_file>> scripts_;
+		std::uint64_t uid_ = invalid_uid;
+		link_table<std::shared_ptr<script_file>> scripts_;
 		node_tree node_tree_;
 
 	public:
@@ -191,19 +217,22 @@ namespace docs_gen_core {
 		scene_file& operator=(const scene_file& other);
 		scene_file& operator=(scene_file&& other) noexcept;
 
-		void set_uid(const std::wstring& s) { uid_ = s; }
+		void set_uid(std::uint64_t uid) { uid_ = uid; }
 		void push_script(const std::wstring& key, const std::shared_ptr<script_file>& script);
+		void freeze_links() override;
 
-		[[nodiscard]] const std::wstring& get_uid() const { return uid_; }
-		[[nodiscard]] const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
-		[[nodiscard]] std::unordered_map<std::wstring, std::shared_ptr<script_file>>& get_scripts() { return scripts_; }
+		[[nodiscard]] std::uint64_t get_uid() const { return uid_; }
+		[[nodiscard]] const link_table<std::shared_ptr<script_file>>& get_scripts() const { return scripts_; }
 		[[nodiscard]] const node_tree& get_node_tree() const { return node_tree_; }
 		[[nodiscard]] node_tree& get_node_tree() { return node_tree_; }
+		// frees the node tree, the external resources (the edges) stay
+		void release_contents() { node_tree_ = {}; }
+		[[nodiscard]] file_kind get_kind() const override { return file_kind::scene; }
 	};
 
 	struct scene_file_hash {
-		bool operator()(const std::shared_ptr<scene_file>& f) const noexcept {
-			return std::hash<std::wstring>{}(f->get_uid());
+		std::size_t operator()(const std::shared_ptr<scene_file>& f) const noexcept {
+			return static_cast<std::size_t>(hash_uid(f->get_uid()));
 		}
 	};
 
@@ -0,0 +1,151 @@
+#ifndef DOCS_GEN_LINK_TABLE_H
+#define DOCS_GEN_LINK_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// ext_resource id -> T for the links of one file, filled by the links pass and frozen after it
+	//
+	// values sit in one array in the order they were declared in the file, keys back to back in one
+	// buffer, and lookups go through an open addressing table of {hash, index} slots. once frozen
+	// the table is never written again, so the body parse and every page writer read it from any
+	// thread without locking; there is no erase
+	template <typename T>
+	class link_table {
+		struct slot {
+			std::uint64_t hash;
+			std::uint32_t index;
+		};
+
+		struct key_span {
+			std::uint32_t offset;
+			std::uint32_t size;
+		};
+
+		static constexpr std::uint32_t no_index = static_cast<std::uint32_t>(-1);
+
+		std::vector<slot> slots_;
+		std::vector<key_span> key_spans_;
+		std::wstring keys_;
+		std::vector<T> values_;
+		bool frozen_ = false;
+
+	public:
+		class const_iterator {
+			const link_table* table_;
+			std::size_t i_;
+
+		public:
+			const_iterator(const link_table* table, std::size_t i) : table_(table), i_(i) {}
+
+			const_iterator& operator++() {
+				++i_;
+				return *this;
+			}
+			bool operator==(const const_iterator& other) const { return i_ == other.i_; }
+			bool operator!=(const const_iterator& other) const { return i_ != other.i_; }
+			std::pair<std::wstring_view, const T&> operator*() const { return { table_->key_at(i_), table_->values_[i_] }; }
+		};
+
+		link_table() = default;
+
+		void clear() {
+			slots_.clear();
+			key_spans_.clear();
+			keys_.clear();
+			values_.clear();
+			frozen_ = false;
+		}
+
+		// returns false if the key was already present and got overwritten, or the table is frozen;
+		// an overwritten value keeps its place in the declaration order
+		bool insert_or_assign(std::wstring_view key, const T& value) {
+			if (frozen_) return false;
+			if ((values_.size() + 1) * 2 > slots_.size()) rehash(slots_.empty() ? 8 : slots_.size() * 2);
+
+			const auto h = hash_key(key);
+			auto& s = slots_[probe(key, h)];
+			if (s.index != no_index) {
+				values_[s.index] = value;
+				return false;
+			}
+
+			s = { h, static_cast<std::uint32_t>(values_.size()) };
+			key_spans_.push_back({ static_cast<std::uint32_t>(keys_.size()), static_cast<std::uint32_t>(key.size()) });
+			keys_.append(key);
+			values_.push_back(value);
+			return true;
+		}
+
+		// drops the growth slack and makes the table read only
+		void freeze() {
+			if (frozen_) return;
+			std::size_t capacity = 8;
+			while (capacity < values_.size() * 2) capacity <<= 1;
+			if (capacity < slots_.size()) rehash(capacity);
+			slots_.shrink_to_fit();
+			key_spans_.shrink_to_fit();
+			keys_.shrink_to_fit();
+			values_.shrink_to_fit();
+			frozen_ = true;
+		}
+
+		[[nodiscard]] const T* find(std::wstring_view key) const {
+			if (slots_.empty()) return nullptr;
+			const auto& s = slots_[probe(key, hash_key(key))];
+			return s.index == no_index ? nullptr : &values_[s.index];
+		}
+
+		[[nodiscard]] bool contains(std::wstring_view key) const { return find(key) != nullptr; }
+		[[nodiscard]] bool frozen() const { return frozen_; }
+		[[nodiscard]] std::size_t size() const { return values_.size(); }
+		[[nodiscard]] bool empty() const { return values_.empty(); }
+
+		[[nodiscard]] const_iterator begin() const { return { this, 0 }; }
+		[[nodiscard]] const_iterator end() const { return { this, values_.size() }; }
+
+	private:
+		// fnv-1a over the code units, ids are short ("1_k3v8x", "12")
+		[[nodiscard]] static std::uint64_t hash_key(std::wstring_view key) {
+			std::uint64_t h = 14695981039346656037ull;
+			for (const auto c : key) {
+				h ^= static_cast<std::uint64_t>(c);
+				h *= 1099511628211ull;
+			}
+			return h;
+		}
+
+		[[nodiscard]] std::wstring_view key_at(std::size_t i) const {
+			return { keys_.data() + key_spans_[i].offset, key_spans_[i].size };
+		}
+
+		// slot holding key, or the empty slot where it would go
+		[[nodiscard]] std::size_t probe(std::wstring_view key, std::uint64_t h) const {
+			const auto mask = slots_.size() - 1;
+			auto i = static_cast<std::size_t>(h) & mask;
+			while (slots_[i].index != no_index && (slots_[i].hash != h || key_at(slots_[i].index) != key)) {
+				i = (i + 1) & mask;
+			}
+			return i;
+		}
+
+		void rehash(std::size_t capacity) {
+			slots_.assign(capacity, { 0, no_index });
+			const auto mask = capacity - 1;
+			for (std::uint32_t index = 0; index < values_.size(); ++index) {
+				const auto h = hash_key(key_at(index));
+				auto i = static_cast<std::size_t>(h) & mask;
+				while (slots_[i].index != no_index) i = (i + 1) & mask;
+				slots_[i] = { h, index };
+			}
+		}
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_LINK_TABLE_H
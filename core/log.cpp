@@ -0,0 +1,267 @@
+#include "log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace docs_gen_core::logging {
+
+	namespace {
+
+		struct message {
+			std::uint64_t seq;
+			level lvl;
+			category cat;
+			std::string text;
+		};
+
+		// single producer (the owning thread), single consumer (whoever holds sink::drain_mutex)
+		class ring {
+			static constexpr std::size_t capacity = 1024;
+
+			std::array<message, capacity> slots_;
+			std::atomic<std::size_t> head_{ 0 };
+			std::atomic<std::size_t> tail_{ 0 };
+
+		public:
+			bool try_push(message& m) {
+				const auto head = head_.load(std::memory_order_relaxed);
+				if (head - tail_.load(std::memory_order_acquire) == capacity)
+					return false;
+
+				slots_[head % capacity] = std::move(m);
+				head_.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			template <typename F>
+			void drain(F&& f) {
+				const auto head = head_.load(std::memory_order_acquire);
+				auto tail = tail_.load(std::memory_order_relaxed);
+				for (; tail != head; ++tail) {
+					f(std::move(slots_[tail % capacity]));
+				}
+				tail_.store(tail, std::memory_order_release);
+			}
+		};
+
+		void default_sink(level lvl, category cat, std::string_view text) {
+			auto& out = lvl >= level::warning ? std::cerr : std::cout;
+			out << '[' << to_string(lvl) << ']';
+			if (cat != category::general) {
+				out << '[' << to_string(cat) << ']';
+			}
+			out << ' ' << text << '\n';
+		}
+
+		class sink {
+			std::mutex rings_mutex_;
+			// rings of the threads logging now, drained in turn
+			std::vector<std::unique_ptr<ring>> rings_;
+			// rings of finished threads, empty and handed to the next thread that logs
+			std::vector<std::unique_ptr<ring>> free_rings_;
+
+			std::mutex drain_mutex_;
+			std::vector<message> batch_;
+			std::atomic<sink_fn> sink_{ &default_sink };
+
+			std::mutex wake_mutex_;
+			std::condition_variable wake_;
+			bool stop_ = false;
+			std::thread thread_;
+
+		public:
+			std::atomic<std::uint64_t> seq{ 0 };
+
+			sink() : thread_([this] { run(); }) {}
+
+			~sink() {
+				{
+					std::lock_guard lock{ wake_mutex_ };
+					stop_ = true;
+				}
+				wake_.notify_one();
+				thread_.join();
+				drain();
+			}
+
+			ring& local_ring() {
+				// hands the ring back when the thread ends, so short-lived threads do not leave
+				// rings behind for drain() to walk
+				struct lease {
+					sink& owner;
+					ring* r = nullptr;
+					~lease() {
+						if (r) owner.release(r);
+					}
+				};
+
+				thread_local lease l{ *this };
+				if (!l.r)
+					l.r = acquire();
+				return *l.r;
+			}
+
+			void wake() { wake_.notify_one(); }
+			void set(sink_fn fn) { sink_.store(fn ? fn : &default_sink); }
+
+			void drain() {
+				std::lock_guard lock{ drain_mutex_ };
+				{
+					std::lock_guard rings_lock{ rings_mutex_ };
+					for (auto& r : rings_) {
+						r->drain([this](message&& m) { batch_.push_back(std::move(m)); });
+					}
+				}
+				if (batch_.empty())
+					return;
+
+				std::sort(batch_.begin(), batch_.end(), [](const message& a, const message& b) { return a.seq < b.seq; });
+				const auto fn = sink_.load();
+				for (const auto& m : batch_) {
+					fn(m.lvl, m.cat, m.text);
+				}
+				batch_.clear();
+				std::cout.flush();
+			}
+
+		private:
+			ring* acquire() {
+				std::lock_guard lock{ rings_mutex_ };
+				if (free_rings_.empty()) {
+					rings_.push_back(std::make_unique<ring>());
+				}
+				else {
+					rings_.push_back(std::move(free_rings_.back()));
+					free_rings_.pop_back();
+				}
+				return rings_.back().get();
+			}
+
+			// the owning thread is done pushing, so the ring is empty once drained
+			void release(ring* r) {
+				drain();
+				std::lock_guard lock{ rings_mutex_ };
+				const auto it = std::find_if(rings_.begin(), rings_.end(), [r](const auto& p) { return p.get() == r; });
+				if (it == rings_.end())
+					return;
+				free_rings_.push_back(std::move(*it));
+				rings_.erase(it);
+			}
+
+			void run() {
+				std::unique_lock lock{ wake_mutex_ };
+				while (!stop_) {
+					lock.unlock();
+					drain();
+					lock.lock();
+					wake_.wait_for(lock, std::chrono::milliseconds(2));
+				}
+			}
+		};
+
+		sink& get_sink() {
+			static sink s;
+			return s;
+		}
+
+	} // namespace
+
+	namespace detail {
+
+#ifdef RELEASE
+		std::atomic<level> min_level{ level::info };
+#else
+		std::atomic<level> min_level{ level::debug };
+#endif
+
+		void push(level lvl, category cat, std::string&& text) {
+			auto& s = get_sink();
+			message m{ s.seq.fetch_add(1, std::memory_order_relaxed), lvl, cat, std::move(text) };
+			auto& r = s.local_ring();
+			while (!r.try_push(m)) {
+				// the sink is behind, give it the cpu instead of dropping diagnostics
+				s.wake();
+				std::this_thread::yield();
+			}
+		}
+
+		void append(std::string& out, const wchar_t* s) {
+			append(out, std::wstring_view{ s });
+		}
+
+		void append(std::string& out, std::wstring_view s) {
+			out.reserve(out.size() + s.size());
+			for (auto c : s) {
+				out += c < 0x100 ? static_cast<char>(c) : '?';
+			}
+		}
+
+		void append(std::string& out, const std::filesystem::path& p) {
+			out += '"';
+			out += p.u8string();
+			out += '"';
+		}
+
+	} // detail
+
+	void set_level(level lvl) {
+		detail::min_level.store(lvl, std::memory_order_relaxed);
+	}
+
+	level get_level() {
+		return detail::min_level.load(std::memory_order_relaxed);
+	}
+
+	bool parse_level(std::string_view s, level& out) {
+		for (auto l : { level::trace, level::debug, level::info, level::warning, level::error, level::off }) {
+			std::string name = to_string(l);
+			std::transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(c - 'A' + 'a'); });
+			if (s == name) {
+				out = l;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void set_sink(sink_fn fn) {
+		auto& s = get_sink();
+		s.drain();
+		s.set(fn);
+	}
+
+	void flush() {
+		get_sink().drain();
+	}
+
+	const char* to_string(level lvl) {
+		switch (lvl) {
+		case level::trace: return "TRACE";
+		case level::debug: return "DEBUG";
+		case level::info: return "INFO";
+		case level::warning: return "WARNING";
+		case level::error: return "ERROR";
+		case level::off: return "OFF";
+		}
+		return "";
+	}
+
+	const char* to_string(category cat) {
+		switch (cat) {
+		case category::general: return "general";
+		case category::index: return "index";
+		case category::parse: return "parse";
+		case category::link: return "link";
+		case category::docs: return "docs";
+		}
+		return "";
+	}
+
+} // docs_gen_core::logging
@@ -0,0 +1,116 @@
+#ifndef DOCS_GEN_LOG_H
+#define DOCS_GEN_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// leveled, categorized logging
+//
+// messages below DOCS_GEN_LOG_LEVEL are compiled out, the rest are filtered by the runtime level,
+// formatted on the calling thread and pushed into that thread's ring buffer; a background sink
+// drains the rings, so logging never writes to a stream on the hot path
+//
+// the sink sorts by message order only within one drained batch: a message still on its way into
+// a ring while a batch is collected goes out with the next one, after any later messages of other
+// threads that made it into the first; flush() before reading output that must be complete
+//
+// the floor is set once for the whole workspace in premake5.lua, so every project sees the same
+// value; 0 keeps every level
+#ifndef DOCS_GEN_LOG_LEVEL
+#define DOCS_GEN_LOG_LEVEL 0
+#endif
+
+namespace docs_gen_core::logging {
+
+	enum class level : std::uint8_t {
+		trace,
+		debug,
+		info,
+		warning,
+		error,
+		off
+	};
+
+	enum class category : std::uint8_t {
+		general,
+		index,
+		parse,
+		link,
+		docs
+	};
+
+	// called from the sink thread only, one message at a time
+	using sink_fn = void(*)(level lvl, category cat, std::string_view message);
+
+	namespace detail {
+		extern std::atomic<level> min_level;
+
+		void push(level lvl, category cat, std::string&& message);
+
+		inline void append(std::string& out, const char* s) { out += s; }
+		inline void append(std::string& out, const std::string& s) { out += s; }
+		inline void append(std::string& out, std::string_view s) { out += s; }
+		inline void append(std::string& out, char c) { out += c; }
+		void append(std::string& out, const wchar_t* s);
+		void append(std::string& out, std::wstring_view s);
+		inline void append(std::string& out, const std::wstring& s) { append(out, std::wstring_view{ s }); }
+		inline void append(std::string& out, wchar_t c) { append(out, std::wstring_view{ &c, 1 }); }
+		void append(std::string& out, const std::filesystem::path& p);
+
+		template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0>
+		void append(std::string& out, T v) { out += std::to_string(v); }
+
+		template <typename... Args>
+		void write(level lvl, category cat, const Args&... args) {
+			std::string message;
+			(append(message, args), ...);
+			push(lvl, cat, std::move(message));
+		}
+	} // detail
+
+	// false for the levels DOCS_GEN_LOG_LEVEL compiles out; compared through a named constant, the
+	// literal 0 against an unsigned level warns with -Wtype-limits
+	[[nodiscard]] constexpr bool is_compiled_in(level lvl) {
+		constexpr int min_compiled = DOCS_GEN_LOG_LEVEL;
+		return static_cast<int>(lvl) >= min_compiled;
+	}
+
+	[[nodiscard]] inline bool is_enabled(level lvl) {
+		return lvl >= detail::min_level.load(std::memory_order_relaxed);
+	}
+	void set_level(level lvl);
+	[[nodiscard]] level get_level();
+	// parses trace, debug, info, warning, error or off
+	[[nodiscard]] bool parse_level(std::string_view s, level& out);
+
+	// replaces the default sink (stdout for info and below, stderr for warnings and errors),
+	// nullptr restores it
+	void set_sink(sink_fn sink);
+	// blocks until every message pushed before the call has been handed to the sink
+	void flush();
+
+	[[nodiscard]] const char* to_string(level lvl);
+	[[nodiscard]] const char* to_string(category cat);
+
+} // docs_gen_core::logging
+
+#define DOCS_GEN_LOG(lvl, cat, ...) \
+	do { \
+		if constexpr (docs_gen_core::logging::is_compiled_in(docs_gen_core::logging::level::lvl)) { \
+			if (docs_gen_core::logging::is_enabled(docs_gen_core::logging::level::lvl)) \
+				docs_gen_core::logging::detail::write(docs_gen_core::logging::level::lvl, \
+					docs_gen_core::logging::category::cat, __VA_ARGS__); \
+		} \
+	} while (false)
+
+#define DOCS_GEN_LOG_TRACE(cat, ...) DOCS_GEN_LOG(trace, cat, __VA_ARGS__)
+#define DOCS_GEN_LOG_DEBUG(cat, ...) DOCS_GEN_LOG(debug, cat, __VA_ARGS__)
+#define DOCS_GEN_LOG_INFO(cat, ...) DOCS_GEN_LOG(info, cat, __VA_ARGS__)
+#define DOCS_GEN_LOG_WARNING(cat, ...) DOCS_GEN_LOG(warning, cat, __VA_ARGS__)
+#define DOCS_GEN_LOG_ERROR(cat, ...) DOCS_GEN_LOG(error, cat, __VA_ARGS__)
+
+#endif // DOCS_GEN_LOG_H
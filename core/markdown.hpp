@@ -0,0 +1,76 @@
+#ifndef DOCS_GEN_MARKDOWN_H
+#define DOCS_GEN_MARKDOWN_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace docs_gen_core {
+
+	// the text of one page, built in memory and written out in one go
+	//
+	// string literals are taken as arrays, so their length is part of their type and never counted
+	// by hand; append(parts...) adds up the sizes of all its parts first and grows the buffer at
+	// most once for them. parts are wide literals, single wide characters and anything that
+	// converts to std::wstring_view
+	class markdown_buffer {
+		std::wstring text_;
+
+	public:
+		markdown_buffer() = default;
+		explicit markdown_buffer(std::size_t capacity) { text_.reserve(capacity); }
+
+		template <typename... Parts>
+		markdown_buffer& append(const Parts&... parts) {
+			grow((size_of(parts) + ...));
+			(put(parts), ...);
+			return *this;
+		}
+
+		// list nesting
+		markdown_buffer& tabs(std::size_t n) {
+			text_.append(n, L'\t');
+			return *this;
+		}
+
+		template <typename Int, typename = std::enable_if_t<std::is_integral_v<Int>>>
+		markdown_buffer& number(Int n) {
+			char buf[24];
+			const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), n);
+			grow(static_cast<std::size_t>(end - buf));
+			text_.append(buf, end);
+			return *this;
+		}
+
+		void clear() { text_.clear(); }
+		void reserve(std::size_t capacity) { text_.reserve(capacity); }
+
+		[[nodiscard]] const std::wstring& str() const { return text_; }
+		[[nodiscard]] std::wstring take() { return std::move(text_); }
+		[[nodiscard]] std::size_t size() const { return text_.size(); }
+		[[nodiscard]] bool empty() const { return text_.empty(); }
+
+	private:
+		// at least doubles, whatever the standard library does on reserve
+		void grow(std::size_t extra) {
+			const auto need = text_.size() + extra;
+			if (need > text_.capacity()) text_.reserve(std::max(need, text_.capacity() * 2));
+		}
+
+		template <std::size_t N>
+		static constexpr std::size_t size_of(const wchar_t (&)[N]) { return N - 1; }
+		static constexpr std::size_t size_of(wchar_t) { return 1; }
+		static std::size_t size_of(std::wstring_view s) { return s.size(); }
+
+		template <std::size_t N>
+		void put(const wchar_t (&s)[N]) { text_.append(s, N - 1); }
+		void put(wchar_t c) { text_.push_back(c); }
+		void put(std::wstring_view s) { text_.append(s.data(), s.size()); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_MARKDOWN_H
@@ -1,9 +1,40 @@
 ﻿#include "node.hpp"
 
-#include <iostream>
+#include <algorithm>
+
+#include "log.hpp"
 
 namespace docs_gen_core {
 
+    namespace {
+
+        // the path below the root leading to node, "Character/Interact_Handler", is parent;
+        // compared name by name upwards so nothing gets built
+        bool has_path(const node_tree::tree_node* node, std::wstring_view parent) {
+            while (node && node->depth > 1) {
+                const auto slash = parent.rfind('/');
+                if (parent.substr(slash == std::wstring_view::npos ? 0 : slash + 1) != node->name)
+                    return false;
+                if (slash == std::wstring_view::npos)
+                    return node->depth == 2;
+
+                parent = parent.substr(0, slash);
+                // the tree owns every node, the raw pointer outlives the lock
+                node = node->parent.lock().get();
+            }
+            return false;
+        }
+
+        // names hold one byte per character, the utf-8 bytes the binary parser widens included, so
+        // they go into the path as those bytes; converting through the "C" locale throws above 0x7F
+        std::string name_bytes(const std::wstring& name) {
+            std::string bytes(name.size(), '\0');
+            std::transform(name.begin(), name.end(), bytes.begin(), [](wchar_t c) { return static_cast<char>(c); });
+            return bytes;
+        }
+
+    } // namespace
+
     node_tree::tree_node::tree_node(const std::wstring& name, const std::wstring& type)
         : name(name), type(type), depth(0), parent({}) {
     }
@@ -15,12 +46,13 @@ namespace docs_gen_core {
 
     node_tree::tree_node::tree_node(const tree_node& other)
         : name(other.name), type(other.type), path(other.path), depth(other.depth),
-        parent(other.parent), children(other.children) {
+        parent(other.parent), children(other.children), properties(other.properties), instance(other.instance) {
     }
 
     node_tree::tree_node::tree_node(tree_node&& other) noexcept
         : name(std::move(other.name)), type(std::move(other.type)), path(std::move(other.path)),
-        depth(other.depth), parent(std::move(other.parent)), children(std::move(other.children)) {
+        depth(other.depth), parent(std::move(other.parent)), children(std::move(other.children)),
+        properties(std::move(other.properties)), instance(std::move(other.instance)) {
      }
 
     node_tree::tree_node& node_tree::tree_node::operator=(const tree_node& other) {
@@ -30,6 +62,8 @@ namespace docs_gen_core {
         depth = other.depth;
         parent = other.parent;
         children = other.children;
+        properties = other.properties;
+        instance = other.instance;
         return *this;
     }
 
@@ -40,24 +74,28 @@ namespace docs_gen_core {
         depth = other.depth;
         parent = std::move(other.parent);
         children = std::move(other.children);
+        properties = std::move(other.properties);
+        instance = std::move(other.instance);
         return *this;
     }
 
     node_tree::node_tree(const node_tree& other)
-        : root_(other.root_) {
+        : root_(other.root_), last_(other.last_) {
     }
 
     node_tree::node_tree(node_tree&& other) noexcept
-        : root_(std::move(other.root_)) {
+        : root_(std::move(other.root_)), last_(std::move(other.last_)) {
     }
 
     node_tree& node_tree::operator=(const node_tree& other) {
         root_ = other.root_;
+        last_ = other.last_;
         return *this;
     }
 
     node_tree& node_tree::operator=(node_tree&& other) noexcept {
         root_ = std::move(other.root_);
+        last_ = std::move(other.last_);
         return *this;
     }
 
@@ -76,44 +114,68 @@ namespace docs_gen_core {
     node_tree::iterator node_tree::insert(const std::wstring& name, const std::wstring& type, const std::wstring& parent) {
         if (parent.empty()) {
             if (root_ != nullptr) {
-#ifndef RELEASE
-                std::cerr << "[ERROR] Root node of the scene already exists\n";
-#endif
+                DOCS_GEN_LOG_ERROR(parse, "Root node of the scene already exists");
                 return end();
             }
 
             root_ = std::make_shared<tree_node>(name, type);
-            root_->path = name;
+            root_->path = name_bytes(name);
             root_->depth = 1;
+            last_ = root_;
             return iterator(root_);
         }
         
-        if (parent == L".") {
-            const auto tn = std::make_shared<tree_node>(name, type, root_);
-            tn->path = root_->path / std::filesystem::path(name);
-            tn->depth = 2;
-            root_->children.push_back(tn);
-            return iterator(tn);
+        const auto p = parent == L"." ? root_ : find_parent(parent);
+        if (!p)
+            return end();
+
+        const auto tn = std::make_shared<tree_node>(name, type, p);
+        // appended in place, p->path / name would build two temporaries per node
+        tn->path = p->path;
+        tn->path /= name_bytes(name);
+        tn->depth = p->depth + 1;
+        p->children.push_back(tn);
+        last_ = tn;
+        return iterator(tn);
+    }
+
+    std::shared_ptr<node_tree::tree_node> node_tree::find_parent(std::wstring_view parent) const {
+        if (!root_)
+            return nullptr;
+
+        // a parent path with n slashes names a node n + 2 levels down
+        const auto depth = static_cast<std::size_t>(std::count(parent.begin(), parent.end(), L'/')) + 2;
+        auto n = last_;
+        while (n && n->depth > depth) {
+            n = n->parent.lock();
         }
-        
-        const auto& parent_path = root_->path / std::filesystem::path(parent).make_preferred();
-        for (auto it = begin(); it != end(); ++it) {
-            if (parent_path.compare((*it)->path) == 0) {
-                const auto tn = std::make_shared<tree_node>(name, type, *it);
-                tn->path = parent_path / std::filesystem::path(name);
-                tn->depth = (*it)->depth + 1;
-                (*it)->children.push_back(tn);
-                return iterator(tn);
-            }
+        if (n && n->depth == depth && has_path(n.get(), parent))
+            return n;
+
+        // out of the usual order, walk down from the root one name at a time
+        const std::shared_ptr<tree_node>* cur = &root_;
+        for (std::size_t i = 0; i <= parent.size(); ) {
+            auto slash = parent.find('/', i);
+            if (slash == std::wstring_view::npos) slash = parent.size();
+            const auto name = parent.substr(i, slash - i);
+            const auto& children = (*cur)->children;
+            const auto it = std::find_if(children.begin(), children.end(), [&](const auto& c) { return c->name == name; });
+            if (it == children.end())
+                return nullptr;
+            cur = &*it;
+            i = slash + 1;
         }
-        return end();
+        return *cur;
     }
 
     node_tree::iterator::iterator()
-        : path_(""), current_(nullptr) {}
+        : current_(nullptr) {}
 
     node_tree::iterator::iterator(const std::shared_ptr<tree_node>& node)
-        : path_(""), current_(node) {
+        : current_(node) {
+        // an empty tree, e.g. a scene whose node table was rejected, begins at end()
+        if (!current_)
+            return;
         for (auto it = current_->children.rbegin(); it != current_->children.rend(); ++it) {
             stack_.push(*it);
         }
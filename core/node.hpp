@@ -5,6 +5,7 @@
 #include <memory>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace docs_gen_core {
@@ -25,6 +26,11 @@ namespace docs_gen_core {
             std::vector<std::shared_ptr<tree_node>> children;
             std::vector<std::pair<std::wstring, std::weak_ptr<file>>> ext_resource_fields;
             std::vector<std::pair<std::wstring, std::wstring>> sub_resource_fields;
+            // name and source text of the other properties, kept only with parse_options::node_properties;
+            // decode_value reads the typed value out of the text when it is needed
+            std::vector<std::pair<std::wstring, std::wstring>> properties;
+            // the scene an instanced ("PackedScene") node brings in
+            std::weak_ptr<file> instance;
 
             tree_node(const std::wstring& name, const std::wstring& type);
             tree_node(const std::wstring& name, const std::wstring& type, const std::weak_ptr<tree_node>& parent);
@@ -38,6 +44,11 @@ namespace docs_gen_core {
         
     private:
         std::shared_ptr<tree_node> root_;
+        // scenes list a node right after its parent or its parent's descendants, so the parent of
+        // the next node is almost always this one or one of its ancestors
+        std::shared_ptr<tree_node> last_;
+
+        [[nodiscard]] std::shared_ptr<tree_node> find_parent(std::wstring_view parent) const;
 
     public:
         node_tree() = default;
@@ -65,8 +76,8 @@ namespace docs_gen_core {
             using const_reference = const value_type&;
 
         private:
-            std::stack<pointer> stack_;
-            std::filesystem::path path_;
+            // vector backed, a default deque allocates even when nothing is ever pushed
+            std::stack<pointer, std::vector<pointer>> stack_;
             pointer current_;
 
             friend class node_tree;
@@ -0,0 +1,78 @@
+#include "parse_cache.hpp"
+
+#include <array>
+#include <fstream>
+
+#include "parser.hpp"
+
+namespace docs_gen_core {
+
+	std::uint64_t hash_file_contents(const std::filesystem::path& path) {
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in.is_open())
+			return 0;
+
+		std::uint64_t h = 14695981039346656037ull;
+		std::uint64_t size = 0;
+		std::array<char, 16 * 1024> buf;
+		while (in) {
+			in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+			const auto n = static_cast<std::size_t>(in.gcount());
+			for (std::size_t i = 0; i < n; ++i) {
+				h ^= static_cast<unsigned char>(buf[i]);
+				h *= 1099511628211ull;
+			}
+			size += n;
+		}
+
+		h ^= size + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+		return h ? h : 1;
+	}
+
+	bool parse_cache::parse_script(const std::shared_ptr<script_file>& f) {
+		const auto key = hash_file_contents(f->get_path());
+		if (key == 0) {
+			script_parser p{ f };
+			return p.parse();
+		}
+
+		std::shared_future<script_result> result;
+		std::promise<script_result> promise;
+		bool owner = false;
+		{
+			std::lock_guard lock(mutex_);
+			const auto it = scripts_.find(key);
+			if (it != scripts_.end()) {
+				result = it->second;
+			}
+			else {
+				result = promise.get_future().share();
+				scripts_.emplace(key, result);
+				owner = true;
+			}
+		}
+
+		if (owner) {
+			++misses_;
+			script_parser p{ f };
+			const bool ok = p.parse();
+			promise.set_value(ok ? std::make_shared<const script_class>(f->get_script_class()) : nullptr);
+			return ok;
+		}
+
+		++hits_;
+		const auto& sc = result.get();
+		if (!sc)
+			return false;
+		f->set_script_class(*sc);
+		return true;
+	}
+
+	void parse_cache::clear() {
+		std::lock_guard lock(mutex_);
+		scripts_.clear();
+		hits_ = 0;
+		misses_ = 0;
+	}
+
+} // docs_gen_core
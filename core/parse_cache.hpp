@@ -0,0 +1,47 @@
+#ifndef DOCS_GEN_PARSE_CACHE_H
+#define DOCS_GEN_PARSE_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "file.hpp"
+
+namespace docs_gen_core {
+
+	// 64 bit FNV-1a of the file bytes mixed with their length, 0 if the file can not be read
+	[[nodiscard]] std::uint64_t hash_file_contents(const std::filesystem::path& path);
+
+	// parse results shared between projects, keyed by the content hash of the source file
+	//
+	// only scripts are cached: a script parses to the same script_class wherever it lives, while
+	// scenes and resources are linked against the uid and path tables of their own project
+	class parse_cache {
+		using script_result = std::shared_ptr<const script_class>;
+
+		std::mutex mutex_;
+		std::unordered_map<std::uint64_t, std::shared_future<script_result>> scripts_;
+		std::atomic<std::size_t> hits_{ 0 };
+		std::atomic<std::size_t> misses_{ 0 };
+
+	public:
+		parse_cache() = default;
+		parse_cache(const parse_cache&) = delete;
+		parse_cache& operator=(const parse_cache&) = delete;
+
+		// fills f from the cache or parses it; identical files parsed concurrently are parsed
+		// once, the other callers wait for that result
+		bool parse_script(const std::shared_ptr<script_file>& f);
+
+		void clear();
+		[[nodiscard]] std::size_t hits() const { return hits_.load(); }
+		[[nodiscard]] std::size_t misses() const { return misses_.load(); }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PARSE_CACHE_H
@@ -0,0 +1,140 @@
+#include "parse_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		const char* kind_name(file_kind kind) {
+			switch (kind) {
+			case file_kind::scene: return "scene";
+			case file_kind::resource: return "resource";
+			case file_kind::script: return "script";
+			default: return "other";
+			}
+		}
+
+		double to_ms(std::uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+		double to_mb(std::uint64_t bytes) { return static_cast<double>(bytes) / 1e6; }
+		double to_kb(std::uint64_t bytes) { return static_cast<double>(bytes) / 1e3; }
+
+		// upper bounds of the latency buckets, the last one is open
+		constexpr std::array<std::uint64_t, 5> bucket_bounds_ns = { 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000 };
+		constexpr std::array<const char*, bucket_bounds_ns.size() + 1> bucket_names = {
+			"<  100 us", "<    1 ms", "<   10 ms", "<  100 ms", "<    1 s ", ">=   1 s ",
+		};
+		constexpr std::size_t bar_width = 40;
+
+	} // namespace
+
+	std::uint64_t parse_stats::now_ns() {
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void parse_stats::record(const file& f, std::uint64_t sections, std::uint64_t nodes, std::uint64_t fields, std::uint64_t start_ns) {
+		const auto duration = now_ns() - start_ns;
+		std::error_code ec;
+		const auto bytes = std::filesystem::file_size(f.get_path(), ec);
+
+		entry e{ f.get_path(), f.get_kind(), ec ? 0 : static_cast<std::uint64_t>(bytes), sections, nodes, fields, duration };
+		std::lock_guard lock(mutex_);
+		entries_.push_back(std::move(e));
+	}
+
+	void parse_stats::clear() {
+		std::lock_guard lock(mutex_);
+		entries_.clear();
+	}
+
+	std::vector<parse_stats::entry> parse_stats::get_entries() const {
+		std::lock_guard lock(mutex_);
+		return entries_;
+	}
+
+	std::size_t parse_stats::size() const {
+		std::lock_guard lock(mutex_);
+		return entries_.size();
+	}
+
+	void parse_stats::write_report(std::ostream& out, std::size_t top) const {
+		auto entries = get_entries();
+		if (entries.empty()) {
+			out << "Parse statistics: no files parsed\n";
+			return;
+		}
+
+		struct totals {
+			std::size_t files = 0;
+			std::uint64_t bytes = 0;
+			std::uint64_t ns = 0;
+		};
+		std::array<totals, 4> by_kind{};
+		totals all;
+		std::array<std::size_t, bucket_names.size()> buckets{};
+		for (const auto& e : entries) {
+			for (auto* t : { &by_kind[static_cast<std::size_t>(e.kind)], &all }) {
+				++t->files;
+				t->bytes += e.bytes;
+				t->ns += e.duration_ns;
+			}
+			const auto b = std::upper_bound(bucket_bounds_ns.begin(), bucket_bounds_ns.end(), e.duration_ns) - bucket_bounds_ns.begin();
+			++buckets[static_cast<std::size_t>(b)];
+		}
+
+		const auto flags = out.flags();
+		const auto precision = out.precision();
+		out << std::fixed << std::setprecision(2);
+
+		// throughput is per parsing thread, the time is summed over the files
+		out << "Parse statistics: " << all.files << " files, " << to_mb(all.bytes) << " MB, "
+			<< to_ms(all.ns) << " ms of parse time\n";
+		out << "  " << std::left << std::setw(10) << "kind" << std::right << std::setw(8) << "files"
+			<< std::setw(12) << "MB" << std::setw(12) << "ms" << std::setw(10) << "MB/s" << '\n';
+		for (const auto kind : { file_kind::scene, file_kind::resource, file_kind::script }) {
+			const auto& t = by_kind[static_cast<std::size_t>(kind)];
+			if (t.files == 0) continue;
+			out << "  " << std::left << std::setw(10) << kind_name(kind) << std::right << std::setw(8) << t.files
+				<< std::setw(12) << to_mb(t.bytes) << std::setw(12) << to_ms(t.ns)
+				<< std::setw(10) << (t.ns ? to_mb(t.bytes) / (static_cast<double>(t.ns) / 1e9) : 0.0) << '\n';
+		}
+
+		out << "Parse time per file:\n";
+		const auto peak = *std::max_element(buckets.begin(), buckets.end());
+		for (std::size_t i = 0; i < buckets.size(); ++i) {
+			const auto bar = peak ? (buckets[i] * bar_width + peak - 1) / peak : 0;
+			out << "  " << bucket_names[i] << std::setw(8) << buckets[i] << "  " << std::string(bar, '#') << '\n';
+		}
+
+		const auto n = std::min(top, entries.size());
+		std::partial_sort(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(n), entries.end(),
+			[](const entry& a, const entry& b) { return a.duration_ns > b.duration_ns; });
+		out << "Slowest files:\n";
+		for (std::size_t i = 0; i < n; ++i) {
+			const auto& e = entries[i];
+			out << "  " << std::setw(10) << to_ms(e.duration_ns) << " ms" << std::setw(10) << to_kb(e.bytes) << " KB  "
+				<< e.path.u8string() << '\n';
+		}
+
+		const auto trees = static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), [](const entry& e) { return e.nodes > 0; }));
+		const auto m = std::min(top, trees);
+		std::partial_sort(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(m), entries.end(),
+			[](const entry& a, const entry& b) { return a.nodes > b.nodes; });
+		if (m > 0) {
+			out << "Largest node trees:\n";
+			for (std::size_t i = 0; i < m; ++i) {
+				const auto& e = entries[i];
+				out << "  " << std::setw(10) << e.nodes << " nodes" << std::setw(10) << e.fields << " fields  "
+					<< e.path.u8string() << '\n';
+			}
+		}
+
+		out.flags(flags);
+		out.precision(precision);
+	}
+
+} // docs_gen_core
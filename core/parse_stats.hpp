@@ -0,0 +1,58 @@
+#ifndef DOCS_GEN_PARSE_STATS_H
+#define DOCS_GEN_PARSE_STATS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "file.hpp"
+
+namespace docs_gen_core {
+
+	// what parsing each file cost, for --stats
+	//
+	// one entry per parsed scene, resource and script body: its size, what came out of it and the
+	// time the parse took. recording is two clock reads, a stat of the file and one push_back under
+	// a mutex, small next to the parse itself, so it can stay on in CI runs
+	class parse_stats {
+	public:
+		struct entry {
+			std::filesystem::path path;
+			file_kind kind = file_kind::other;
+			std::uint64_t bytes = 0;
+			std::uint64_t sections = 0;
+			std::uint64_t nodes = 0;
+			// node and resource properties, script variables and functions
+			std::uint64_t fields = 0;
+			std::uint64_t duration_ns = 0;
+		};
+
+	private:
+		mutable std::mutex mutex_;
+		std::vector<entry> entries_;
+
+	public:
+		parse_stats() = default;
+		parse_stats(const parse_stats&) = delete;
+		parse_stats& operator=(const parse_stats&) = delete;
+
+		// steady clock, what record() takes as the start of a parse
+		[[nodiscard]] static std::uint64_t now_ns();
+
+		// f was parsed from start_ns until now; may be called from several threads
+		void record(const file& f, std::uint64_t sections, std::uint64_t nodes, std::uint64_t fields, std::uint64_t start_ns);
+		void clear();
+
+		[[nodiscard]] std::vector<entry> get_entries() const;
+		[[nodiscard]] std::size_t size() const;
+
+		// throughput per file kind, a latency histogram, the top slowest files and the largest
+		// node trees
+		void write_report(std::ostream& out, std::size_t top = 10) const;
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PARSE_STATS_H
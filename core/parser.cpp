@@ -1,321 +1,539 @@
 #include "parser.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <cwctype>
+#include <fstream>
+#include <utility>
 
+#include "log.hpp"
+#include "trace.hpp"
 #include "util/util.hpp"
 
 namespace docs_gen_core {
 
-	dott_parser::dott_parser(const std::shared_ptr<dott_file>& file)
-	: file_(file) {
+	namespace {
+
+		constexpr std::size_t stream_buf_size = 8192;
+		constexpr std::size_t scan_buf_size = 1024 * 1024;
+
+		// ExtResource("1_abc") or SubResource("2_def") down to the id, without a temporary
+		void strip_resource_ref(std::wstring& s) {
+			if (s.size() < 15) {
+				s.clear();
+				return;
+			}
+			s.erase(s.size() - 2);
+			s.erase(0, 13);
+		}
+
+		// what s.substr(pos) gave for the script lines, empty for a line too short
+		std::wstring_view tail(std::wstring_view s, std::size_t pos) {
+			return pos < s.size() ? s.substr(pos) : std::wstring_view{};
+		}
+
+		// a function argument without the blanks util::split_by dropped
+		std::wstring squeeze(std::wstring_view s) {
+			std::wstring res;
+			res.reserve(s.size());
+			for (const auto c : s)
+				if (!std::isspace(c))
+					res.push_back(c);
+			return res;
+		}
+
+	} // namespace
+
+	std::vector<std::uint64_t> find_section_cuts(const std::filesystem::path& path, std::uint64_t from, std::uint64_t chunk_bytes) {
+		std::vector<std::uint64_t> cuts{ from };
+		std::ifstream in{ path, std::ios::in | std::ios::binary };
+		if (!in.is_open() || chunk_bytes == 0)
+			return {};
+		in.seekg(static_cast<std::streamoff>(from));
+
+		std::vector<char> buf(scan_buf_size);
+		auto pos = from;
+		auto next_cut = from + chunk_bytes;
+		std::size_t depth = 0;
+		bool in_string = false;
+		bool escaped = false;
+		bool line_start = true;
+		while (in) {
+			in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+			const auto n = static_cast<std::size_t>(in.gcount());
+			for (std::size_t i = 0; i < n; ++i, ++pos) {
+				const auto c = buf[i];
+				const bool was_line_start = line_start;
+				line_start = c == '\n';
+				if (in_string) {
+					if (escaped) escaped = false;
+					else if (c == '\\') escaped = true;
+					else if (c == '"') in_string = false;
+					continue;
+				}
+
+				switch (c) {
+				case '"':
+					in_string = true;
+					break;
+				case '[':
+					if (was_line_start && depth == 0 && pos >= next_cut) {
+						cuts.push_back(pos);
+						next_cut = pos + chunk_bytes;
+					}
+					++depth;
+					break;
+				case '(': case '{':
+					++depth;
+					break;
+				case ']': case ')': case '}':
+					if (depth) --depth;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+		cuts.push_back(pos);
+		return cuts;
+	}
+
+	std::shared_ptr<file> link_context::resolve(std::uint64_t uid, std::wstring_view path, file_kind kind) const {
+		if (uid != invalid_uid) {
+			if (kind == file_kind::scene) {
+				if (const auto* f = scene_files.find(uid))
+					return *f;
+			}
+			else if (kind == file_kind::resource) {
+				if (const auto* f = resource_files.find(uid))
+					return *f;
+			}
+		}
+
+		if (path.empty())
+			return nullptr;
+
+		const auto id = paths.resolve(path);
+		if (id == file::npos || id >= files.size() || files[id]->get_kind() != kind)
+			return nullptr;
+		return files[id];
+	}
+
+	dott_parser::dott_parser()
+	: stream_buf_(new wchar_t[stream_buf_size]) {
+		// only taken before the first open
+		in_.rdbuf()->pubsetbuf(stream_buf_.get(), stream_buf_size);
+	}
+
+	dott_parser::dott_parser(const std::shared_ptr<dott_file>& file, const parse_options& options)
+	: dott_parser() {
+		open(file, options);
+	}
+
+	void dott_parser::open(const std::shared_ptr<dott_file>& file, const parse_options& options) {
+		close();
+		file_ = file;
+		options_ = options;
+		fields_.clear();
+		section_count_ = 0;
+		node_count_ = 0;
+		field_count_ = 0;
+		pending_ = false;
+		cancel_ = cancel_poll{ options_.cancel };
+
 		in_.open(file_->get_path(), std::ios::in | std::ios::binary);
 		if (!in_.is_open()) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] could not open file: " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "could not open file: ", file_->get_path());
 			return;
 		}
 	}
 
+	void dott_parser::close() {
+		if (in_.is_open()) {
+			in_.close();
+		}
+		in_.clear();
+		file_.reset();
+	}
+
 	bool dott_parser::parse_scene_header() {
-		next_entry();
+		if (!next_entry() && cancel_.cancelled())
+			return false;
 		if (!validate_scene_header()) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] corrupted scene file: " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "corrupted scene file: ", file_->get_path());
 			return false;
 		}
 
 		auto file = dynamic_cast<scene_file*>(file_.get());
 		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
 			return false;
 		}
 		
-		file->set_uid(fields_[L"uid"]);
+		file->set_uid(decode_uid(fields_.get(field_key::uid)));
 		return true;
 	}
 
 	bool dott_parser::parse_resource_header() {
-		next_entry();
+		if (!next_entry() && cancel_.cancelled())
+			return false;
 		if (!validate_resource_header()) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] corrupted resource file: " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "corrupted resource file: ", file_->get_path());
 			return false;
 		}
 
 		auto file = dynamic_cast<resource_file*>(file_.get());
 		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
 			return false;
 		}
 
-		file->set_uid(fields_[L"uid"]);
-		file->set_script_class(fields_[L"script_class"]);
+		file->set_uid(decode_uid(fields_.get(field_key::uid)));
+		file->set_script_class(fields_.get(field_key::script_class));
 		return true;
 	}
 
-	bool dott_parser::parse_scene_file_contents(
-		const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files) {
+	bool dott_parser::parse_scene_file_contents(const link_context& ctx) {
+		return parse_scene_links(ctx) && parse_scene_body();
+	}
+
+	bool dott_parser::parse_scene_links(const link_context& ctx) {
 		auto file = dynamic_cast<scene_file*>(file_.get());
 		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
 			return false;
 		}
 
-#ifndef RELEASE
-		std::cout << "---- Processing scene file " << file->get_path() << " ----\n";
-#endif
+		DOCS_GEN_LOG_DEBUG(parse, "processing scene file ", file->get_path());
+		// godot writes every ext_resource ahead of the first node, so the links end there
 		while (next_entry()) {
-			if (fields_.find(L"ext_resource") != fields_.end()) {
-				if (!validate_ext_resource_type()) {
-#ifndef RELEASE
-					std::cerr << "[ERROR] corrupted scene file (invalid external resource type): " << file->get_path() << '\n';
-#endif
-					return false;
-				}
+			const auto kind = fields_.get_kind();
+			if (kind == section_kind::gd_scene)
+				continue;
+			if (kind != section_kind::ext_resource) {
+				pending_ = true;
+				break;
+			}
 
-				auto& type = fields_[L"type"];
-				if (type == L"PackedScene") {
-					if (!validate_ext_resource_packed_scene()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"PackedScene\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
+			if (!validate_ext_resource_type()) {
+				DOCS_GEN_LOG_ERROR(parse, "corrupted scene file (invalid external resource type): ", file->get_path());
+				return false;
+			}
 
-					auto& uid = fields_[L"uid"];
-					if (scene_files.find(uid) == scene_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered scene file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+			auto& type = fields_.get(field_key::type);
+			if (type == L"PackedScene") {
+				if (!validate_ext_resource_packed_scene()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted scene file (invalid external resource \"PackedScene\"): ", file->get_path());
+					continue;
+				}
 
-					file->push_packed_scene(fields_[L"id"], scene_files.at(uid));
+				auto scene = resolve_packed_scene(ctx);
+				if (!scene) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered scene file: ", fields_.get(field_key::path));
+					continue;
 				}
-				else if (type == L"Script") {
-					if (!validate_ext_resource_script()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Script\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
 
-					std::wstring path_str = fields_[L"path"];
-					auto rel_root_path = root_path_ / std::filesystem::path{ path_str };
-					rel_root_path.make_preferred();
-					path_str = rel_root_path.relative_path().wstring();
-					if (script_files.find(path_str) == script_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered script file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+				file->push_packed_scene(fields_.get(field_key::id), scene);
+			}
+			else if (type == L"Script") {
+				if (!validate_ext_resource_script()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted scene file (invalid external resource \"Script\"): ", file->get_path());
+					continue;
+				}
 
-					file->push_script(fields_[L"id"], script_files.at(path_str));
+				auto script = resolve_script(ctx);
+				if (!script) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered script file: ", fields_.get(field_key::path));
+					continue;
 				}
-				else if (type == L"Resource") {
-					if (!validate_ext_resource_resource()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Resource\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
 
-					auto& uid = fields_[L"uid"];
-					if (resource_files.find(uid) == resource_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered resource file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+				file->push_script(fields_.get(field_key::id), script);
+			}
+			else if (type == L"Resource") {
+				if (!validate_ext_resource_resource()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted scene file (invalid external resource \"Resource\"): ", file->get_path());
+					continue;
+				}
 
-					file->push_ext_resource(fields_[L"id"], resource_files.at(uid));
+				auto resource = resolve_resource(ctx);
+				if (!resource) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered resource file: ", fields_.get(field_key::path));
+					continue;
 				}
-				else {
-					if (!validate_ext_resource_other()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Other\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
 
-					file->push_ext_resource_other(fields_[L"id"], {fields_[L"type"], fields_[L"path"]});
+				file->push_ext_resource(fields_.get(field_key::id), resource);
+			}
+			else {
+				if (!validate_ext_resource_other()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted scene file (invalid external resource \"Other\"): ", file->get_path());
+					continue;
 				}
+
+				file->push_ext_resource_other(fields_.get(field_key::id), {fields_.get(field_key::type), fields_.get(field_key::path)});
 			}
-			else if (fields_.find(L"node") != fields_.end()) {
+		}
+
+		file->freeze_links();
+		return !cancel_.cancelled();
+	}
+
+	bool dott_parser::parse_scene_body() {
+		auto file = dynamic_cast<scene_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		if (pool_ && options_.split_bytes != 0 && !in_.eof() && in_.is_open()) {
+			std::error_code ec;
+			const auto size = std::filesystem::file_size(file->get_path(), ec);
+			const auto body_start = pending_ ? section_start_ : static_cast<std::uint64_t>(in_.tellg());
+			if (!ec && body_start < size && size - body_start >= 2 * options_.split_bytes && parse_scene_body_split(*file, body_start)) {
+				pending_ = false;
+				return !cancel_.cancelled();
+			}
+		}
+
+		// resumes where the links pass stopped, or reads from the top (skipping the ext_resources)
+		// when the links were read by another parser
+		for (bool more = std::exchange(pending_, false) || next_entry(); more; more = next_entry()) {
+			if (fields_.get_kind() == section_kind::node) {
 				auto tn = file->get_node_tree().end();
 				
-				if (fields_.find(L"type") != fields_.end()) {
-					tn = file->get_node_tree().insert(fields_[L"name"], fields_[L"type"], fields_[L"parent"]);
+				if (fields_.has(field_key::type)) {
+					tn = file->get_node_tree().insert(fields_.get(field_key::name), fields_.get(field_key::type), fields_.get(field_key::parent));
 				}
-				else if (fields_.find(L"instance") != fields_.end()) {
-					auto& instance = fields_[L"instance"];
-					if (file->get_packed_scenes().find(instance) != file->get_packed_scenes().end()) {
-						tn = file->get_node_tree().insert(fields_[L"name"], L"PackedScene", fields_[L"parent"]);
+				else if (fields_.has(field_key::instance)) {
+					auto& instance = fields_.get(field_key::instance);
+					if (const auto* ps = file->get_packed_scenes().find(instance)) {
+						tn = file->get_node_tree().insert(fields_.get(field_key::name), L"PackedScene", fields_.get(field_key::parent));
+						if (tn != file->get_node_tree().end())
+							(*tn)->instance = *ps;
 					}
 				}
 				else {
-					tn = file->get_node_tree().insert(fields_[L"name"], L"Unknown", fields_[L"parent"]);
+					tn = file->get_node_tree().insert(fields_.get(field_key::name), L"Unknown", fields_.get(field_key::parent));
 				}
 
 				if (tn != file->get_node_tree().end()) {
+					++node_count_;
 					while (next_node_field()) {
-						auto second = node_field_.second;
-						if (second.find(L"ExtResource") != std::string::npos) {						
-							second = second.substr(13, second.size() - 15);
-							const auto& sf =  file->get_packed_scenes().find(second);
-							if (sf != file->get_packed_scenes().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, sf->second);
-								continue;
-							}
-
-							const auto& scf = file->get_scripts().find(second);
-							if (scf != file->get_scripts().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, scf->second);
-								continue;
-							}
-
-							const auto& rf = file->get_ext_resources().find(second);
-							if (rf != file->get_ext_resources().end()) {
-								(*tn)->ext_resource_fields.emplace_back(node_field_.first, rf->second);
-							}
-						}
+						push_node_field(**tn, *file);
 					}
 				}
 			}
 		}
 
+		return !cancel_.cancelled();
+	}
+
+	void dott_parser::push_node_field(node_tree::tree_node& node, const scene_file& file) {
+		auto& second = node_field_.second;
+		if (second.find(L"ExtResource") != std::string::npos) {
+			strip_resource_ref(second);
+			if (const auto* sf = file.get_packed_scenes().find(second)) {
+				node.ext_resource_fields.emplace_back(node_field_.first, *sf);
+				return;
+			}
+
+			if (const auto* scf = file.get_scripts().find(second)) {
+				node.ext_resource_fields.emplace_back(node_field_.first, *scf);
+				return;
+			}
+
+			if (const auto* rf = file.get_ext_resources().find(second)) {
+				node.ext_resource_fields.emplace_back(node_field_.first, *rf);
+			}
+		}
+		else if (options_.node_properties) {
+			node.properties.emplace_back(node_field_.first, second);
+		}
+	}
+
+	// the chunks are read by parsers of their own that run the loop of parse_scene_body up to the
+	// next chunk, only the tree insert waits for the merge; a node whose parent is missing gets
+	// its properties read and dropped where the single pass would skip over them, the same
+	// outcome for any file godot writes
+	bool dott_parser::parse_scene_body_split(scene_file& file, std::uint64_t body_start) {
+		const auto cuts = find_section_cuts(file.get_path(), body_start, options_.split_bytes);
+		if (cuts.size() < 3)
+			return false;
+
+		struct chunk {
+			std::vector<pending_node> nodes;
+			std::size_t sections = 0;
+		};
+		std::vector<chunk> chunks(cuts.size() - 1);
+		parallel_for(pool_, chunks.size(), [&](std::size_t i) {
+			DOCS_GEN_TRACE_SCOPE(span, "parse_scene_chunk", "parse");
+			span.arg("bytes", cuts[i + 1] - cuts[i]);
+			dott_parser p{ file_, options_ };
+			p.in_.seekg(static_cast<std::streamoff>(cuts[i]));
+			p.stop_at_ = i + 2 < cuts.size() ? cuts[i + 1] : 0;
+			p.read_pending_nodes(file, chunks[i].nodes);
+			chunks[i].sections = p.section_count_;
+		});
+		// the chunk parsers poll the same token, the tree would be missing whole chunks
+		if (cancel_.cancelled())
+			return true;
+
+		auto& tree = file.get_node_tree();
+		for (auto& c : chunks) {
+			section_count_ += c.sections;
+			for (auto& pn : c.nodes) {
+				auto tn = tree.insert(pn.node->name, pn.node->type, pn.parent);
+				if (tn == tree.end())
+					continue;
+
+				++node_count_;
+				field_count_ += pn.fields;
+				(*tn)->ext_resource_fields = std::move(pn.node->ext_resource_fields);
+				(*tn)->properties = std::move(pn.node->properties);
+				(*tn)->instance = std::move(pn.node->instance);
+			}
+			c.nodes = {};
+		}
+
+		in_.setstate(std::ios::eofbit);
 		return true;
 	}
 
-	bool dott_parser::parse_resource_file_contents(
-		const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-		const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files) {
+	void dott_parser::read_pending_nodes(const scene_file& file, std::vector<pending_node>& nodes) {
+		while (next_entry()) {
+			if (fields_.get_kind() != section_kind::node)
+				continue;
+
+			pending_node pn;
+			if (fields_.has(field_key::type)) {
+				pn.node = std::make_shared<node_tree::tree_node>(fields_.get(field_key::name), fields_.get(field_key::type));
+			}
+			else if (fields_.has(field_key::instance)) {
+				const auto* ps = file.get_packed_scenes().find(fields_.get(field_key::instance));
+				if (!ps)
+					continue;
+				pn.node = std::make_shared<node_tree::tree_node>(fields_.get(field_key::name), L"PackedScene");
+				pn.node->instance = *ps;
+			}
+			else {
+				pn.node = std::make_shared<node_tree::tree_node>(fields_.get(field_key::name), L"Unknown");
+			}
+			pn.parent = fields_.get(field_key::parent);
+
+			const auto before = field_count_;
+			while (next_node_field()) {
+				push_node_field(*pn.node, file);
+			}
+			pn.fields = field_count_ - before;
+			nodes.push_back(std::move(pn));
+		}
+	}
+
+	bool dott_parser::parse_resource_file_contents(const link_context& ctx) {
+		return parse_resource_links(ctx) && parse_resource_body();
+	}
+
+	bool dott_parser::parse_resource_links(const link_context& ctx) {
 		auto file = dynamic_cast<resource_file*>(file_.get());
 		if (!file) {
-#ifndef RELEASE
-			std::cerr << "[ERROR] wrong file type " << file_->get_path() << '\n';
-#endif
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
 			return false;
 		}
 
-#ifndef RELEASE
-		std::cout << "---- Processing resource file " << file->get_path() << " ----\n";
-#endif
+		DOCS_GEN_LOG_DEBUG(parse, "processing resource file ", file->get_path());
 		while (next_entry()) {
-			if (fields_.find(L"ext_resource") != fields_.end()) {
-				auto& type = fields_[L"type"];
-				if (type == L"Script") {
-					if (!validate_ext_resource_script()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted resource file (invalid external resource \"Script\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
+			const auto kind = fields_.get_kind();
+			if (kind == section_kind::gd_resource)
+				continue;
+			if (kind != section_kind::ext_resource) {
+				pending_ = true;
+				break;
+			}
 
-					std::wstring path_str = fields_[L"path"];
-					auto rel_root_path = root_path_ / std::filesystem::path{ path_str };
-					rel_root_path.make_preferred();
-					path_str = rel_root_path.relative_path().wstring();
-					if (script_files.find(path_str) == script_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered script file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
-				
-					file->push_script(fields_[L"id"], script_files.at(path_str));
+			auto& type = fields_.get(field_key::type);
+			if (type == L"Script") {
+				if (!validate_ext_resource_script()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted resource file (invalid external resource \"Script\"): ", file->get_path());
+					continue;
 				}
-				else if (type == L"Resource") {
-					if (!validate_ext_resource_resource()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted resource file (invalid external resource \"Resource\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
 
-					auto& uid = fields_[L"uid"];
-					if (resource_files.find(uid) == resource_files.end()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] previously not encountered resource file: ";
-						std::wcerr << fields_[L"path"];
-						std::cerr << '\n';
-#endif
-						continue;
-					}
+				auto script = resolve_script(ctx);
+				if (!script) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered script file: ", fields_.get(field_key::path));
+					continue;
+				}
+			
+				file->push_script(fields_.get(field_key::id), script);
+			}
+			else if (type == L"Resource") {
+				if (!validate_ext_resource_resource()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted resource file (invalid external resource \"Resource\"): ", file->get_path());
+					continue;
+				}
 
-					file->push_ext_resource(fields_[L"id"], resource_files.at(uid));
+				auto resource = resolve_resource(ctx);
+				if (!resource) {
+					DOCS_GEN_LOG_WARNING(parse, "previously not encountered resource file: ", fields_.get(field_key::path));
+					continue;
 				}
-				else {
-					if (!validate_ext_resource_other()) {
-#ifndef RELEASE
-						std::cerr << "[WARNING] corrupted scene file (invalid external resource \"Other\"): " << file->get_path() << '\n';
-#endif
-						continue;
-					}
 
-					file->push_ext_resource_other(fields_[L"id"], {fields_[L"type"], fields_[L"path"]});
+				file->push_ext_resource(fields_.get(field_key::id), resource);
+			}
+			else {
+				if (!validate_ext_resource_other()) {
+					DOCS_GEN_LOG_WARNING(parse, "corrupted scene file (invalid external resource \"Other\"): ", file->get_path());
+					continue;
 				}
+
+				file->push_ext_resource_other(fields_.get(field_key::id), {fields_.get(field_key::type), fields_.get(field_key::path)});
 			}
-			else if (fields_.find(L"sub_resource") != fields_.end()) {
+		}
+
+		file->freeze_links();
+		return !cancel_.cancelled();
+	}
+
+	bool dott_parser::parse_resource_body() {
+		auto file = dynamic_cast<resource_file*>(file_.get());
+		if (!file) {
+			DOCS_GEN_LOG_ERROR(parse, "wrong file type ", file_->get_path());
+			return false;
+		}
+
+		// resumes where the links pass stopped, or reads from the top (skipping the ext_resources)
+		// when the links were read by another parser
+		for (bool more = std::exchange(pending_, false) || next_entry(); more; more = next_entry()) {
+			if (fields_.get_kind() == section_kind::sub_resource) {
 				if (!validate_sub_resource()) {
-#ifndef RELEASE
-					std::cerr << "[WARNING] corrupted resource file (invalid sub_resource): " << file->get_path() << '\n';
-#endif
+					DOCS_GEN_LOG_WARNING(parse, "corrupted resource file (invalid sub_resource): ", file->get_path());
 					continue;
 				}
 				
-				const auto& type = fields_[L"type"];
+				const auto& type = fields_.get(field_key::type);
 				resource_file::resource r{type, {}, {}, {}, {}};
 				while (next_resource_field()) {
 					auto& [name, val] = res_field_;
 					if (val.find(L"ExtResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& ps = file->get_packed_scenes();
-						if (ps.find(val) != ps.end()) {
-							r.res_file_fields.push_back({name, ps.at(val)});
+						strip_resource_ref(val);
+						if (const auto* ps = file->get_packed_scenes().find(val)) {
+							r.res_file_fields.push_back({name, *ps});
 							continue;
 						}
 
-						const auto& sf = file->get_scripts();
-						if (sf.find(val) != sf.end()) {
-							r.res_file_fields.push_back({name, sf.at(val)});
+						if (const auto* sf = file->get_scripts().find(val)) {
+							r.res_file_fields.push_back({name, *sf});
 							continue;
 						}
 
-						const auto& rf = file->get_ext_resources();
-						if (rf.find(val) != rf.end()) {
-							r.res_file_fields.push_back({name, rf.at(val)});
+						if (const auto* rf = file->get_ext_resources().find(val)) {
+							r.res_file_fields.push_back({name, *rf});
 							continue;
 						}
 						
-						const auto& ero = file->get_ext_resource_other();
-						if (ero.find(val) != ero.end()) {
-							r.res_other_fields.push_back({name, ero.at(val).name});
+						if (const auto* ero = file->get_ext_resource_other().find(val)) {
+							r.res_other_fields.push_back({name, ero->name});
 						}
 					}
 					else if (val.find(L"SubResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
+						strip_resource_ref(val);
 						const auto& srf = file->get_sub_resources();
 						if (srf.find(val) != srf.end()) {
 							r.sub_res_fields.push_back({name, srf.at(val)});
@@ -325,39 +543,35 @@ namespace docs_gen_core {
 						r.fields.push_back({name, val});
 					}
 				}
-				file->push_sub_resource(fields_[L"id"], std::make_shared<resource_file::resource>(r));
+				file->push_sub_resource(fields_.get(field_key::id), std::make_shared<resource_file::resource>(std::move(r)));
 			}
-			else if (fields_.find(L"resource") != fields_.end()) {
+			else if (fields_.get_kind() == section_kind::resource) {
 				resource_file::resource r{{},{},{},{}, {}};
 				while (next_resource_field()) {
 					auto& [name, val] = res_field_;
 					if (val.find(L"ExtResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
-						const auto& ps = file->get_packed_scenes();
-						if (ps.find(val) != ps.end()) {
-							r.res_file_fields.push_back({name, ps.at(val)});
+						strip_resource_ref(val);
+						if (const auto* ps = file->get_packed_scenes().find(val)) {
+							r.res_file_fields.push_back({name, *ps});
 							continue;
 						}
 
-						const auto& sf = file->get_scripts();
-						if (sf.find(val) != sf.end()) {
-							r.res_file_fields.push_back({name, sf.at(val)});
+						if (const auto* sf = file->get_scripts().find(val)) {
+							r.res_file_fields.push_back({name, *sf});
 							continue;
 						}
 
-						const auto& rf = file->get_ext_resources();
-						if (rf.find(val) != rf.end()) {
-							r.res_file_fields.push_back({name, rf.at(val)});
+						if (const auto* rf = file->get_ext_resources().find(val)) {
+							r.res_file_fields.push_back({name, *rf});
 							continue;
 						}
 						
-						const auto& ero = file->get_ext_resource_other();
-						if (ero.find(val) != ero.end()) {
-							r.res_other_fields.push_back({name, ero.at(val).name});
+						if (const auto* ero = file->get_ext_resource_other().find(val)) {
+							r.res_other_fields.push_back({name, ero->name});
 						}
 					}
 					else if (val.find(L"SubResource") != std::wstring::npos) {
-						val = val.substr(13, val.size() - 15);
+						strip_resource_ref(val);
 						const auto& srf = file->get_sub_resources();
 						if (srf.find(val) != srf.end()) {
 							r.sub_res_fields.push_back({name, srf.at(val)});
@@ -367,15 +581,15 @@ namespace docs_gen_core {
 						r.fields.push_back({name, val});
 					}
 				}
-				file->set_resource(r);
+				file->set_resource(std::move(r));
 			}
 		}
 
-		return true;
+		return !cancel_.cancelled();
 	}
 
 	bool dott_parser::next_entry() {
-		if (in_.eof() || in_.bad())
+		if (in_.eof() || in_.bad() || cancel_())
 			return false;
 
 		wchar_t c;
@@ -388,180 +602,312 @@ namespace docs_gen_core {
 			return false;
 
 		const auto start = in_.tellg();
+		section_start_ = static_cast<std::uint64_t>(start) - 1;
+		if (stop_at_ != 0 && section_start_ >= stop_at_) {
+			// the next chunk's first section
+			in_.setstate(std::ios::eofbit);
+			return false;
+		}
 		while (in_.get(c) && c != ']') {}
 		if (in_.eof() || in_.bad())
 			return false;
 
 		const auto size = in_.tellg() - start - 1;
 		in_.seekg(start, std::wifstream::beg);
-		std::wstring temp(size, '\0');
-		in_.read(temp.data(), size);
+		section_text_.resize(size);
+		in_.read(section_text_.data(), size);
 
-		iss_ = std::wistringstream(temp);
+		// split on whitespace outside of quotes, the first token names the section
 		fields_.clear();
-		while (next_field()) {
+		const std::wstring_view text = section_text_;
+		bool first = true;
+		for (std::size_t i = 0; i < text.size(); ) {
+			bool is_quote_opened = false;
+			auto j = i;
+			for (; j < text.size(); ++j) {
+				if (text[j] == '"') {
+					is_quote_opened = !is_quote_opened;
+				}
+				if (std::isspace(text[j]) && !is_quote_opened) {
+					break;
+				}
+			}
+
+			const auto token = text.substr(i, j - i);
+			i = j + 1;
+			if (token.empty())
+				continue;
+
+			if (first) {
+				fields_.set_kind(to_section_kind(token));
+				first = false;
+				continue;
+			}
+			push_field(token);
 		}
+		++section_count_;
 
 		while (in_.get(c) && c != '\n') {}
 
 		return true;
 	}
 
-	bool dott_parser::next_field() {
-		if (iss_.eof())
+	void dott_parser::push_field(std::wstring_view token) {
+		const auto del = token.find_first_of('=');
+		if (del == std::wstring_view::npos) {
+			fields_.push_unknown(token, {});
+			return;
+		}
+
+		const auto lhs = token.substr(0, del);
+		auto rhs = token.substr(del + 1);
+		const auto key = to_field_key(lhs);
+		switch (key) {
+		case field_key::uid:
+		case field_key::path:
+			// "uid://..." and "res://..."
+			rhs = rhs.size() >= 8 ? rhs.substr(7, rhs.size() - 8) : std::wstring_view{};
+			break;
+		case field_key::id:
+		case field_key::type:
+		case field_key::parent:
+		case field_key::name:
+			rhs = rhs.size() >= 2 ? rhs.substr(1, rhs.size() - 2) : std::wstring_view{};
+			break;
+		case field_key::instance:
+			// ExtResource("...")
+			rhs = rhs.size() >= 15 ? rhs.substr(13, rhs.size() - 15) : std::wstring_view{};
+			break;
+		case field_key::unknown:
+			fields_.push_unknown(lhs, rhs);
+			return;
+		default:
+			break;
+		}
+		fields_.set(key, rhs);
+	}
+
+	bool dott_parser::next_node_field() {
+		return next_property(node_field_);
+	}
+
+	bool dott_parser::next_resource_field() {
+		return next_property(res_field_);
+	}
+
+	// "name = value" up to the end of the line, false on the blank line that ends the section
+	bool dott_parser::next_property(std::pair<std::wstring, std::wstring>& field) {
+		if (in_.eof() || in_.bad() || cancel_())
 			return false;
 
-		std::wstring temp;
-		wchar_t c;
-		bool is_quote_opened = false;
-		while (iss_.get(c)) {
-			if (c == '"') {
-				is_quote_opened = !is_quote_opened;
-			}
-			if (std::isspace(c) && !is_quote_opened) {
+		line_.clear();
+		const auto cap = options_.max_value_bytes;
+		auto value_start = std::wstring::npos;
+		auto* buf = in_.rdbuf();
+		for (;;) {
+			const auto c = buf->sbumpc();
+			if (c == WEOF) {
+				in_.setstate(std::ios::eofbit);
 				break;
 			}
-			temp.push_back(c);
-		}
+			if (c == '\n')
+				break;
 
-		auto del = temp.find_first_of('=');
-		if (del == std::string::npos) {
-			fields_[temp] = {};
-		} else {
-			const auto lhs = temp.substr(0, del);
-			auto rhs = temp.substr(del + 1);
-			if (lhs == L"uid") {
-				rhs = rhs.substr(7, rhs.size() - 8);
-			}
-			if (lhs == L"path") {
-				rhs = rhs.substr(7, rhs.size() - 8);
-			}
-			if (lhs == L"id" || lhs == L"type" || lhs == L"parent" || lhs == L"name") {
-				rhs = rhs.substr(1, rhs.size() - 2);
+			line_.push_back(static_cast<wchar_t>(c));
+			if (value_start == std::wstring::npos) {
+				if (c == '=')
+					value_start = line_.size() + 1;
+				continue;
 			}
-			if (lhs == L"instance") {
-				rhs = rhs.substr(13, rhs.size() - 15);
+			if (cap != 0 && line_.size() > value_start + cap) {
+				skip_value(field, value_start);
+				return true;
 			}
-			fields_[lhs] = rhs;
 		}
 
-		return true;
-	}
-
-	bool dott_parser::next_node_field() {
-		if (in_.eof() || in_.bad())
-			return false;
-		
-		std::wstring temp;
-		std::getline(in_, temp);
-
-		if (temp.empty())
+		if (line_.empty())
 			return false;
 
-		auto del = temp.find_first_of('=');
+		auto del = line_.find_first_of('=');
 		if (del == std::string::npos)
 			return false;
 
-		node_field_ = {temp.substr(0, del - 1), temp.substr(del + 2)};
+		// assigned in place, the pair keeps its capacity from one property to the next
+		field.first.assign(line_, 0, del - 1);
+		field.second.assign(line_, del + 2);
+		++field_count_;
 
 		return true;
 	}
 
-	bool dott_parser::next_resource_field() {
-		if (in_.eof() || in_.bad())
-			return false;
-		
-		std::wstring temp;
-		std::getline(in_, temp);
+	namespace {
 
-		if (temp.empty())
-			return false;
+		// scalars per element of the packed vector types, so counts come out in vectors
+		std::size_t packed_components(std::wstring_view type) {
+			if (type == L"PackedVector2Array") return 2;
+			if (type == L"PackedVector3Array") return 3;
+			if (type == L"PackedVector4Array" || type == L"PackedColorArray") return 4;
+			return 1;
+		}
 
-		auto del = temp.find_first_of('=');
-		if (del == std::string::npos)
-			return false;
+	} // namespace
+
+	std::wstring summarize_value(std::wstring_view type, std::size_t elements, std::uint64_t bytes) {
+		std::wstring s(type);
+		s += L" (";
+		if (elements != summary_no_count)
+			s += std::to_wstring(elements) + L" elements, ";
+		if (bytes < 1024) s += std::to_wstring(bytes) + L" B";
+		else if (bytes < 1024 * 1024) s += std::to_wstring((bytes + 512) / 1024) + L" KiB";
+		else s += std::to_wstring((bytes + 512 * 1024) / (1024 * 1024)) + L" MiB";
+		s += L")";
+		return s;
+	}
 
-		res_field_ = {temp.substr(0, del - 1), temp.substr(del + 2)};
+	// the value in line_ from value_start on already went over the cap; instead of copying the
+	// rest it is scanned once for its top level element count and replaced by a summary
+	void dott_parser::skip_value(std::pair<std::wstring, std::wstring>& field, std::size_t value_start) {
+		const std::wstring_view head = std::wstring_view(line_).substr(value_start);
+
+		std::size_t depth = 0;
+		std::size_t separators = 0;
+		bool in_string = false;
+		bool has_items = false;
+		std::uint64_t length = 0;
+		// everything before the first bracket, the head may have cut it short
+		auto& type = value_type_;
+		type.clear();
+		wchar_t opener = 0;
+		const auto scan = [&](wchar_t c) {
+			++length;
+			if (!opener) {
+				if (c == '(' || c == '[' || c == '{') opener = c;
+				else if (!std::iswspace(c)) type.push_back(c);
+			}
+			if (in_string) {
+				if (c == '"') in_string = false;
+				return;
+			}
+			switch (c) {
+			case '"': in_string = true; has_items |= depth == 1; break;
+			case '(': case '[': case '{': ++depth; break;
+			case ')': case ']': case '}': if (depth) --depth; break;
+			case ',': if (depth == 1) ++separators; break;
+			default: has_items |= depth == 1 && !std::iswspace(c); break;
+			}
+		};
+
+		for (const auto c : head) scan(c);
+		auto* buf = in_.rdbuf();
+		for (;;) {
+			const auto c = buf->sbumpc();
+			if (c == WEOF) {
+				in_.setstate(std::ios::eofbit);
+				break;
+			}
+			if (c == '\n')
+				break;
+			scan(static_cast<wchar_t>(c));
+		}
 
-		return true;
+		const auto elements = has_items ? (separators + 1) / packed_components(type) : 0;
+		std::wstring_view kind = L"Value";
+		if (!type.empty() && opener)
+			kind = type;
+		else if (opener == '[')
+			kind = L"Array";
+		else if (opener == '{')
+			kind = L"Dictionary";
+
+		const auto del = value_start - 2;
+		field.first.assign(line_, 0, del > 0 ? del - 1 : 0);
+		field.second = summarize_value(kind, opener ? elements : summary_no_count, length);
+		++field_count_;
+	}
+
+	std::shared_ptr<script_file> dott_parser::resolve_script(const link_context& ctx) {
+		return std::static_pointer_cast<script_file>(ctx.resolve(invalid_uid, fields_.get(field_key::path), file_kind::script));
+	}
+
+	std::shared_ptr<scene_file> dott_parser::resolve_packed_scene(const link_context& ctx) {
+		return std::static_pointer_cast<scene_file>(ctx.resolve(decode_uid(fields_.get(field_key::uid)), fields_.get(field_key::path), file_kind::scene));
+	}
+
+	std::shared_ptr<resource_file> dott_parser::resolve_resource(const link_context& ctx) {
+		return std::static_pointer_cast<resource_file>(ctx.resolve(decode_uid(fields_.get(field_key::uid)), fields_.get(field_key::path), file_kind::resource));
 	}
 
 	// TODO think of a more sophisticated validation lul
 	bool dott_parser::validate_scene_header() {
-		return fields_.find(L"gd_scene") != fields_.end()
-			&& fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty();
+		return fields_.get_kind() == section_kind::gd_scene
+			&& decode_uid(fields_.get(field_key::uid)) != invalid_uid;
 	}
 
 	bool dott_parser::validate_resource_header() {
-		return fields_.find(L"gd_resource") != fields_.end()
-			&& fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty();
+		return fields_.get_kind() == section_kind::gd_resource
+			&& decode_uid(fields_.get(field_key::uid)) != invalid_uid;
 	}
 
 	bool dott_parser::validate_ext_resource_type() {
-		return fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty();
+		return fields_.has_value(field_key::type);
 	}
 
+	// the uid is optional, files saved without one are resolved by path
 	bool dott_parser::validate_ext_resource_packed_scene() {
-		return fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty()
-			&& fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty() 
-			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
+		return fields_.has_value(field_key::path) && fields_.has_value(field_key::id);
 	}
 
 	bool dott_parser::validate_ext_resource_resource() {
-		return fields_.find(L"uid") != fields_.end() && !fields_[L"uid"].empty()
-			&& fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty() 
-			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
+		return fields_.has_value(field_key::path) && fields_.has_value(field_key::id);
 	}
 
 	bool dott_parser::validate_ext_resource_script() {
-		return fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty()
-			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
+		return fields_.has_value(field_key::path) && fields_.has_value(field_key::id);
 	}
 
 	bool dott_parser::validate_ext_resource_other() {
-		return fields_.find(L"path") != fields_.end() && !fields_[L"path"].empty()
-			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
+		return fields_.has_value(field_key::path) && fields_.has_value(field_key::id);
 	}
 
 	bool dott_parser::validate_sub_resource() {
-		return fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty()
-			&& fields_.find(L"id") != fields_.end() && !fields_[L"id"].empty();
+		return fields_.has_value(field_key::type) && fields_.has_value(field_key::id);
 	}
 
 	bool dott_parser::validate_node() {
-		return fields_.find(L"name") != fields_.end() && !fields_[L"name"].empty()
-			&& (fields_.find(L"type") != fields_.end() && !fields_[L"type"].empty()
-			|| fields_.find(L"instance") != fields_.end() && !fields_[L"instance"].empty());
+		return fields_.has_value(field_key::name)
+			&& (fields_.has_value(field_key::type) || fields_.has_value(field_key::instance));
 	}
 
-	script_parser::script_parser(const std::shared_ptr<script_file>& file)
-		: file_(file) {
+	script_parser::script_parser(const std::shared_ptr<script_file>& file, const cancel_token* cancel)
+		: file_(file), cancel_(cancel), line_(arena_.resource()) {
 		in_.open(file_->get_path(), std::ios::in | std::ios::binary);
 		if (!in_.is_open()) {
-			std::cerr << "[ERROR] could not open file: " << file_->get_path() << '\n';
+			DOCS_GEN_LOG_ERROR(parse, "could not open file: ", file_->get_path());
 			return;
 		}
 	}
 
 	bool script_parser::parse() {
-		std::wstring line;
+		auto& line = line_;
 		script_class sc{};
 		while (std::getline(in_, line)) {
+			if (cancel_())
+				return false;
 			if (line.empty())
 				continue;
 
 			if (line.find(L"extends") != std::string::npos) {
-				sc.parent = line.substr(8);
+				sc.parent = tail(line, 8);
 				continue;
 			}
 
 			if (line.find(L"#CLASS") != std::string::npos) {
-				sc.short_desc = line.substr(7);
+				sc.short_desc = tail(line, 7);
 				continue;
 			}
 			
 			if (line.find(L"class_name") != std::string::npos) {
-				sc.name = line.substr(11);
+				sc.name = tail(line, 11);
 				continue;
 			}
 
@@ -580,7 +926,7 @@ namespace docs_gen_core {
 					sc.categories.emplace_back(script_class::export_category{ {}, {} });
 				}
 				auto& cat = sc.categories.back();
-				auto var_desc = line.substr(5);
+				std::wstring var_desc{ tail(line, 5) };
 
 				std::getline(in_, line);
 				if (line.find(L"@export var") == std::string::npos) {
@@ -588,8 +934,8 @@ namespace docs_gen_core {
 				}
 
 				auto v = extract_variable(line);
-				v.short_desc = var_desc;
-				cat.variables.emplace_back(v);
+				v.short_desc = std::move(var_desc);
+				cat.variables.emplace_back(std::move(v));
 				
 				continue;
 			}
@@ -604,15 +950,15 @@ namespace docs_gen_core {
 			}
 
 			if (line.find(L"#FUNC") != std::string::npos) {
-				auto func_desc = line.substr(6);
+				std::wstring func_desc{ tail(line, 6) };
 
 				std::getline(in_, line);
 				if (line.find(L"func") == std::string::npos) {
 					return false;
 				}
 				auto f = extract_function(line);
-				f.short_desc = func_desc;
-				sc.functions.emplace_back(f);
+				f.short_desc = std::move(func_desc);
+				sc.functions.emplace_back(std::move(f));
 				continue;
 			}
 
@@ -624,18 +970,45 @@ namespace docs_gen_core {
 		return true;
 	}
 
-	std::wstring script_parser::extract_category_name(const std::wstring& s) {
-		std::wstring res;
+	bool script_parser::parse_declaration(std::wstring& class_name, std::wstring& extends) {
+		auto& line = line_;
+		while (std::getline(in_, line)) {
+			if (line.find(L"extends") != std::string::npos) {
+				extends = tail(line, 8);
+				continue;
+			}
+
+			if (line.find(L"#CLASS") != std::string::npos)
+				continue;
+
+			if (line.find(L"class_name") != std::string::npos) {
+				class_name = tail(line, 11);
+				continue;
+			}
+
+			// the declaration a doc comment belongs to is consumed with it
+			const bool var_doc = line.find(L"#VAR") != std::string::npos;
+			const bool func_doc = !var_doc && line.find(L"#FUNC") != std::string::npos;
+			if (var_doc || func_doc) {
+				std::getline(in_, line);
+				if (line.find(var_doc ? L"@export var" : L"func") == std::string::npos)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	std::wstring script_parser::extract_category_name(std::wstring_view s) {
 		std::size_t start = s.find_first_of('"');
 		std::size_t stop = s.find_last_of('"');
-		return s.substr(start + 1, stop - start - 1);
+		return std::wstring{ s.substr(start + 1, stop - start - 1) };
 	}
 
-	void script_parser::extract_and_push_tags(const std::wstring& s, std::vector<std::wstring>& tags) {
+	void script_parser::extract_and_push_tags(std::wstring_view s, std::vector<std::wstring>& tags) {
 		std::wstring token;
 		for (std::size_t i = 6; i < s.size(); ++i) {
 			if (s[i] == ',') {
-				tags.emplace_back(token);
+				tags.emplace_back(std::move(token));
 				token.clear();
 				i += 1;
 				continue;
@@ -644,10 +1017,10 @@ namespace docs_gen_core {
 			token += s[i];
 		}
 
-		tags.emplace_back(token);
+		tags.emplace_back(std::move(token));
 	}
 
-	script_class::variable script_parser::extract_variable(const std::wstring& s) {
+	script_class::variable script_parser::extract_variable(std::wstring_view s) {
 		std::wstring name, type;
 		std::size_t i;
 		for (i = 12; i < s.size() && s[i] != ':'; ++i) {
@@ -665,7 +1038,7 @@ namespace docs_gen_core {
 		return {name, type, {}};
 	}
 
-	script_class::function script_parser::extract_function(const std::wstring& s) {
+	script_class::function script_parser::extract_function(std::wstring_view s) {
 		script_class::function res;
 
 		std::size_t i;
@@ -697,24 +1070,25 @@ namespace docs_gen_core {
 		return res;
 	}
 
-	std::size_t script_parser::extract_and_push_function_arguments(const std::wstring& s, std::size_t args_start,
+	std::size_t script_parser::extract_and_push_function_arguments(std::wstring_view s, std::size_t args_start,
 		std::vector<script_class::variable>& vars) {
 		std::size_t args_end = s.find(')', args_start);
 
-		std::vector<std::wstring> args;
-		util::split_by(s.substr(args_start, args_end - args_start), ',', args);
-		for (const auto& arg : args) {
-			std::size_t delim = arg.find(':');
-			if (delim == std::string::npos) {
-				vars.emplace_back(script_class::variable{arg, {}, {}});
-			}
-			else {
-				vars.emplace_back(script_class::variable{
-					arg.substr(0, delim),
-					arg.substr(delim + 1),
-					{}
-				});
-			}
+		// split on ',' as util::split_by did, as views into the line; a trailing empty argument is dropped
+		const auto args = s.substr(std::min(args_start, s.size()), args_end - args_start);
+		for (std::size_t from = 0;;) {
+			const auto to = std::min(args.find(',', from), args.size());
+			const auto arg = args.substr(from, to - from);
+			const bool last = to == args.size();
+			const std::size_t delim = arg.find(':');
+			auto name = squeeze(arg.substr(0, delim));
+			if (delim != std::wstring_view::npos)
+				vars.emplace_back(script_class::variable{ std::move(name), squeeze(arg.substr(delim + 1)), {} });
+			else if (!last || !name.empty())
+				vars.emplace_back(script_class::variable{ std::move(name), {}, {} });
+			if (last)
+				break;
+			from = to + 1;
 		}
 
 		return args_end + 1;
@@ -2,52 +2,145 @@
 #define DOCS_GEN_PARSER_H
 
 #include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <unordered_map>
 
+#include "arena.hpp"
+#include "cancel.hpp"
 #include "file.hpp"
+#include "path_resolver.hpp"
+#include "section.hpp"
+#include "thread_pool.hpp"
+#include "uid.hpp"
 
 namespace docs_gen_core {
 
+	// cross-file tables the contents of a scene or resource get linked against
+	struct link_context {
+		const uid_map<std::shared_ptr<scene_file>>& scene_files;
+		const uid_map<std::shared_ptr<resource_file>>& resource_files;
+		const path_resolver& paths;
+		// indexed by file id
+		const std::vector<std::shared_ptr<file>>& files;
+
+		// by uid first, then by res:// path; null when nothing of that kind is indexed there
+		[[nodiscard]] std::shared_ptr<file> resolve(std::uint64_t uid, std::wstring_view path, file_kind kind) const;
+	};
+
+	struct parse_options {
+		// property values longer than this many bytes are summarized instead of copied,
+		// 0 keeps every value whole
+		std::size_t max_value_bytes = 0;
+		// how many files the read-ahead thread may run past the parsers, 0 turns it off
+		std::size_t prefetch_depth = 8;
+		// nodes keep the text of their plain properties (transforms, colors, numbers, ...) for the
+		// scene pages, see node_tree::tree_node::properties
+		bool node_properties = false;
+		// text scenes of at least twice this many bytes have their body cut at section boundaries
+		// into chunks of about this size, tokenized in parallel when the parser has a thread pool;
+		// 0 reads every file in one piece
+		std::uint64_t split_bytes = 16 * 1024 * 1024;
+		// not owned; polled between sections, nodes and properties, a parse that sees it expire
+		// stops where it is and returns false, leaving the file half read
+		const cancel_token* cancel = nullptr;
+	};
+
+	constexpr std::size_t summary_no_count = static_cast<std::size_t>(-1);
+	// "PackedVector3Array (10000 elements, 242 KiB)", what stands in for a value that was not kept
+	[[nodiscard]] std::wstring summarize_value(std::wstring_view type, std::size_t elements, std::uint64_t bytes);
+
+	// from, then the offsets of the section headers ('[' starting a line, outside strings and
+	// brackets) that cut [from, end of file) into pieces of at least chunk_bytes, then the file size;
+	// empty when the file can not be read
+	[[nodiscard]] std::vector<std::uint64_t> find_section_cuts(const std::filesystem::path& path, std::uint64_t from, std::uint64_t chunk_bytes);
+
+	// one parser can be reopened on file after file; the section and property buffers keep their
+	// capacity, so a thread that reuses its parser stops allocating for them after the first files
 	class dott_parser {
-	public:
-		using fields_type = std::unordered_map<std::wstring, std::wstring>;
+		// a node section of a split scene, read on a worker and linked into the tree in file order
+		struct pending_node {
+			std::shared_ptr<node_tree::tree_node> node;
+			std::wstring parent;
+			// properties read for it, counted only once it is linked
+			std::size_t fields = 0;
+		};
 
-	private:
-		std::filesystem::path root_path_;
 		std::shared_ptr<dott_file> file_;
+		parse_options options_;
+		// not owned, the chunks of a split scene are tokenized on it
+		thread_pool* pool_ = nullptr;
 
+		// the scratch below stays with the parser each thread reopens for every file, so it grows to
+		// the largest section once; it is not on the arena, which is released after every file
 		std::wifstream in_;
-		std::wistringstream iss_;
-		fields_type fields_;
+		// the stream reads into this instead of a buffer of its own per open
+		std::unique_ptr<wchar_t[]> stream_buf_;
+		std::wstring section_text_;
+		section_fields fields_;
+		std::wstring line_;
 		std::pair<std::wstring, std::wstring> node_field_;
 		std::pair<std::wstring, std::wstring> res_field_;
+		// type name of a value being summarized
+		std::wstring value_type_;
+		std::size_t section_count_ = 0;
+		std::size_t node_count_ = 0;
+		std::size_t field_count_ = 0;
+		// the links pass stopped on a section the body pass has to start from
+		bool pending_ = false;
+		// offset of the '[' of the current section
+		std::uint64_t section_start_ = 0;
+		// next_entry ends at the first section starting at or after this offset, 0 reads to the end
+		std::uint64_t stop_at_ = 0;
+		cancel_poll cancel_;
 
 	public:
-		explicit dott_parser(const std::shared_ptr<dott_file>& file);
-
-		[[nodiscard]] const fields_type& get_fields() const { return fields_; }
+		dott_parser();
+		explicit dott_parser(const std::shared_ptr<dott_file>& file, const parse_options& options = {});
+
+		// starts over on file
+		void open(const std::shared_ptr<dott_file>& file, const parse_options& options = {});
+		// closes the stream and lets go of the file, the buffers stay
+		void close();
+		// large scene bodies are split across pool when set, see parse_options::split_bytes
+		void set_thread_pool(thread_pool* pool) { pool_ = pool; }
+
+		[[nodiscard]] const section_fields& get_fields() const { return fields_; }
+		[[nodiscard]] std::size_t get_section_count() const { return section_count_; }
+		[[nodiscard]] std::size_t get_node_count() const { return node_count_; }
+		// node and resource properties read so far
+		[[nodiscard]] std::size_t get_field_count() const { return field_count_; }
 
 		bool parse_scene_header();
 		bool parse_resource_header();
-		bool parse_scene_file_contents(
-			const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files);
-		bool parse_resource_file_contents(
-			const std::unordered_map<std::wstring, std::shared_ptr<scene_file>>& scene_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<script_file>>& script_files,
-			const std::unordered_map<std::wstring, std::shared_ptr<resource_file>>& resource_files);
+		// links + body
+		bool parse_scene_file_contents(const link_context& ctx);
+		bool parse_resource_file_contents(const link_context& ctx);
 
-		void set_root_path(const std::filesystem::path& path) { root_path_ = path; }
+		// the ext_resource sections only, enough to know every edge of the file
+		bool parse_scene_links(const link_context& ctx);
+		bool parse_resource_links(const link_context& ctx);
+		// nodes, sub_resources and properties, linked against the ext_resources already pushed
+		bool parse_scene_body();
+		bool parse_resource_body();
 
 	private:
 		bool next_entry();
-		bool next_field();
+		void push_field(std::wstring_view token);
 		bool next_node_field();
 		bool next_resource_field();
+		bool next_property(std::pair<std::wstring, std::wstring>& field);
+		// node_field_ into the ext_resource fields or properties of node
+		void push_node_field(node_tree::tree_node& node, const scene_file& file);
+		// the body from body_start on in chunks on pool_, then their nodes into the tree in order
+		bool parse_scene_body_split(scene_file& file, std::uint64_t body_start);
+		// the node sections from the current position up to stop_at_, unlinked
+		void read_pending_nodes(const scene_file& file, std::vector<pending_node>& nodes);
+		void skip_value(std::pair<std::wstring, std::wstring>& field, std::size_t value_start);
+
+		std::shared_ptr<script_file> resolve_script(const link_context& ctx);
+		std::shared_ptr<scene_file> resolve_packed_scene(const link_context& ctx);
+		std::shared_ptr<resource_file> resolve_resource(const link_context& ctx);
 		
 		bool validate_scene_header();
 		bool validate_resource_header();
@@ -60,20 +153,29 @@ namespace docs_gen_core {
 		bool validate_node();
 	};
 
+	// the line buffer lives on the thread's arena and arguments are split as views into it, only
+	// what goes into the script_class is built as std::wstring
 	class script_parser {
 		std::shared_ptr<script_file> file_;
 		std::wifstream in_;
+		cancel_poll cancel_;
+		arena_scope arena_;
+		std::pmr::wstring line_;
 
 	public:
-		explicit script_parser(const std::shared_ptr<script_file>& file);
+		// cancel is polled per line, not owned
+		explicit script_parser(const std::shared_ptr<script_file>& file, const cancel_token* cancel = nullptr);
+		// false on a malformed doc comment, or when cancelled before the class was set
 		bool parse();
+		// the class_name and extends lines only, as parse() would read them
+		bool parse_declaration(std::wstring& class_name, std::wstring& extends);
 
 	private:
-		std::wstring extract_category_name(const std::wstring& s);
-		void extract_and_push_tags(const std::wstring& s, std::vector<std::wstring>& tags);
-		script_class::variable extract_variable(const std::wstring& s);
-		script_class::function extract_function(const std::wstring& s);
-		std::size_t extract_and_push_function_arguments(const std::wstring& s, std::size_t args_start, std::vector<script_class::variable>& vars);
+		std::wstring extract_category_name(std::wstring_view s);
+		void extract_and_push_tags(std::wstring_view s, std::vector<std::wstring>& tags);
+		script_class::variable extract_variable(std::wstring_view s);
+		script_class::function extract_function(std::wstring_view s);
+		std::size_t extract_and_push_function_arguments(std::wstring_view s, std::size_t args_start, std::vector<script_class::variable>& vars);
 	};
 
 } // docs_gen_core
@@ -0,0 +1,108 @@
+#include "path_resolver.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::uint64_t fnv_offset = 14695981039346656037ull;
+		constexpr std::uint64_t fnv_prime = 1099511628211ull;
+
+		template <typename Char>
+		char to_key_char(Char c) {
+			const auto b = static_cast<char>(static_cast<unsigned char>(c));
+			return b == '\\' ? '/' : b;
+		}
+
+		template <typename Char>
+		std::uint64_t hash_key(const Char* s, std::size_t n) {
+			auto h = fnv_offset;
+			for (std::size_t i = 0; i < n; ++i) {
+				h ^= static_cast<unsigned char>(to_key_char(s[i]));
+				h *= fnv_prime;
+			}
+			return h;
+		}
+
+		template <typename Char>
+		void strip_scheme(const Char*& s, std::size_t& n) {
+			constexpr char scheme[] = "res://";
+			constexpr std::size_t scheme_size = sizeof(scheme) - 1;
+			if (n < scheme_size) return;
+			for (std::size_t i = 0; i < scheme_size; ++i) {
+				if (s[i] != static_cast<Char>(scheme[i])) return;
+			}
+			s += scheme_size;
+			n -= scheme_size;
+		}
+
+	} // namespace
+
+	void path_resolver::build(const std::filesystem::path& root, const std::vector<std::shared_ptr<file>>& files) {
+		clear();
+
+		std::size_t capacity = 16;
+		while (capacity < files.size() * 2) capacity <<= 1;
+		slots_.assign(capacity, { 0, 0, 0, empty });
+
+		for (const auto& f : files) {
+			if (!f) continue;
+			insert(normalize(root, f->get_path()), static_cast<std::uint32_t>(f->get_id()));
+		}
+	}
+
+	void path_resolver::clear() {
+		slots_.clear();
+		keys_.clear();
+		size_ = 0;
+	}
+
+	std::size_t path_resolver::resolve(std::string_view res_path) const {
+		auto s = res_path.data();
+		auto n = res_path.size();
+		strip_scheme(s, n);
+		return find(s, n);
+	}
+
+	std::size_t path_resolver::resolve(std::wstring_view res_path) const {
+		auto s = res_path.data();
+		auto n = res_path.size();
+		strip_scheme(s, n);
+		return find(s, n);
+	}
+
+	std::string path_resolver::normalize(const std::filesystem::path& root, const std::filesystem::path& p) {
+		return p.lexically_relative(root).generic_u8string();
+	}
+
+	template <typename Char>
+	std::size_t path_resolver::find(const Char* s, std::size_t n) const {
+		if (slots_.empty()) return file::npos;
+
+		const auto h = hash_key(s, n);
+		const auto mask = slots_.size() - 1;
+		for (auto i = static_cast<std::size_t>(h) & mask; ; i = (i + 1) & mask) {
+			const auto& sl = slots_[i];
+			if (sl.id == empty) return file::npos;
+			if (sl.hash != h || sl.key_size != n) continue;
+
+			const auto* key = keys_.data() + sl.key_offset;
+			std::size_t j = 0;
+			while (j < n && key[j] == to_key_char(s[j])) ++j;
+			if (j == n) return sl.id;
+		}
+	}
+
+	void path_resolver::insert(const std::string& key, std::uint32_t id) {
+		const auto h = hash_key(key.data(), key.size());
+		const auto mask = slots_.size() - 1;
+		auto i = static_cast<std::size_t>(h) & mask;
+		while (slots_[i].id != empty) {
+			i = (i + 1) & mask;
+		}
+
+		slots_[i] = { h, static_cast<std::uint32_t>(keys_.size()), static_cast<std::uint32_t>(key.size()), id };
+		keys_ += key;
+		++size_;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,59 @@
+#ifndef DOCS_GEN_PATH_RESOLVER_H
+#define DOCS_GEN_PATH_RESOLVER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "file.hpp"
+
+namespace docs_gen_core {
+
+	// res:// path -> file id lookup, built once after indexing
+	//
+	// keys are the project relative paths in UTF-8 with '/' separators ("scenes/main.tscn"), stored
+	// back to back in one buffer and found through an open addressing table, so a lookup hashes and
+	// compares the characters it is given and never builds a std::filesystem::path or a string
+	class path_resolver {
+		struct slot {
+			std::uint64_t hash;
+			std::uint32_t key_offset;
+			std::uint32_t key_size;
+			std::uint32_t id;
+		};
+
+		static constexpr std::uint32_t empty = static_cast<std::uint32_t>(-1);
+
+		std::vector<slot> slots_;
+		std::string keys_;
+		std::size_t size_ = 0;
+
+	public:
+		path_resolver() = default;
+
+		// files must be indexed by their id (files[i]->get_id() == i), null entries are skipped
+		void build(const std::filesystem::path& root, const std::vector<std::shared_ptr<file>>& files);
+		void clear();
+
+		// accepts "res://a/b.gd" as well as the bare "a/b.gd", returns file::npos when unknown
+		[[nodiscard]] std::size_t resolve(std::string_view res_path) const;
+		// wide characters are taken as the bytes they were widened from
+		[[nodiscard]] std::size_t resolve(std::wstring_view res_path) const;
+
+		[[nodiscard]] std::size_t size() const { return size_; }
+
+		// the key under which a file below root is stored
+		[[nodiscard]] static std::string normalize(const std::filesystem::path& root, const std::filesystem::path& p);
+
+	private:
+		template <typename Char>
+		[[nodiscard]] std::size_t find(const Char* s, std::size_t n) const;
+		void insert(const std::string& key, std::uint32_t id);
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PATH_RESOLVER_H
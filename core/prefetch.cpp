@@ -0,0 +1,130 @@
+#include "prefetch.hpp"
+
+#include <algorithm>
+
+#ifdef WIN
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "trace.hpp"
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::size_t chunk_size = 256 * 1024;
+
+	} // namespace
+
+	prefetcher::prefetcher(std::vector<std::filesystem::path> paths, std::size_t depth, std::uint64_t max_bytes)
+		: paths_(std::move(paths)), depth_(depth), max_bytes_(max_bytes) {
+		if (!paths_.empty())
+			start();
+	}
+
+	prefetcher::~prefetcher() {
+		{
+			std::lock_guard lock(mutex_);
+			stopping_ = true;
+		}
+		cv_.notify_all();
+		if (reader_.joinable()) {
+			reader_.join();
+		}
+	}
+
+	void prefetcher::start() {
+		if (depth_ == 0)
+			return;
+
+		reader_ = std::thread([this] {
+			trace::set_thread_name("prefetch");
+			run();
+		});
+	}
+
+	std::size_t prefetcher::append(const std::vector<std::filesystem::path>& paths) {
+		std::size_t first = 0;
+		{
+			std::lock_guard lock(mutex_);
+			first = paths_.size();
+			paths_.insert(paths_.end(), paths.begin(), paths.end());
+		}
+		if (!reader_.joinable() && !paths.empty())
+			start();
+		else
+			cv_.notify_one();
+		return first;
+	}
+
+	void prefetcher::claim(std::size_t index) {
+		if (!reader_.joinable())
+			return;
+
+		{
+			std::lock_guard lock(mutex_);
+			if (index < claimed_)
+				return;
+			claimed_ = index + 1;
+		}
+		cv_.notify_one();
+	}
+
+	void prefetcher::run() {
+		// waits for appended files once it is through the ones it has, until the prefetcher goes away
+		for (std::size_t i = 0; ; ++i) {
+			std::filesystem::path path;
+			{
+				std::unique_lock lock(mutex_);
+				cv_.wait(lock, [&] { return stopping_ || (i < paths_.size() && i < claimed_ + depth_); });
+				if (stopping_)
+					return;
+				// a parser already has this one open, reading it now would only compete with it
+				if (i < claimed_)
+					continue;
+				path = paths_[i];
+			}
+			bytes_ += warm_file(path, max_bytes_);
+		}
+	}
+
+	std::uint64_t warm_file(const std::filesystem::path& path, std::uint64_t max_bytes) {
+		thread_local std::vector<char> buf(chunk_size);
+		const auto limit = max_bytes ? max_bytes : static_cast<std::uint64_t>(-1);
+		std::uint64_t total = 0;
+
+#ifdef WIN
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in.is_open())
+			return 0;
+
+		while (total < limit && in) {
+			const auto want = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size(), limit - total));
+			in.read(buf.data(), static_cast<std::streamsize>(want));
+			total += static_cast<std::uint64_t>(in.gcount());
+		}
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return 0;
+
+#ifdef POSIX_FADV_WILLNEED
+		::posix_fadvise(fd, 0, static_cast<off_t>(max_bytes), POSIX_FADV_WILLNEED);
+#endif
+		while (total < limit) {
+			const auto want = static_cast<std::size_t>(std::min<std::uint64_t>(buf.size(), limit - total));
+			const auto n = ::read(fd, buf.data(), want);
+			if (n <= 0)
+				break;
+			total += static_cast<std::uint64_t>(n);
+		}
+		::close(fd);
+#endif
+
+		return total;
+	}
+
+} // docs_gen_core
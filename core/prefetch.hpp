@@ -0,0 +1,59 @@
+#ifndef DOCS_GEN_PREFETCH_H
+#define DOCS_GEN_PREFETCH_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// reads files ahead of the parsers so their opens and reads hit the page cache
+	//
+	// one reader thread walks the files of a pass in order and stays at most depth files past the
+	// highest one a parser has claimed, reading each one through once; on posix a file is handed to
+	// posix_fadvise just before that read. the parsers still open their own streams, they just stop
+	// waiting on cold storage
+	class prefetcher {
+		std::vector<std::filesystem::path> paths_;
+		std::size_t depth_;
+		std::uint64_t max_bytes_;
+
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		// one past the highest index claimed so far
+		std::size_t claimed_ = 0;
+		bool stopping_ = false;
+		std::atomic<std::uint64_t> bytes_{ 0 };
+		std::thread reader_;
+
+	public:
+		// max_bytes limits how much of each file is read, 0 reads them whole; depth 0 disables the reader
+		prefetcher(std::vector<std::filesystem::path> paths, std::size_t depth, std::uint64_t max_bytes = 0);
+		prefetcher(const prefetcher&) = delete;
+		prefetcher& operator=(const prefetcher&) = delete;
+		~prefetcher();
+
+		// more files after the ones already given, for passes that find their files as they go;
+		// returns the index of the first of them. called between rounds of claims, never while a
+		// parser may be claiming
+		std::size_t append(const std::vector<std::filesystem::path>& paths);
+		// a parser is about to open paths[index]
+		void claim(std::size_t index);
+
+		[[nodiscard]] std::uint64_t bytes_read() const { return bytes_.load(); }
+
+	private:
+		void start();
+		void run();
+	};
+
+	// reads up to max_bytes (0 for all) of path and drops them, returns the bytes read
+	std::uint64_t warm_file(const std::filesystem::path& path, std::uint64_t max_bytes);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PREFETCH_H
@@ -0,0 +1,275 @@
+#include "property_value.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		struct constructor {
+			std::wstring_view name;
+			// scalars per value, per element for packed arrays
+			std::size_t components;
+			bool packed;
+		};
+
+		constexpr std::array<constructor, 25> constructors = { {
+			{ L"Vector2", 2, false },
+			{ L"Vector2i", 2, false },
+			{ L"Vector3", 3, false },
+			{ L"Vector3i", 3, false },
+			{ L"Vector4", 4, false },
+			{ L"Vector4i", 4, false },
+			{ L"Rect2", 4, false },
+			{ L"Rect2i", 4, false },
+			{ L"Plane", 4, false },
+			{ L"Quaternion", 4, false },
+			{ L"Color", 4, false },
+			{ L"AABB", 6, false },
+			{ L"Transform2D", 6, false },
+			{ L"Basis", 9, false },
+			{ L"Transform3D", 12, false },
+			{ L"Projection", 16, false },
+			{ L"PackedByteArray", 1, true },
+			{ L"PackedInt32Array", 1, true },
+			{ L"PackedInt64Array", 1, true },
+			{ L"PackedFloat32Array", 1, true },
+			{ L"PackedFloat64Array", 1, true },
+			{ L"PackedVector2Array", 2, true },
+			{ L"PackedVector3Array", 3, true },
+			{ L"PackedVector4Array", 4, true },
+			{ L"PackedColorArray", 4, true },
+		} };
+
+		const constructor* find_constructor(std::wstring_view name) {
+			for (const auto& c : constructors) {
+				if (c.name == name) return &c;
+			}
+			return nullptr;
+		}
+
+		bool is_space(wchar_t c) {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		std::wstring_view trim(std::wstring_view s) {
+			while (!s.empty() && is_space(s.front())) s.remove_prefix(1);
+			while (!s.empty() && is_space(s.back())) s.remove_suffix(1);
+			return s;
+		}
+
+		// longest number token worth reading, "-1.7976931348623157e+308" is 24
+		constexpr std::size_t max_token = 40;
+
+		// copies an ascii token into buf, false for anything else
+		bool narrow_token(std::wstring_view token, char (&buf)[max_token], std::size_t& n) {
+			if (token.empty() || token.size() >= max_token) return false;
+			for (n = 0; n < token.size(); ++n) {
+				if (token[n] >= 0x80) return false;
+				buf[n] = static_cast<char>(token[n]);
+			}
+			return true;
+		}
+
+		// godot writes inf, inf_neg and nan for the values a float can not spell with digits
+		bool parse_real(std::wstring_view token, double& out) {
+			if (token == L"inf") {
+				out = std::numeric_limits<double>::infinity();
+				return true;
+			}
+			if (token == L"inf_neg" || token == L"-inf") {
+				out = -std::numeric_limits<double>::infinity();
+				return true;
+			}
+			if (token == L"nan") {
+				out = std::numeric_limits<double>::quiet_NaN();
+				return true;
+			}
+
+			if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+			char buf[max_token];
+			std::size_t n = 0;
+			if (!narrow_token(token, buf, n)) return false;
+			const auto [end, ec] = std::from_chars(buf, buf + n, out);
+			return ec == std::errc{} && end == buf + n;
+		}
+
+		bool parse_integer(std::wstring_view token, std::int64_t& out) {
+			if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+			char buf[max_token];
+			std::size_t n = 0;
+			if (!narrow_token(token, buf, n)) return false;
+			const auto [end, ec] = std::from_chars(buf, buf + n, out);
+			return ec == std::errc{} && end == buf + n;
+		}
+
+		// the scalars between the parentheses of "Type(a, b, ...)"
+		template <typename Push>
+		bool parse_arguments(std::wstring_view args, Push&& push) {
+			args = trim(args);
+			while (!args.empty()) {
+				const auto comma = args.find(',');
+				const auto token = trim(args.substr(0, comma));
+				double d = 0.0;
+				if (!parse_real(token, d) || !push(d)) return false;
+				if (comma == std::wstring_view::npos) break;
+				args.remove_prefix(comma + 1);
+				// "1, 2," has nothing after the last separator
+				if (trim(args).empty()) return false;
+			}
+			return true;
+		}
+
+		// "..." or &"..." with no unescaped quote inside
+		bool parse_string(std::wstring_view s, std::wstring_view& text) {
+			if (!s.empty() && s.front() == '&') s.remove_prefix(1);
+			if (s.size() < 2 || s.front() != '"' || s.back() != '"') return false;
+			s = s.substr(1, s.size() - 2);
+			for (std::size_t i = 0; i < s.size(); ++i) {
+				if (s[i] == '\\') ++i;
+				else if (s[i] == '"') return false;
+			}
+			// a trailing backslash escaped the closing quote
+			if (!s.empty()) {
+				std::size_t slashes = 0;
+				while (slashes < s.size() && s[s.size() - 1 - slashes] == '\\') ++slashes;
+				if (slashes % 2) return false;
+			}
+			text = s;
+			return true;
+		}
+
+		void write_number(markdown_buffer& out, double d) {
+			if (std::isnan(d)) {
+				out.append(L"nan");
+				return;
+			}
+			if (std::isinf(d)) {
+				if (d > 0) out.append(L"inf");
+				else out.append(L"inf_neg");
+				return;
+			}
+
+			char buf[max_token];
+			const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), d);
+			wchar_t wide[max_token];
+			std::copy(buf, end, wide);
+			out.append(std::wstring_view(wide, static_cast<std::size_t>(end - buf)));
+		}
+
+		void write_numbers(markdown_buffer& out, std::wstring_view type, const double* first, std::size_t n) {
+			out.append(type, L'(');
+			for (std::size_t i = 0; i < n; ++i) {
+				if (i) out.append(L", ");
+				write_number(out, first[i]);
+			}
+			out.append(L')');
+		}
+
+	} // namespace
+
+	typed_value decode_value(std::wstring_view text) {
+		typed_value v;
+		text = trim(text);
+		if (text.empty())
+			return v;
+
+		if (text == L"null") {
+			v.kind = value_kind::null;
+			return v;
+		}
+		if (text == L"true" || text == L"false") {
+			v.kind = value_kind::boolean;
+			v.boolean = text.front() == 't';
+			return v;
+		}
+		if (text.front() == '"' || text.front() == '&') {
+			if (parse_string(text, v.text)) v.kind = value_kind::string;
+			return v;
+		}
+
+		const auto open = text.find('(');
+		if (open == std::wstring_view::npos) {
+			// integers unless they need a float to spell them
+			if (text.find_first_of(L".eEn") == std::wstring_view::npos && parse_integer(text, v.integer)) {
+				v.kind = value_kind::integer;
+			}
+			else if (parse_real(text, v.real)) {
+				v.kind = value_kind::real;
+			}
+			return v;
+		}
+
+		const auto* c = find_constructor(text.substr(0, open));
+		if (!c || text.back() != ')')
+			return v;
+
+		const auto args = text.substr(open + 1, text.size() - open - 2);
+		if (c->packed) {
+			v.elements.reserve(static_cast<std::size_t>(std::count(args.begin(), args.end(), L',')) + 1);
+			const bool parsed = parse_arguments(args, [&](double d) {
+				v.elements.push_back(d);
+				return true;
+			});
+			if (!parsed || v.elements.size() % c->components != 0) {
+				v.elements.clear();
+				return v;
+			}
+			v.kind = value_kind::packed;
+			v.components_per_element = c->components;
+		}
+		else {
+			const bool parsed = parse_arguments(args, [&](double d) {
+				if (v.component_count == c->components) return false;
+				v.components[v.component_count++] = d;
+				return true;
+			});
+			if (!parsed || v.component_count != c->components) {
+				v.component_count = 0;
+				return v;
+			}
+			v.kind = value_kind::math;
+		}
+		v.type = c->name;
+		return v;
+	}
+
+	void write_value(markdown_buffer& out, const typed_value& v) {
+		switch (v.kind) {
+		case value_kind::null:
+			out.append(L"null");
+			break;
+		case value_kind::boolean:
+			if (v.boolean) out.append(L"true");
+			else out.append(L"false");
+			break;
+		case value_kind::integer:
+			out.number(v.integer);
+			break;
+		case value_kind::real:
+			write_number(out, v.real);
+			break;
+		case value_kind::string:
+			out.append(L'"', v.text, L'"');
+			break;
+		case value_kind::math:
+			write_numbers(out, v.type, v.components.data(), v.component_count);
+			break;
+		case value_kind::packed:
+			if (v.elements.size() <= typed_value::max_components) {
+				write_numbers(out, v.type, v.elements.data(), v.elements.size());
+			}
+			else {
+				out.append(v.type, L" (").number(v.element_count()).append(L" elements)");
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+} // docs_gen_core
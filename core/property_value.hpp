@@ -0,0 +1,63 @@
+#ifndef DOCS_GEN_PROPERTY_VALUE_H
+#define DOCS_GEN_PROPERTY_VALUE_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "markdown.hpp"
+
+namespace docs_gen_core {
+
+	enum class value_kind : std::uint8_t {
+		// not decoded: references, node paths, arrays, dictionaries, summarized values
+		other,
+		null,
+		boolean,
+		integer,
+		real,
+		string,
+		// Vector2(...), Rect2i(...), Transform3D(...), Color(...) and the other math types
+		math,
+		// a Packed*Array(...) of numbers
+		packed
+	};
+
+	// a property value decoded from the text a .tscn/.tres holds, which is also what the binary
+	// reader writes for .scn/.res
+	//
+	// type and text point into that text, so it has to outlive the value
+	struct typed_value {
+		static constexpr std::size_t max_components = 16;
+
+		value_kind kind = value_kind::other;
+		// the constructor of math and packed values, "Vector2", "PackedColorArray"
+		std::wstring_view type;
+		// the contents of a string, escapes left as they are
+		std::wstring_view text;
+		bool boolean = false;
+		std::int64_t integer = 0;
+		double real = 0.0;
+		// math values, Transform3D is the basis column by column and then the origin
+		std::array<double, max_components> components{};
+		std::size_t component_count = 0;
+		// packed values, components_per_element scalars for each element
+		std::vector<double> elements;
+		std::size_t components_per_element = 1;
+
+		[[nodiscard]] std::size_t element_count() const { return elements.size() / components_per_element; }
+	};
+
+	// decodes text when it is called, nothing is kept; numbers go through std::from_chars on a
+	// small narrow copy of each token. text that is not one of the kinds above, or does not parse
+	// whole, comes back as value_kind::other
+	[[nodiscard]] typed_value decode_value(std::wstring_view text);
+
+	// v in the form godot writes it, numbers in their shortest round trip form; packed values
+	// longer than max_components scalars are written as their element count
+	void write_value(markdown_buffer& out, const typed_value& v);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_PROPERTY_VALUE_H
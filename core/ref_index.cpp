@@ -0,0 +1,82 @@
+#include "ref_index.hpp"
+
+#include <algorithm>
+
+namespace docs_gen_core {
+
+	void ref_index::build(const std::vector<std::shared_ptr<file>>& files) {
+		clear();
+		const auto n = files.size();
+		offsets_.assign(n + 1, 0);
+
+		// one pass over the forward edges, kept per source so the fill pass does not have to
+		// walk the hash maps again
+		std::vector<std::uint32_t> edge_offsets(n + 1, 0);
+		std::vector<std::uint32_t> edges;
+		std::vector<std::size_t> refs;
+		for (std::size_t from = 0; from < n; ++from) {
+			edge_offsets[from] = static_cast<std::uint32_t>(edges.size());
+			if (!files[from]) continue;
+
+			refs.clear();
+			collect_direct_references(*files[from], refs);
+			for (auto to : refs) {
+				if (to >= n || to == from) continue;
+				edges.push_back(static_cast<std::uint32_t>(to));
+				++offsets_[to + 1];
+			}
+		}
+		edge_offsets[n] = static_cast<std::uint32_t>(edges.size());
+
+		for (std::size_t i = 0; i < n; ++i) {
+			offsets_[i + 1] += offsets_[i];
+		}
+
+		referrers_.resize(edges.size());
+		std::vector<std::uint32_t> cursor(offsets_.begin(), offsets_.end() - 1);
+		for (std::size_t from = 0; from < n; ++from) {
+			for (auto e = edge_offsets[from]; e < edge_offsets[from + 1]; ++e) {
+				referrers_[cursor[edges[e]]++] = static_cast<std::uint32_t>(from);
+			}
+		}
+	}
+
+	void ref_index::clear() {
+		offsets_.clear();
+		referrers_.clear();
+	}
+
+	id_range ref_index::get_referrers(std::size_t id) const {
+		if (id + 1 >= offsets_.size()) return {};
+		return { referrers_.data() + offsets_[id], referrers_.data() + offsets_[id + 1] };
+	}
+
+	void collect_direct_references(const file& f, std::vector<std::size_t>& out) {
+		const auto first = out.size();
+
+		if (const auto* df = dynamic_cast<const dott_file*>(&f)) {
+			for (const auto& [_, s] : df->get_packed_scenes()) {
+				if (s) out.push_back(s->get_id());
+			}
+			for (const auto& [_, r] : df->get_ext_resources()) {
+				if (r) out.push_back(r->get_id());
+			}
+		}
+
+		if (const auto* sf = dynamic_cast<const scene_file*>(&f)) {
+			for (const auto& [_, s] : sf->get_scripts()) {
+				if (s) out.push_back(s->get_id());
+			}
+		}
+		else if (const auto* rf = dynamic_cast<const resource_file*>(&f)) {
+			for (const auto& [_, s] : rf->get_scripts()) {
+				if (s) out.push_back(s->get_id());
+			}
+		}
+
+		std::sort(out.begin() + first, out.end());
+		out.erase(std::unique(out.begin() + first, out.end()), out.end());
+		out.erase(std::remove(out.begin() + first, out.end(), file::npos), out.end());
+	}
+
+} // docs_gen_core
@@ -0,0 +1,52 @@
+#ifndef DOCS_GEN_REF_INDEX_H
+#define DOCS_GEN_REF_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "file.hpp"
+
+namespace docs_gen_core {
+
+	// contiguous view over a run of file ids inside one of the adjacency arrays
+	class id_range {
+		const std::uint32_t* begin_ = nullptr;
+		const std::uint32_t* end_ = nullptr;
+
+	public:
+		id_range() = default;
+		id_range(const std::uint32_t* begin, const std::uint32_t* end)
+			: begin_(begin), end_(end) {}
+
+		[[nodiscard]] const std::uint32_t* begin() const { return begin_; }
+		[[nodiscard]] const std::uint32_t* end() const { return end_; }
+		[[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(end_ - begin_); }
+		[[nodiscard]] bool empty() const { return begin_ == end_; }
+	};
+
+	// reverse edges of the reference graph ("who uses this file") stored as compressed
+	// adjacency arrays: referrers of file `id` are referrers_[offsets_[id] .. offsets_[id + 1])
+	class ref_index {
+		std::vector<std::uint32_t> offsets_;
+		std::vector<std::uint32_t> referrers_;
+
+	public:
+		ref_index() = default;
+
+		// files must be indexed by their id (files[i]->get_id() == i), null entries are skipped
+		void build(const std::vector<std::shared_ptr<file>>& files);
+		void clear();
+
+		[[nodiscard]] id_range get_referrers(std::size_t id) const;
+		[[nodiscard]] std::size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+		[[nodiscard]] std::size_t edge_count() const { return referrers_.size(); }
+	};
+
+	// appends the ids of every file directly referenced by f (packed scenes, scripts and
+	// external resources), each target at most once
+	void collect_direct_references(const file& f, std::vector<std::size_t>& out);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_REF_INDEX_H
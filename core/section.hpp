@@ -0,0 +1,205 @@
+#ifndef DOCS_GEN_SECTION_H
+#define DOCS_GEN_SECTION_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// the "[kind key=value ...]" headers of .tscn/.tres files
+
+	enum class section_kind : std::uint8_t {
+		gd_scene,
+		gd_resource,
+		ext_resource,
+		sub_resource,
+		node,
+		resource,
+		connection,
+		editable,
+		unknown,
+	};
+
+	enum class field_key : std::uint8_t {
+		uid,
+		path,
+		id,
+		type,
+		parent,
+		name,
+		instance,
+		instance_placeholder,
+		script_class,
+		load_steps,
+		format,
+		groups,
+		index,
+		owner,
+		unique_id,
+		signal,
+		from,
+		to,
+		method,
+		flags,
+		binds,
+		unknown,
+	};
+
+	namespace detail {
+
+		constexpr std::array<std::string_view, static_cast<std::size_t>(section_kind::unknown)> section_names = {
+			"gd_scene", "gd_resource", "ext_resource", "sub_resource", "node", "resource", "connection", "editable",
+		};
+
+		constexpr std::array<std::string_view, static_cast<std::size_t>(field_key::unknown)> field_names = {
+			"uid", "path", "id", "type", "parent", "name", "instance", "instance_placeholder", "script_class",
+			"load_steps", "format", "groups", "index", "owner", "unique_id", "signal", "from", "to", "method",
+			"flags", "binds",
+		};
+
+		template <typename Char>
+		constexpr std::uint32_t key_hash(const Char* s, std::size_t n, std::uint32_t seed) {
+			// seeded FNV-1a, the keys are plain ASCII so wide and narrow input hash alike
+			auto h = 2166136261u ^ seed;
+			for (std::size_t i = 0; i < n; ++i) {
+				h ^= static_cast<std::uint32_t>(s[i]) & 0xFFu;
+				h *= 16777619u;
+			}
+			return h ^ (h >> 15);
+		}
+
+		// a table of Size slots where every key of Keys lands in its own slot for the found seed,
+		// so a lookup is one hash, one slot read and one compare
+		template <std::size_t N, std::size_t Size>
+		struct perfect_hash {
+			static_assert((Size & (Size - 1)) == 0, "table size must be a power of two");
+			static constexpr std::uint8_t empty = 0xFF;
+
+			std::uint32_t seed = 0;
+			std::array<std::uint8_t, Size> slots{};
+
+			constexpr explicit perfect_hash(const std::array<std::string_view, N>& keys) {
+				for (std::uint32_t s = 1; s < 100000; ++s) {
+					if (try_seed(keys, s)) {
+						seed = s;
+						return;
+					}
+				}
+			}
+
+			template <typename Char>
+			[[nodiscard]] constexpr std::size_t find(const std::array<std::string_view, N>& keys, std::basic_string_view<Char> key) const {
+				const auto i = slots[key_hash(key.data(), key.size(), seed) & (Size - 1)];
+				if (i == empty) return N;
+
+				const auto& k = keys[i];
+				if (k.size() != key.size()) return N;
+				for (std::size_t j = 0; j < k.size(); ++j) {
+					if (static_cast<Char>(k[j]) != key[j]) return N;
+				}
+				return i;
+			}
+
+		private:
+			constexpr bool try_seed(const std::array<std::string_view, N>& keys, std::uint32_t s) {
+				for (auto& sl : slots) sl = empty;
+				for (std::size_t i = 0; i < N; ++i) {
+					auto& sl = slots[key_hash(keys[i].data(), keys[i].size(), s) & (Size - 1)];
+					if (sl != empty) return false;
+					sl = static_cast<std::uint8_t>(i);
+				}
+				return true;
+			}
+		};
+
+		constexpr perfect_hash<section_names.size(), 16> section_hash{ section_names };
+		constexpr perfect_hash<field_names.size(), 64> field_hash{ field_names };
+
+		static_assert(section_hash.seed != 0, "no perfect hash seed for the section kinds");
+		static_assert(field_hash.seed != 0, "no perfect hash seed for the field names");
+
+	} // detail
+
+	template <typename Char>
+	[[nodiscard]] constexpr section_kind to_section_kind(std::basic_string_view<Char> s) {
+		return static_cast<section_kind>(detail::section_hash.find(detail::section_names, s));
+	}
+
+	template <typename Char>
+	[[nodiscard]] constexpr field_key to_field_key(std::basic_string_view<Char> s) {
+		return static_cast<field_key>(detail::field_hash.find(detail::field_names, s));
+	}
+
+	[[nodiscard]] constexpr std::string_view to_string(section_kind k) {
+		return k == section_kind::unknown ? "unknown" : detail::section_names[static_cast<std::size_t>(k)];
+	}
+
+	[[nodiscard]] constexpr std::string_view to_string(field_key k) {
+		return k == field_key::unknown ? "unknown" : detail::field_names[static_cast<std::size_t>(k)];
+	}
+
+	// attributes of the current section; known keys sit in a fixed slot per field_key,
+	// anything else goes to the overflow list in the order it appeared
+	class section_fields {
+	public:
+		using overflow_type = std::vector<std::pair<std::wstring, std::wstring>>;
+
+	private:
+		static constexpr std::size_t field_count = static_cast<std::size_t>(field_key::unknown);
+		static_assert(field_count <= 32, "presence mask is 32 bits");
+
+		section_kind kind_ = section_kind::unknown;
+		std::uint32_t present_ = 0;
+		// slots keep their capacity across sections, only present_ says which are live
+		std::array<std::wstring, field_count> values_;
+		overflow_type overflow_;
+		std::size_t overflow_size_ = 0;
+
+		inline static const std::wstring empty_{};
+
+	public:
+		section_fields() = default;
+
+		void clear() {
+			kind_ = section_kind::unknown;
+			present_ = 0;
+			overflow_size_ = 0;
+		}
+
+		void set_kind(section_kind kind) { kind_ = kind; }
+		[[nodiscard]] section_kind get_kind() const { return kind_; }
+
+		void set(field_key key, std::wstring_view value) {
+			const auto i = static_cast<std::size_t>(key);
+			values_[i].assign(value.data(), value.size());
+			present_ |= 1u << i;
+		}
+
+		void push_unknown(std::wstring_view key, std::wstring_view value) {
+			if (overflow_size_ == overflow_.size()) overflow_.emplace_back();
+			auto& [k, v] = overflow_[overflow_size_++];
+			k.assign(key.data(), key.size());
+			v.assign(value.data(), value.size());
+		}
+
+		[[nodiscard]] bool has(field_key key) const {
+			return key != field_key::unknown && (present_ >> static_cast<std::size_t>(key) & 1u);
+		}
+		// present and not empty
+		[[nodiscard]] bool has_value(field_key key) const { return has(key) && !get(key).empty(); }
+		// empty string when absent
+		[[nodiscard]] const std::wstring& get(field_key key) const {
+			return has(key) ? values_[static_cast<std::size_t>(key)] : empty_;
+		}
+
+		[[nodiscard]] std::size_t overflow_size() const { return overflow_size_; }
+		[[nodiscard]] const std::pair<std::wstring, std::wstring>& get_overflow(std::size_t i) const { return overflow_[i]; }
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_SECTION_H
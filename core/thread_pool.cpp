@@ -0,0 +1,115 @@
+#include "thread_pool.hpp"
+
+#include <atomic>
+
+#include "trace.hpp"
+
+namespace docs_gen_core {
+
+	struct thread_pool::job {
+		const std::function<void(std::size_t)>* fn;
+		std::size_t count;
+		std::atomic<std::size_t> next{ 0 };
+		std::atomic<std::size_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+
+		// claims indices until there are none left, true if this call ran the last one
+		bool work() {
+			std::size_t ran = 0;
+			for (auto i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+				(*fn)(i);
+				++ran;
+			}
+			return ran != 0 && done.fetch_add(ran) + ran == count;
+		}
+
+		[[nodiscard]] bool exhausted() const { return next.load() >= count; }
+	};
+
+	thread_pool::thread_pool(std::size_t workers) {
+		workers_.reserve(workers);
+		for (std::size_t i = 0; i < workers; ++i) {
+			workers_.emplace_back([this, i] {
+				trace::set_thread_name("worker " + std::to_string(i));
+				run();
+			});
+		}
+	}
+
+	thread_pool::~thread_pool() {
+		{
+			std::lock_guard lock(mutex_);
+			stopping_ = true;
+		}
+		cv_.notify_all();
+		for (auto& w : workers_) {
+			w.join();
+		}
+	}
+
+	std::size_t thread_pool::default_workers() {
+		const auto hw = std::thread::hardware_concurrency();
+		return hw > 1 ? hw - 1 : 0;
+	}
+
+	void thread_pool::for_each(std::size_t count, const std::function<void(std::size_t)>& fn) {
+		if (count == 0) return;
+		if (workers_.empty() || count == 1) {
+			for (std::size_t i = 0; i < count; ++i) fn(i);
+			return;
+		}
+
+		auto j = std::make_shared<job>();
+		j->fn = &fn;
+		j->count = count;
+		{
+			std::lock_guard lock(mutex_);
+			jobs_.push_back(j);
+		}
+		cv_.notify_all();
+
+		if (j->work()) {
+			std::lock_guard lock(j->mutex);
+			j->finished.notify_all();
+		}
+
+		std::unique_lock lock(j->mutex);
+		j->finished.wait(lock, [&] { return j->done.load() == count; });
+	}
+
+	void thread_pool::run() {
+		for (;;) {
+			std::shared_ptr<job> j;
+			{
+				std::unique_lock lock(mutex_);
+				cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+				if (jobs_.empty()) return;
+
+				// leave the job queued while indices remain so other workers can join in
+				j = jobs_.front();
+				if (j->exhausted()) {
+					jobs_.pop_front();
+					continue;
+				}
+			}
+
+			if (j->work()) {
+				std::lock_guard lock(j->mutex);
+				j->finished.notify_all();
+			}
+
+			std::lock_guard lock(mutex_);
+			if (!jobs_.empty() && jobs_.front() == j) jobs_.pop_front();
+		}
+	}
+
+	void parallel_for(thread_pool* pool, std::size_t count, const std::function<void(std::size_t)>& fn) {
+		if (pool) {
+			pool->for_each(count, fn);
+			return;
+		}
+		for (std::size_t i = 0; i < count; ++i) fn(i);
+	}
+
+} // docs_gen_core
@@ -0,0 +1,53 @@
+#ifndef DOCS_GEN_THREAD_POOL_H
+#define DOCS_GEN_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// fixed set of workers that run index ranges of a callable
+	//
+	// the thread calling for_each always works on its own range too, so a task may call for_each
+	// again on the same pool (projects -> files) without starving the workers or deadlocking
+	class thread_pool {
+		struct job;
+
+		std::vector<std::thread> workers_;
+		std::deque<std::shared_ptr<job>> jobs_;
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		bool stopping_ = false;
+
+	public:
+		explicit thread_pool(std::size_t workers = default_workers());
+		thread_pool(const thread_pool&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		~thread_pool();
+
+		thread_pool& operator=(const thread_pool&) = delete;
+		thread_pool& operator=(thread_pool&&) = delete;
+
+		// calls fn(i) for every i in [0, count) and returns once all calls finished
+		void for_each(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+		[[nodiscard]] std::size_t worker_count() const { return workers_.size(); }
+		// hardware_concurrency() - 1, the thread calling for_each being the last one
+		[[nodiscard]] static std::size_t default_workers();
+
+	private:
+		void run();
+	};
+
+	// for_each on pool, or a plain loop without one
+	void parallel_for(thread_pool* pool, std::size_t count, const std::function<void(std::size_t)>& fn);
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_THREAD_POOL_H
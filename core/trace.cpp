@@ -0,0 +1,174 @@
+#include "trace.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace docs_gen_core::trace {
+
+	namespace {
+
+		struct thread_buffer {
+			std::uint32_t id;
+			std::string name;
+			std::vector<event> events;
+		};
+
+		// buffers outlive their threads so spans of finished workers still get written
+		struct registry {
+			std::mutex mutex;
+			std::vector<std::unique_ptr<thread_buffer>> buffers;
+		};
+
+		registry& get_registry() {
+			static registry r;
+			return r;
+		}
+
+		thread_buffer& local_buffer() {
+			thread_local thread_buffer* buf = nullptr;
+			if (!buf) {
+				auto& r = get_registry();
+				std::lock_guard lock{ r.mutex };
+				r.buffers.push_back(std::make_unique<thread_buffer>());
+				buf = r.buffers.back().get();
+				buf->id = static_cast<std::uint32_t>(r.buffers.size());
+			}
+			return *buf;
+		}
+
+		const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+		void write_json_string(std::ofstream& out, const char* s) {
+			out.put('"');
+			for (; *s; ++s) {
+				const auto c = static_cast<unsigned char>(*s);
+				if (c == '"' || c == '\\') {
+					out.put('\\');
+					out.put(static_cast<char>(c));
+				}
+				else if (c < 0x20) {
+					constexpr char hex[] = "0123456789abcdef";
+					out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+				}
+				else {
+					out.put(static_cast<char>(c));
+				}
+			}
+			out.put('"');
+		}
+
+		void write_micros(std::ofstream& out, std::uint64_t ns) {
+			out << ns / 1000 << '.';
+			const auto frac = ns % 1000;
+			if (frac < 100) out.put('0');
+			if (frac < 10) out.put('0');
+			out << frac;
+		}
+
+	} // namespace
+
+	namespace detail {
+
+		std::atomic<bool> enabled{ false };
+
+		std::uint64_t now_ns() {
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - epoch).count());
+		}
+
+		void record(event&& e) {
+			auto& buf = local_buffer();
+			e.thread = buf.id;
+			buf.events.push_back(std::move(e));
+		}
+
+	} // detail
+
+	void set_enabled(bool enabled) {
+		detail::enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void clear() {
+		auto& r = get_registry();
+		std::lock_guard lock{ r.mutex };
+		for (auto& buf : r.buffers) {
+			buf->events.clear();
+		}
+	}
+
+	std::size_t event_count() {
+		auto& r = get_registry();
+		std::lock_guard lock{ r.mutex };
+		std::size_t n = 0;
+		for (const auto& buf : r.buffers) {
+			n += buf->events.size();
+		}
+		return n;
+	}
+
+	void set_thread_name(const std::string& name) {
+		auto& buf = local_buffer();
+		auto& r = get_registry();
+		std::lock_guard lock{ r.mutex };
+		buf.name = name;
+	}
+
+	bool write_chrome_trace(const std::filesystem::path& path) {
+		std::ofstream out{ path, std::ios::out | std::ios::binary };
+		if (!out.is_open())
+			return false;
+
+		auto& r = get_registry();
+		std::lock_guard lock{ r.mutex };
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (const auto& buf : r.buffers) {
+			if (!buf->name.empty()) {
+				out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buf->id
+					<< ",\"args\":{\"name\":";
+				write_json_string(out, buf->name.c_str());
+				out << "}}";
+				first = false;
+			}
+
+			for (const auto& e : buf->events) {
+				out << (first ? "" : ",") << "\n{\"name\":";
+				write_json_string(out, e.name);
+				out << ",\"cat\":";
+				write_json_string(out, e.category);
+				out << ",\"ph\":\"X\",\"ts\":";
+				write_micros(out, e.start_ns);
+				out << ",\"dur\":";
+				write_micros(out, e.duration_ns);
+				out << ",\"pid\":1,\"tid\":" << e.thread;
+
+				if (e.arg_count || !e.detail.empty()) {
+					out << ",\"args\":{";
+					bool first_arg = true;
+					if (!e.detail.empty()) {
+						out << "\"file\":";
+						write_json_string(out, e.detail.c_str());
+						first_arg = false;
+					}
+					for (std::uint8_t i = 0; i < e.arg_count; ++i) {
+						out << (first_arg ? "" : ",");
+						write_json_string(out, e.args[i].first);
+						out << ':' << e.args[i].second;
+						first_arg = false;
+					}
+					out.put('}');
+				}
+				out.put('}');
+				first = false;
+			}
+		}
+		out << "\n]}\n";
+
+		return out.good();
+	}
+
+} // docs_gen_core::trace
@@ -0,0 +1,101 @@
+#ifndef DOCS_GEN_TRACE_H
+#define DOCS_GEN_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+
+// scoped timing spans written out in the Chrome trace-event format (chrome://tracing, Perfetto)
+//
+// recording is off until trace::set_enabled(true), a disabled span costs one relaxed atomic load;
+// defining DOCS_GEN_NO_TRACE removes the spans from the build entirely
+namespace docs_gen_core::trace {
+
+	constexpr std::size_t max_args = 4;
+
+	struct event {
+		const char* name;
+		const char* category;
+		std::uint64_t start_ns;
+		std::uint64_t duration_ns;
+		std::uint32_t thread;
+		std::uint8_t arg_count;
+		std::array<std::pair<const char*, std::uint64_t>, max_args> args;
+		std::string detail;
+	};
+
+	namespace detail {
+		extern std::atomic<bool> enabled;
+
+		std::uint64_t now_ns();
+		void record(event&& e);
+	} // detail
+
+	[[nodiscard]] inline bool is_enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+	void set_enabled(bool enabled);
+
+	// drops every recorded event, must not race with open spans
+	void clear();
+	[[nodiscard]] std::size_t event_count();
+	// names the calling thread in the trace viewer
+	void set_thread_name(const std::string& name);
+
+	// must be called once all traced work has finished
+	bool write_chrome_trace(const std::filesystem::path& path);
+
+	class scope {
+		event e_;
+		bool active_;
+
+	public:
+		scope(const char* name, const char* category)
+			: e_{ name, category, 0, 0, 0, 0, {}, {} }, active_(is_enabled()) {
+			if (active_) e_.start_ns = detail::now_ns();
+		}
+		scope(const scope&) = delete;
+		scope(scope&&) = delete;
+		~scope() {
+			if (active_) {
+				e_.duration_ns = detail::now_ns() - e_.start_ns;
+				detail::record(std::move(e_));
+			}
+		}
+
+		scope& operator=(const scope&) = delete;
+		scope& operator=(scope&&) = delete;
+
+		[[nodiscard]] bool active() const { return active_; }
+
+		void arg(const char* key, std::uint64_t value) {
+			if (active_ && e_.arg_count < max_args) e_.args[e_.arg_count++] = { key, value };
+		}
+		void set_detail(const std::string& s) {
+			if (active_) e_.detail = s;
+		}
+		void set_detail(const std::filesystem::path& p) {
+			if (active_) e_.detail = p.u8string();
+		}
+	};
+
+	class null_scope {
+	public:
+		null_scope(const char*, const char*) {}
+
+		[[nodiscard]] bool active() const { return false; }
+		void arg(const char*, std::uint64_t) {}
+		void set_detail(const std::string&) {}
+		void set_detail(const std::filesystem::path&) {}
+	};
+
+} // docs_gen_core::trace
+
+#ifdef DOCS_GEN_NO_TRACE
+#define DOCS_GEN_TRACE_SCOPE(var, name, category) docs_gen_core::trace::null_scope var{ name, category }
+#else
+#define DOCS_GEN_TRACE_SCOPE(var, name, category) docs_gen_core::trace::scope var{ name, category }
+#endif
+
+#endif // DOCS_GEN_TRACE_H
@@ -0,0 +1,63 @@
+#include "uid.hpp"
+
+#include <algorithm>
+
+namespace docs_gen_core {
+
+	namespace {
+
+		constexpr std::uint64_t uid_base = 'z' - 'a' + ('9' - '0');
+
+		template <typename Char>
+		std::uint64_t decode(const Char* s, std::size_t n) {
+			constexpr char scheme[] = "uid://";
+			constexpr std::size_t scheme_size = sizeof(scheme) - 1;
+			if (n >= scheme_size && std::equal(scheme, scheme + scheme_size, s,
+				[](char a, Char b) { return static_cast<Char>(a) == b; })) {
+				s += scheme_size;
+				n -= scheme_size;
+			}
+
+			if (n == 0) return invalid_uid;
+
+			std::uint64_t uid = 0;
+			for (std::size_t i = 0; i < n; ++i) {
+				const auto c = s[i];
+				uid *= uid_base;
+				if (c >= 'a' && c <= 'z') {
+					uid += static_cast<std::uint64_t>(c - 'a');
+				}
+				else if (c >= '0' && c <= '9') {
+					uid += static_cast<std::uint64_t>(c - '0') + 25;
+				}
+				else {
+					return invalid_uid;
+				}
+			}
+			return uid & 0x7FFFFFFFFFFFFFFFull;
+		}
+
+	} // namespace
+
+	std::uint64_t decode_uid(std::string_view text) {
+		return decode(text.data(), text.size());
+	}
+
+	std::uint64_t decode_uid(std::wstring_view text) {
+		return decode(text.data(), text.size());
+	}
+
+	std::string encode_uid(std::uint64_t uid) {
+		if (uid == invalid_uid) return "uid://<invalid>";
+
+		std::string digits;
+		do {
+			const auto d = static_cast<char>(uid % uid_base);
+			digits.push_back(d < 25 ? static_cast<char>('a' + d) : static_cast<char>('0' + d - 25));
+			uid /= uid_base;
+		} while (uid);
+		std::reverse(digits.begin(), digits.end());
+		return "uid://" + digits;
+	}
+
+} // docs_gen_core
@@ -0,0 +1,131 @@
+#ifndef DOCS_GEN_UID_H
+#define DOCS_GEN_UID_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace docs_gen_core {
+
+	// Godot writes resource uids as "uid://" followed by the base 34 digits (a-y, 0-8) of a 63 bit
+	// integer; decoding them once at parse time makes every later hash, compare and copy one word
+	constexpr std::uint64_t invalid_uid = static_cast<std::uint64_t>(-1);
+
+	// accepts the payload with or without the "uid://" prefix, same rules as ResourceUID::text_to_id
+	[[nodiscard]] std::uint64_t decode_uid(std::string_view text);
+	[[nodiscard]] std::uint64_t decode_uid(std::wstring_view text);
+	// "uid://..." form of a decoded uid
+	[[nodiscard]] std::string encode_uid(std::uint64_t uid);
+
+	[[nodiscard]] constexpr std::uint64_t hash_uid(std::uint64_t uid) {
+		// murmur3 finalizer, uids are random already but this keeps probing sane for sequential ones
+		uid ^= uid >> 33;
+		uid *= 0xFF51AFD7ED558CCDull;
+		uid ^= uid >> 33;
+		uid *= 0xC4CEB9FE1A85EC53ull;
+		uid ^= uid >> 33;
+		return uid;
+	}
+
+	// open addressing (linear probing) map from decoded uid to T
+	//
+	// keys live in their own array so a probe only touches 8 byte slots; invalid_uid marks an
+	// empty slot and can not be stored; there is no erase, the maps are only ever filled and cleared
+	template <typename T>
+	class uid_map {
+		std::vector<std::uint64_t> keys_;
+		std::vector<T> values_;
+		std::size_t size_ = 0;
+
+	public:
+		class const_iterator {
+			const uid_map* map_;
+			std::size_t i_;
+
+			void skip_empty() {
+				while (i_ < map_->keys_.size() && map_->keys_[i_] == invalid_uid) ++i_;
+			}
+
+		public:
+			const_iterator(const uid_map* map, std::size_t i) : map_(map), i_(i) { skip_empty(); }
+
+			const_iterator& operator++() {
+				++i_;
+				skip_empty();
+				return *this;
+			}
+			bool operator==(const const_iterator& other) const { return i_ == other.i_; }
+			bool operator!=(const const_iterator& other) const { return i_ != other.i_; }
+			std::pair<std::uint64_t, const T&> operator*() const { return { map_->keys_[i_], map_->values_[i_] }; }
+		};
+
+		uid_map() = default;
+
+		void reserve(std::size_t n) {
+			std::size_t capacity = 16;
+			while (capacity < n * 2) capacity <<= 1;
+			if (capacity > keys_.size()) rehash(capacity);
+		}
+
+		void clear() {
+			keys_.clear();
+			values_.clear();
+			size_ = 0;
+		}
+
+		// returns false if the key was already present and got overwritten
+		bool insert_or_assign(std::uint64_t key, const T& value) {
+			if (key == invalid_uid) return false;
+			if ((size_ + 1) * 2 > keys_.size()) rehash(keys_.empty() ? 16 : keys_.size() * 2);
+
+			const auto i = probe(key);
+			const bool inserted = keys_[i] == invalid_uid;
+			keys_[i] = key;
+			values_[i] = value;
+			size_ += inserted;
+			return inserted;
+		}
+
+		[[nodiscard]] const T* find(std::uint64_t key) const {
+			if (keys_.empty() || key == invalid_uid) return nullptr;
+			const auto i = probe(key);
+			return keys_[i] == key ? &values_[i] : nullptr;
+		}
+
+		[[nodiscard]] bool contains(std::uint64_t key) const { return find(key) != nullptr; }
+		[[nodiscard]] std::size_t size() const { return size_; }
+		[[nodiscard]] bool empty() const { return size_ == 0; }
+
+		[[nodiscard]] const_iterator begin() const { return { this, 0 }; }
+		[[nodiscard]] const_iterator end() const { return { this, keys_.size() }; }
+
+	private:
+		// slot holding key, or the empty slot where it would go
+		[[nodiscard]] std::size_t probe(std::uint64_t key) const {
+			const auto mask = keys_.size() - 1;
+			auto i = static_cast<std::size_t>(hash_uid(key)) & mask;
+			while (keys_[i] != invalid_uid && keys_[i] != key) {
+				i = (i + 1) & mask;
+			}
+			return i;
+		}
+
+		void rehash(std::size_t capacity) {
+			auto keys = std::move(keys_);
+			auto values = std::move(values_);
+			keys_.assign(capacity, invalid_uid);
+			values_.assign(capacity, T{});
+			for (std::size_t i = 0; i < keys.size(); ++i) {
+				if (keys[i] == invalid_uid) continue;
+				const auto j = probe(keys[i]);
+				keys_[j] = keys[i];
+				values_[j] = std::move(values[i]);
+			}
+		}
+	};
+
+} // docs_gen_core
+
+#endif // DOCS_GEN_UID_H
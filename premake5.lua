@@ -7,6 +7,9 @@ workspace "GDScript Parser"
 
     startproject "App"
 
+    -- the levels below it are compiled out of every project, see core/log.hpp
+    defines { "DOCS_GEN_LOG_LEVEL=0" }
+
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 group ""
@@ -15,3 +18,6 @@ group ""
 
 group "Tests"
     include "Tests"
+
+group "Benchmarks"
+    include "Bench"
@@ -0,0 +1,12 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_inflater,
+        docs_gen_test::test_deflate,
+        docs_gen_test::test_zip,
+        docs_gen_test::test_tar,
+        docs_gen_test::test_archive_run,
+    });
+}
\ No newline at end of file
@@ -0,0 +1,570 @@
+﻿#include "test.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../core/archive.hpp"
+#include "../core/deflate.hpp"
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        // a small inflater after zlib's puff.c, so the deflate output is checked against a decoder
+        // that shares nothing with it
+        class inflater {
+            struct huffman {
+                std::array<std::uint16_t, 16> count{};
+                std::array<std::uint16_t, 288> symbol{};
+            };
+
+            std::string_view in_;
+            std::size_t pos_ = 0;
+            std::uint32_t bit_buffer_ = 0;
+            int bit_count_ = 0;
+            bool failed_ = false;
+            std::string out_;
+
+            int bits(int need) {
+                std::uint32_t value = bit_buffer_;
+                while (bit_count_ < need) {
+                    if (pos_ == in_.size()) {
+                        failed_ = true;
+                        return 0;
+                    }
+                    value |= static_cast<std::uint32_t>(static_cast<unsigned char>(in_[pos_++])) << bit_count_;
+                    bit_count_ += 8;
+                }
+                bit_buffer_ = value >> need;
+                bit_count_ -= need;
+                return static_cast<int>(value & ((1u << need) - 1));
+            }
+
+            // canonical code from code lengths, false for an over-subscribed set
+            static bool construct(huffman& h, const std::uint16_t* lengths, int n) {
+                h.count.fill(0);
+                for (int symbol = 0; symbol < n; ++symbol) ++h.count[lengths[symbol]];
+                if (h.count[0] == n) return true;
+                int left = 1;
+                for (int len = 1; len < 16; ++len) {
+                    left <<= 1;
+                    left -= h.count[len];
+                    if (left < 0) return false;
+                }
+                std::array<std::uint16_t, 16> offsets{};
+                for (int len = 1; len < 15; ++len) offsets[len + 1] = offsets[len] + h.count[len];
+                for (int symbol = 0; symbol < n; ++symbol) {
+                    if (lengths[symbol] != 0) h.symbol[offsets[lengths[symbol]]++] = static_cast<std::uint16_t>(symbol);
+                }
+                return true;
+            }
+
+            int decode(const huffman& h) {
+                int code = 0;
+                int first = 0;
+                int index = 0;
+                for (int len = 1; len < 16; ++len) {
+                    code |= bits(1);
+                    const int count = h.count[len];
+                    if (code - count < first) return h.symbol[index + (code - first)];
+                    index += count;
+                    first += count;
+                    first <<= 1;
+                    code <<= 1;
+                }
+                failed_ = true;
+                return -1;
+            }
+
+            bool stored() {
+                bit_buffer_ = 0;
+                bit_count_ = 0;
+                if (pos_ + 4 > in_.size()) return false;
+                const auto byte = [&](std::size_t i) { return static_cast<unsigned>(static_cast<unsigned char>(in_[pos_ + i])); };
+                const unsigned len = byte(0) | byte(1) << 8;
+                if ((byte(2) | byte(3) << 8) != (~len & 0xFFFF)) return false;
+                pos_ += 4;
+                if (pos_ + len > in_.size()) return false;
+                out_.append(in_.substr(pos_, len));
+                pos_ += len;
+                return true;
+            }
+
+            bool codes(const huffman& lengths, const huffman& distances) {
+                static constexpr std::array<std::uint16_t, 29> length_base = {
+                    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+                static constexpr std::array<std::uint16_t, 29> length_extra = {
+                    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+                static constexpr std::array<std::uint16_t, 30> distance_base = {
+                    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                    4097, 6145, 8193, 12289, 16385, 24577 };
+                static constexpr std::array<std::uint16_t, 30> distance_extra = {
+                    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+                for (;;) {
+                    int symbol = decode(lengths);
+                    if (failed_ || symbol < 0) return false;
+                    if (symbol < 256) {
+                        out_.push_back(static_cast<char>(symbol));
+                        continue;
+                    }
+                    if (symbol == 256) return true;
+                    symbol -= 257;
+                    if (symbol >= 29) return false;
+                    const std::size_t len = length_base[symbol] + bits(length_extra[symbol]);
+                    symbol = decode(distances);
+                    if (failed_ || symbol < 0 || symbol >= 30) return false;
+                    const std::size_t distance = distance_base[symbol] + bits(distance_extra[symbol]);
+                    if (failed_ || distance > out_.size()) return false;
+                    for (std::size_t i = 0; i < len; ++i) out_.push_back(out_[out_.size() - distance]);
+                }
+            }
+
+            bool fixed() {
+                std::array<std::uint16_t, 288 + 30> lengths{};
+                std::fill(lengths.begin(), lengths.begin() + 144, 8);
+                std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+                std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+                std::fill(lengths.begin() + 280, lengths.begin() + 288, 8);
+                std::fill(lengths.begin() + 288, lengths.end(), 5);
+                huffman length_code;
+                huffman distance_code;
+                construct(length_code, lengths.data(), 288);
+                construct(distance_code, lengths.data() + 288, 30);
+                return codes(length_code, distance_code);
+            }
+
+            bool dynamic() {
+                static constexpr std::array<std::uint8_t, 19> order = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+                const int nlen = bits(5) + 257;
+                const int ndist = bits(5) + 1;
+                const int ncode = bits(4) + 4;
+                if (nlen > 286 || ndist > 30) return false;
+                std::array<std::uint16_t, 320> lengths{};
+                for (int i = 0; i < ncode; ++i) lengths[order[i]] = static_cast<std::uint16_t>(bits(3));
+                huffman code_code;
+                if (!construct(code_code, lengths.data(), 19)) return false;
+                lengths.fill(0);
+                for (int i = 0; i < nlen + ndist; ) {
+                    const int symbol = decode(code_code);
+                    if (failed_ || symbol < 0) return false;
+                    if (symbol < 16) {
+                        lengths[i++] = static_cast<std::uint16_t>(symbol);
+                        continue;
+                    }
+                    std::uint16_t repeat = 0;
+                    int times = 0;
+                    if (symbol == 16) {
+                        if (i == 0) return false;
+                        repeat = lengths[i - 1];
+                        times = 3 + bits(2);
+                    }
+                    else if (symbol == 17) times = 3 + bits(3);
+                    else times = 11 + bits(7);
+                    if (i + times > nlen + ndist) return false;
+                    while (times-- > 0) lengths[i++] = repeat;
+                }
+                huffman length_code;
+                huffman distance_code;
+                if (!construct(length_code, lengths.data(), nlen) || !construct(distance_code, lengths.data() + nlen, ndist))
+                    return false;
+                return codes(length_code, distance_code);
+            }
+
+        public:
+            // the whole of data as raw deflate blocks, false for anything malformed or left over
+            bool inflate(std::string_view data, std::string& out) {
+                in_ = data;
+                out_.clear();
+                for (bool last = false; !last; ) {
+                    last = bits(1) == 1;
+                    const int type = bits(2);
+                    const bool ok = type == 0 ? stored() : type == 1 ? fixed() : type == 2 ? dynamic() : false;
+                    if (!ok || failed_) return false;
+                }
+                out = std::move(out_);
+                return pos_ == in_.size();
+            }
+        };
+
+        std::string inflate(std::string_view data, bool* ok = nullptr) {
+            std::string out;
+            const bool inflated = inflater{}.inflate(data, out);
+            if (ok) *ok = inflated;
+            return out;
+        }
+
+        // bit at a time, for comparing with the table driven one
+        std::uint32_t slow_crc32(std::string_view data) {
+            std::uint32_t crc = 0xFFFFFFFFu;
+            for (const auto c : data) {
+                crc ^= static_cast<unsigned char>(c);
+                for (int k = 0; k < 8; ++k) crc = crc & 1 ? crc >> 1 ^ 0xEDB88320u : crc >> 1;
+            }
+            return ~crc;
+        }
+
+        std::string bytes(std::initializer_list<unsigned> list) {
+            std::string out;
+            for (const auto b : list) out.push_back(static_cast<char>(b));
+            return out;
+        }
+
+        // the same bytes every run, without structure deflate could find
+        std::string noise(std::size_t size, std::uint32_t seed) {
+            std::string out(size, '\0');
+            for (auto& c : out) {
+                seed = seed * 1664525u + 1013904223u;
+                c = static_cast<char>(seed >> 24);
+            }
+            return out;
+        }
+
+        std::uint64_t le(std::string_view s, std::size_t at, std::size_t n) {
+            std::uint64_t v = 0;
+            for (std::size_t i = n; i-- > 0; ) v = v << 8 | static_cast<unsigned char>(s[at + i]);
+            return v;
+        }
+
+        struct zip_entry {
+            std::string name;
+            std::uint64_t method = 0;
+            std::uint64_t size = 0;
+            std::uint64_t compressed_size = 0;
+            std::string data;
+        };
+
+        // every entry of a zip, walked from the end record through the central directory to each
+        // local header; false when any of the fields the two copies share disagree
+        bool read_zip(const std::string& zip, std::vector<zip_entry>& entries) {
+            if (zip.size() < 22) return false;
+            const auto end = zip.size() - 22;
+            if (le(zip, end, 4) != 0x06054b50 || le(zip, end + 4, 4) != 0 || le(zip, end + 20, 2) != 0) return false;
+            const auto count = le(zip, end + 8, 2);
+            const auto directory_size = le(zip, end + 12, 4);
+            const auto directory = le(zip, end + 16, 4);
+            if (le(zip, end + 10, 2) != count || directory + directory_size != end) return false;
+
+            std::size_t at = directory;
+            std::size_t next_local = 0;
+            for (std::uint64_t i = 0; i < count; ++i) {
+                if (at + 46 > end || le(zip, at, 4) != 0x02014b50) return false;
+                const auto name_size = le(zip, at + 28, 2);
+                zip_entry e;
+                e.method = le(zip, at + 10, 2);
+                e.compressed_size = le(zip, at + 20, 4);
+                e.size = le(zip, at + 24, 4);
+                e.name = zip.substr(at + 46, name_size);
+                const auto crc = le(zip, at + 16, 4);
+                const auto local = le(zip, at + 42, 4);
+                // made by unix 2.0, needs 2.0, UTF-8 names, no extra, comment, disk or internal attributes
+                if (le(zip, at + 4, 2) != (3 << 8 | 20) || le(zip, at + 6, 2) != 20 || le(zip, at + 8, 2) != 0x0800
+                    || le(zip, at + 30, 2) != 0 || le(zip, at + 32, 2) != 0 || le(zip, at + 34, 2) != 0 || le(zip, at + 36, 2) != 0
+                    || le(zip, at + 38, 4) != 0100644u << 16)
+                    return false;
+                if (e.method != 0 && e.method != 8) return false;
+
+                // entries follow each other with nothing between them
+                if (local != next_local || le(zip, local, 4) != 0x04034b50) return false;
+                if (le(zip, local + 4, 2) != 20 || le(zip, local + 6, 2) != 0x0800 || le(zip, local + 8, 2) != e.method
+                    || le(zip, local + 10, 4) != le(zip, at + 12, 4) || le(zip, local + 14, 4) != crc
+                    || le(zip, local + 18, 4) != e.compressed_size || le(zip, local + 22, 4) != e.size
+                    || le(zip, local + 26, 2) != name_size || le(zip, local + 28, 2) != 0 || zip.compare(local + 30, name_size, e.name) != 0)
+                    return false;
+                const auto data = local + 30 + name_size;
+                next_local = data + e.compressed_size;
+                if (next_local > directory) return false;
+
+                const std::string_view raw{ zip.data() + data, e.compressed_size };
+                bool inflated = true;
+                e.data = e.method == 8 ? inflate(raw, &inflated) : std::string(raw);
+                if (!inflated || e.data.size() != e.size || slow_crc32(e.data) != crc) return false;
+                if (e.method == 0 && e.compressed_size != e.size) return false;
+                entries.push_back(std::move(e));
+                at += 46 + name_size;
+            }
+            return at == end && next_local == directory;
+        }
+
+        std::uint64_t octal(std::string_view field) {
+            std::uint64_t v = 0;
+            for (const auto c : field) {
+                if (c < '0' || c > '7') break;
+                v = v * 8 + static_cast<std::uint64_t>(c - '0');
+            }
+            return v;
+        }
+
+        // name -> contents of a ustar archive, pax path records applied; false on a bad checksum,
+        // padding that is not zeros or an end other than two zero blocks
+        bool read_tar(const std::string& tar, std::vector<std::pair<std::string, std::string>>& entries) {
+            if (tar.size() % 512 != 0 || tar.size() < 1024) return false;
+            std::string pax_path;
+            std::size_t at = 0;
+            for (;;) {
+                if (at + 512 > tar.size()) return false;
+                const std::string_view h{ tar.data() + at, 512 };
+                if (h.find_first_not_of('\0') == std::string_view::npos) break;
+
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i < 512; ++i) sum += i >= 148 && i < 156 ? ' ' : static_cast<unsigned char>(h[i]);
+                if (octal(h.substr(148, 8)) != sum || h.substr(257, 8) != std::string_view("ustar\0" "00", 8)) return false;
+                if (h.substr(100, 8) != std::string_view("0000644\0", 8) || h[135] != '\0') return false;
+
+                const auto size = octal(h.substr(124, 12));
+                const auto data = at + 512;
+                const auto padded = (size + 511) / 512 * 512;
+                if (data + padded > tar.size()) return false;
+                if (tar.find_first_not_of('\0', data + size) < data + padded) return false;
+
+                const auto field = [&](std::size_t offset, std::size_t length) {
+                    const auto f = h.substr(offset, length);
+                    return std::string(f.substr(0, f.find('\0')));
+                };
+                auto name = field(0, 100);
+                const auto prefix = field(345, 155);
+                if (!prefix.empty()) name = prefix + "/" + name;
+                auto body = tar.substr(data, size);
+                if (h[156] == 'x') {
+                    const auto path = body.find(" path=");
+                    if (path == std::string::npos || body.back() != '\n' || std::stoul(body) != body.size()) return false;
+                    pax_path = body.substr(path + 6, body.size() - path - 7);
+                }
+                else {
+                    if (h[156] != '0') return false;
+                    if (!pax_path.empty()) name = std::move(pax_path);
+                    pax_path.clear();
+                    entries.emplace_back(std::move(name), std::move(body));
+                }
+                at = data + padded;
+            }
+            return at + 1024 == tar.size() && tar.find_first_not_of('\0', at) == std::string::npos;
+        }
+
+        // what the writer tests add, in sequence order
+        std::vector<std::pair<std::string, std::string>> sample_entries() {
+            std::string page;
+            for (int i = 0; i < 200; ++i) page += "- [enemy.tscn](enemy.tscn.md)\n\t- Sprite" + std::to_string(i % 7) + "\n";
+            const std::string deep = "docs/" + std::string(60, 'a') + "/" + std::string(60, 'b') + "/page.md";
+            const std::string flat = "docs/" + std::string(120, 'c') + ".md";
+            return {
+                { "docs/a.md", "hello" },
+                { "docs/empty.md", "" },
+                { "docs/block.md", std::string(512, 'x') },
+                { "docs/big.md", page },
+                { "docs/noise.md", noise(3000, 7) },
+                { deep, "split at a slash into prefix and name" },
+                { flat, "too long for either, a pax record" },
+            };
+        }
+
+        // adds the entries from two threads, the later half first
+        std::string write_archive(const std::filesystem::path& path, docs_gen_core::archive_format format,
+            const std::vector<std::pair<std::string, std::string>>& entries) {
+            docs_gen_core::archive_writer archive;
+            if (!archive.open(path, format)) return {};
+            std::thread late{ [&] {
+                for (std::size_t i = entries.size(); i-- > entries.size() / 2; ) archive.add(i, entries[i].first, entries[i].second);
+            } };
+            late.join();
+            for (std::size_t i = 0; i < entries.size() / 2; ++i) archive.add(i, entries[i].first, entries[i].second);
+            if (archive.entry_count() != entries.size() || !archive.close()) return {};
+            return read_file(path);
+        }
+
+    } // namespace
+
+    bool test_inflater() {
+        bool ok = true;
+        bool inflated = false;
+        ok &= check(inflate(bytes({ 0x01, 0x05, 0x00, 0xFA, 0xFF, 'h', 'e', 'l', 'l', 'o' }), &inflated) == "hello" && inflated,
+            "the test inflater reads a stored block");
+        ok &= check(inflate(bytes({ 0xCB, 0x48, 0xCD, 0xC9, 0xC9, 0x07, 0x00 }), &inflated) == "hello" && inflated,
+            "a fixed block as zlib writes it");
+        const auto dynamic = bytes({
+            0xb5, 0xcb, 0xc9, 0x11, 0x80, 0x20, 0x10, 0x44, 0xd1, 0x54, 0x3a, 0x02, 0x13, 0x30, 0x1a, 0x50, 0x94, 0x51, 0x61,
+            0x10, 0x59, 0x84, 0xe8, 0x9d, 0x32, 0x02, 0x2f, 0x1e, 0xbb, 0xfe, 0xeb, 0x64, 0x0d, 0xce, 0x4c, 0xd3, 0x0e, 0x1d,
+            0xb9, 0x7a, 0x2c, 0x7c, 0x63, 0xcb, 0x2e, 0x5c, 0xe0, 0x62, 0x22, 0x92, 0xe4, 0x43, 0xf5, 0x86, 0x99, 0xd7, 0xf1,
+            0x5d, 0xff, 0xe0, 0xa0, 0xc4, 0xb9, 0x06, 0x2d, 0xa8, 0x52, 0xb2, 0x58, 0xa8, 0x18, 0x49, 0xdd, 0x78, 0x1c, 0x74,
+            0x66, 0x8e, 0xf2, 0x5d, 0xaf, 0xe1, 0x3b, 0x7c, 0x00 });
+        std::string fox;
+        for (int i = 0; i < 3; ++i) fox += "the quick brown fox jumps over the lazy dog; ";
+        for (int i = 0; i < 2; ++i) fox += "pack my box with five dozen liquor jugs. ";
+        ok &= check(inflate(dynamic, &inflated) == fox && inflated, "and a dynamic one");
+        inflate(bytes({ 0xCB, 0x48, 0xCD, 0xC9, 0xC9 }), &inflated);
+        ok &= check(!inflated, "a cut stream is an error");
+        inflate(bytes({ 0x01, 0x05, 0x00, 0xFB, 0xFF, 'h', 'e', 'l', 'l', 'o' }), &inflated);
+        ok &= check(!inflated, "so is a stored length that does not match its complement");
+        return ok;
+    }
+
+    bool test_deflate() {
+        bool ok = true;
+        ok &= check(docs_gen_core::crc32("") == 0 && docs_gen_core::crc32("123456789") == 0xCBF43926u, "the CRC-32 check value");
+        const auto data = noise(5000, 1);
+        ok &= check(docs_gen_core::crc32(data) == slow_crc32(data), "the table CRC is the bitwise one");
+        ok &= check(docs_gen_core::crc32(data.substr(1234), docs_gen_core::crc32(data.substr(0, 1234))) == slow_crc32(data),
+            "a CRC continues over pieces");
+
+        std::string all_bytes;
+        for (int i = 0; i < 256; ++i) all_bytes.push_back(static_cast<char>(i));
+        std::string page;
+        for (int i = 0; i < 300; ++i) page += "- [room" + std::to_string(i % 13) + ".tscn](room" + std::to_string(i % 13) + ".tscn.md)\n";
+        // a block repeated just inside the window and one just outside
+        const auto block = noise(20000, 2);
+        const auto far = noise(32768 - 5, 3) + "abcdefgh" + noise(32768, 4).substr(0, 32760) + "abcdefgh";
+
+        struct sample { const char* what; std::string data; };
+        const std::vector<sample> samples{
+            { "nothing", "" },
+            { "one byte", "a" },
+            { "every byte value", all_bytes },
+            { "a long run", std::string(100000, 'a') },
+            { "a page", page },
+            { "a repeated block", block + block },
+            { "a match beyond the window", far },
+            { "noise", noise(70000, 5) },
+        };
+        bool round_trips = true;
+        for (const auto& s : samples) {
+            bool inflated = false;
+            const auto packed = docs_gen_core::deflate(s.data);
+            const bool same = inflate(packed, &inflated) == s.data && inflated;
+            if (!same) std::cout << "     " << s.what << " does not inflate back\n";
+            round_trips &= same;
+        }
+        ok &= check(round_trips, "deflate inflates back to its input");
+        ok &= check(docs_gen_core::deflate(std::string(100000, 'a')).size() < 1000, "runs of the longest match");
+        ok &= check(docs_gen_core::deflate(page).size() < page.size() / 5, "markdown compresses");
+        ok &= check(docs_gen_core::deflate(block + block).size() < 2 * block.size() * 6 / 10, "a block is matched within the window");
+        return ok;
+    }
+
+    bool test_zip() {
+        const scratch_dir base{ "archive_zip_test" };
+        const auto entries = sample_entries();
+
+        bool ok = true;
+        std::vector<zip_entry> stored;
+        ok &= check(read_zip(write_archive(base.path() / "store.zip", docs_gen_core::archive_format::zip_store, entries), stored),
+            "a stored zip's headers agree and every CRC matches");
+        bool stored_same = stored.size() == entries.size();
+        for (std::size_t i = 0; stored_same && i < entries.size(); ++i) {
+            stored_same &= stored[i].name == entries[i].first && stored[i].data == entries[i].second && stored[i].method == 0;
+        }
+        ok &= check(stored_same, "in sequence order, every entry stored");
+
+        std::vector<zip_entry> deflated;
+        ok &= check(read_zip(write_archive(base.path() / "deflate.zip", docs_gen_core::archive_format::zip_deflate, entries), deflated),
+            "a deflated zip's headers agree and every entry inflates to its CRC");
+        bool deflated_same = deflated.size() == entries.size();
+        for (std::size_t i = 0; deflated_same && i < entries.size(); ++i) {
+            deflated_same &= deflated[i].name == entries[i].first && deflated[i].data == entries[i].second;
+        }
+        ok &= check(deflated_same, "in sequence order");
+        ok &= check(deflated.size() == 7 && deflated[0].method == 0 && deflated[1].method == 0 && deflated[1].size == 0
+            && deflated[2].method == 8 && deflated[3].method == 8 && deflated[4].method == 0,
+            "an entry deflating does not shrink is stored, an empty one too");
+        ok &= check(deflated.size() == 7 && deflated[3].compressed_size < deflated[3].size / 5, "a page shrinks");
+
+        docs_gen_core::archive_writer empty;
+        std::vector<zip_entry> none;
+        ok &= check(empty.open(base.path() / "empty.zip", docs_gen_core::archive_format::zip_deflate) && empty.close()
+            && read_file(base.path() / "empty.zip").size() == 22 && read_zip(read_file(base.path() / "empty.zip"), none) && none.empty(),
+            "an archive without entries is the end record alone");
+
+        ok &= check(docs_gen_core::archive_writer::format_for("docs.zip") == docs_gen_core::archive_format::zip_deflate
+            && docs_gen_core::archive_writer::format_for("docs.zip", true) == docs_gen_core::archive_format::zip_store
+            && docs_gen_core::archive_writer::format_for("docs.tar", true) == docs_gen_core::archive_format::tar
+            && docs_gen_core::archive_writer::format_for("docs") == docs_gen_core::archive_format::tar,
+            "the format follows the extension");
+        return ok;
+    }
+
+    bool test_tar() {
+        const scratch_dir base{ "archive_tar_test" };
+        const auto entries = sample_entries();
+        const auto tar = write_archive(base.path() / "docs.tar", docs_gen_core::archive_format::tar, entries);
+
+        bool ok = true;
+        std::vector<std::pair<std::string, std::string>> read;
+        ok &= check(read_tar(tar, read), "every header checksum matches, data is zero padded, two zero blocks end it");
+        ok &= check(read == entries, "in sequence order, long names through the prefix and a pax record");
+
+        // the 512 byte entry needs no padding, the empty one no data block at all
+        const auto block = tar.find(std::string(512, 'x'));
+        ok &= check(block != std::string::npos && block % 512 == 0 && tar.compare(block + 512 + 100, 5, std::string(5, '\0')) != 0,
+            "a whole block of data is followed directly by the next header");
+        // ustar splits at the first '/' that leaves at most 100 bytes of name
+        const auto header = tar.find(std::string(60, 'b') + "/page.md" + '\0');
+        ok &= check(header != std::string::npos && header % 512 == 0
+            && tar.compare(header + 345, 66, "docs/" + std::string(60, 'a') + '\0') == 0, "the leading directories go into the prefix");
+        ok &= check(tar.find("PaxHeader") != std::string::npos && tar[tar.find("PaxHeader") + 156] == 'x', "the pax header is typed x");
+
+        docs_gen_core::archive_writer empty;
+        ok &= check(empty.open(base.path() / "empty.tar", docs_gen_core::archive_format::tar) && empty.close()
+            && read_file(base.path() / "empty.tar") == std::string(1024, '\0'), "an empty tar is its two end blocks");
+        return ok;
+    }
+
+    bool test_archive_run() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "archive_run_test" };
+        const scratch_dir out{ "archive_run_out" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        // the plain run's tree, named as the archive names it
+        std::map<std::string, std::string> expected;
+        for (auto& [path, page] : gen_docs(root)) {
+            expected["docs/" + path] = std::move(page);
+        }
+        std::filesystem::remove_all(root / "docs");
+
+        docs_gen_core::thread_pool pool{ 3 };
+        const auto run = [&](const std::filesystem::path& path, docs_gen_core::archive_format format, docs_gen_core::thread_pool* p) {
+            docs_gen_core::dir d;
+            if (!d.set_path(root.wstring())) return std::string{};
+            d.set_archive(path, format);
+            d.set_thread_pool(p);
+            d.construct_file_tree();
+            d.gen_docs();
+            return read_file(path);
+        };
+
+        bool ok = true;
+        std::vector<std::pair<std::string, std::string>> tar_entries;
+        const auto tar = run(out.path() / "docs.tar", docs_gen_core::archive_format::tar, nullptr);
+        ok &= check(read_tar(tar, tar_entries), "a run writes a well formed tar");
+        ok &= check(std::map<std::string, std::string>(tar_entries.begin(), tar_entries.end()) == expected
+            && tar_entries.size() == expected.size(), "holding exactly the docs a plain run writes");
+        ok &= check(tar_entries.back().first == "docs/.obsidian/graph.json", "the graph settings come last");
+        ok &= check(!std::filesystem::exists(root / "docs"), "and no docs folder");
+
+        const auto names = [](const std::vector<zip_entry>& entries) {
+            std::map<std::string, std::string> tree;
+            for (const auto& e : entries) tree[e.name] = e.data;
+            return tree;
+        };
+        std::vector<zip_entry> deflated;
+        ok &= check(read_zip(run(out.path() / "docs.zip", docs_gen_core::archive_format::zip_deflate, &pool), deflated)
+            && names(deflated) == expected, "a pooled run writes the same docs into a deflated zip");
+        std::vector<zip_entry> stored;
+        ok &= check(read_zip(run(out.path() / "store.zip", docs_gen_core::archive_format::zip_store, nullptr), stored)
+            && names(stored) == expected, "and into a stored one");
+        bool order = deflated.size() == stored.size() && deflated.size() == tar_entries.size();
+        for (std::size_t i = 0; order && i < stored.size(); ++i) {
+            order &= stored[i].name == tar_entries[i].first && deflated[i].name == tar_entries[i].first;
+        }
+        ok &= check(order, "every run orders the entries the same");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,14 @@
+﻿#ifndef DOCS_GEN_TEST_ARCHIVE_H
+#define DOCS_GEN_TEST_ARCHIVE_H
+
+namespace docs_gen_test {
+
+    bool test_inflater();
+    bool test_deflate();
+    bool test_zip();
+    bool test_tar();
+    bool test_archive_run();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_ARCHIVE_H
\ No newline at end of file
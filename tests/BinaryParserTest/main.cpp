@@ -0,0 +1,13 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_binary_header,
+        docs_gen_test::test_binary_scene,
+        docs_gen_test::test_binary_resource,
+        docs_gen_test::test_binary_truncated,
+        docs_gen_test::test_binary_bogus_counts,
+        docs_gen_test::test_binary_unicode,
+    });
+}
\ No newline at end of file
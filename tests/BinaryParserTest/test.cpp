@@ -0,0 +1,342 @@
+﻿#include "test.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/binary_parser.hpp"
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../test_common.hpp"
+
+// the fixtures are written the way Godot 4 saves them:
+//   main_le.scn       little endian, float reals; a PackedScene whose "_bundled" holds
+//                     Main > Player (position, script, group) > Camera > Enemy2 (enemy.tscn),
+//                     Main > Enemy1 (enemy.tscn) and Main > Sprite (texture, modulate), with
+//                     player.gd, enemy.tscn and icon.svg in the external table
+//   main_be.scn       the same scene big endian, with the header's real_t flag set
+//   stats_double.res  little endian with real_t double in the format flags, script class "Stats",
+//                     a Curve sub-resource and the main resource referring to enemy.gd, icon.svg
+//                     (unknown), stats.tres and the curve
+namespace docs_gen_test {
+
+    namespace {
+
+        std::filesystem::path fixture(const std::string& name) {
+            return std::filesystem::path{ DOCS_GEN_TEST_DIR } / "fixtures" / name;
+        }
+
+        // tables a file is linked against when nothing else is indexed
+        struct empty_context {
+            docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::scene_file>> scene_files;
+            docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::resource_file>> resource_files;
+            docs_gen_core::path_resolver paths;
+            std::vector<std::shared_ptr<docs_gen_core::file>> files;
+
+            [[nodiscard]] docs_gen_core::link_context get() const { return { scene_files, resource_files, paths, files }; }
+        };
+
+        // one line per node: path, type, the instanced scene and the linked fields
+        std::vector<std::string> describe(docs_gen_core::node_tree& tree) {
+            std::vector<std::string> lines;
+            for (const auto& n : tree) {
+                auto line = n->path.generic_string() + " " + std::filesystem::path(n->type).string();
+                if (const auto instance = n->instance.lock())
+                    line += " -> " + instance->get_path().filename().string();
+                for (const auto& [name, f] : n->ext_resource_fields) {
+                    line += " " + std::filesystem::path(name).string() + "=" + (f.lock() ? f.lock()->get_path().filename().string() : "?");
+                }
+                lines.push_back(line);
+            }
+            return lines;
+        }
+
+        const std::vector<std::string> main_nodes{
+            "Main Node",
+            "Main/Player CharacterBody2D script=player.gd",
+            "Main/Player/Camera Camera2D",
+            "Main/Player/Camera/Enemy2 PackedScene -> enemy.tscn",
+            "Main/Enemy1 PackedScene -> enemy.tscn",
+            "Main/Sprite Sprite2D",
+        };
+
+        template <typename T>
+        std::shared_ptr<T> find_file(const docs_gen_core::dir& d, const std::string& path) {
+            for (const auto& f : d.get_files()) {
+                if (f && f->get_path().lexically_relative(d.get_path()).generic_string() == path)
+                    return std::dynamic_pointer_cast<T>(f);
+            }
+            return nullptr;
+        }
+
+        // the sample project with the fixtures next to the text files they refer to
+        void write_binary_project(const std::filesystem::path& root) {
+            write_sample_project(root);
+            for (const auto* name : { "main_le.scn", "main_be.scn" }) {
+                std::filesystem::copy_file(fixture(name), root / "scenes" / name);
+            }
+            std::filesystem::copy_file(fixture("stats_double.res"), root / "res/stats_double.res");
+        }
+
+        // the fixture with the 32-bit little endian value at offset replaced
+        std::string patched(std::string bytes, std::size_t offset, std::uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                bytes[offset + i] = static_cast<char>(value >> (8 * i) & 0xFF);
+            }
+            return bytes;
+        }
+
+        std::string u32s(std::initializer_list<std::int32_t> values) {
+            std::string bytes;
+            for (const auto v : values) {
+                bytes += patched(std::string(4, '\0'), 0, static_cast<std::uint32_t>(v));
+            }
+            return bytes;
+        }
+
+    } // namespace
+
+    bool test_binary_header() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir base{ "binary_header_test" };
+
+        bool ok = true;
+        for (const auto& [name, uid] : { std::pair{ "main_le.scn", "uid://cbinscene001" }, std::pair{ "main_be.scn", "uid://cbinscene002" } }) {
+            const auto scene = std::make_shared<docs_gen_core::scene_file>(fixture(name));
+            docs_gen_core::binary_parser p{ scene };
+            ok &= check(p.parse_scene_header() && scene->get_uid() == docs_gen_core::decode_uid(uid),
+                "a scene header gives the uid in either byte order");
+        }
+
+        const auto res = std::make_shared<docs_gen_core::resource_file>(fixture("stats_double.res"));
+        docs_gen_core::binary_parser rp{ res };
+        ok &= check(rp.parse_resource_header(), "a resource header is read");
+        ok &= check(res->get_uid() == docs_gen_core::decode_uid("uid://bstatsbinary1"), "the resource uid is read");
+        ok &= check(res->get_script_class() == L"Stats", "the script class follows the uid");
+
+        const auto wrong = std::make_shared<docs_gen_core::resource_file>(fixture("main_le.scn"));
+        docs_gen_core::binary_parser wp{ std::static_pointer_cast<docs_gen_core::dott_file>(wrong) };
+        ok &= check(!wp.parse_scene_header(), "a scene header into a resource is an error");
+
+        write_file(base.path() / "text.scn", "[gd_scene format=3]\n");
+        const auto text = std::make_shared<docs_gen_core::scene_file>(base.path() / "text.scn");
+        docs_gen_core::binary_parser tp{ text };
+        ok &= check(!tp.parse_scene_header(), "a file without the RSRC magic is rejected");
+
+        write_file(base.path() / "packed.scn", std::string("RSCC\0\0\0\0", 8));
+        const auto packed = std::make_shared<docs_gen_core::scene_file>(base.path() / "packed.scn");
+        const empty_context ctx;
+        docs_gen_core::binary_parser pp{ packed };
+        ok &= check(pp.parse_scene_header() && pp.parse_scene_file_contents(ctx.get()) && pp.get_node_count() == 0,
+            "a compressed file is indexed with no contents");
+        return ok;
+    }
+
+    bool test_binary_scene() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "binary_scene_test" };
+        const auto& root = project.path();
+        write_binary_project(root);
+
+        docs_gen_core::dir d;
+        bool ok = true;
+        ok &= check(d.set_path(root.wstring()), "the project opens");
+        d.construct_file_tree();
+
+        const auto le = find_file<docs_gen_core::scene_file>(d, "scenes/main_le.scn");
+        const auto be = find_file<docs_gen_core::scene_file>(d, "scenes/main_be.scn");
+        if (!check(le && be, "both binary scenes are indexed"))
+            return false;
+        ok &= check(describe(le->get_node_tree()) == main_nodes, "the node table builds the tree with its links");
+        ok &= check(describe(be->get_node_tree()) == main_nodes, "big endian with 64-bit reals builds the same tree");
+        ok &= check(le->get_packed_scenes().size() == 1 && le->get_scripts().size() == 1
+            && le->get_ext_resource_other().size() == 1, "each external resource is linked by its kind");
+
+        const auto enemy = find_file<docs_gen_core::file>(d, "scenes/enemy.tscn");
+        std::vector<std::string> referrers;
+        for (const auto& r : d.get_referrers(*enemy)) {
+            referrers.push_back(r->get_path().filename().string());
+        }
+        std::sort(referrers.begin(), referrers.end());
+        ok &= check(referrers == std::vector<std::string>{ "main.tscn", "main_be.scn", "main_le.scn" },
+            "binary scenes refer to what they instance");
+
+        d.gen_docs();
+        const auto page = read_file(root / "docs/scenes/main_le.scn.md");
+        ok &= check(page.find("\t- Enemy1\n") != std::string::npos && page.find("\t\t  *script*: [player.gd](player.gd.md)\n") != std::string::npos
+            && page.find("## Scenes\n- [enemy.tscn](enemy.tscn.md)\n") != std::string::npos
+            && page.find("## Resources\n- icon.svg: Texture2D\n") != std::string::npos, "the page lists the nodes and links");
+        ok &= check(page == read_file(root / "docs/scenes/main_be.scn.md"), "both byte orders give the same page");
+        return ok;
+    }
+
+    bool test_binary_resource() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "binary_resource_test" };
+        const auto& root = project.path();
+        write_binary_project(root);
+
+        docs_gen_core::dir d;
+        bool ok = true;
+        ok &= check(d.set_path(root.wstring()), "the project opens");
+        d.construct_file_tree();
+
+        const auto res = find_file<docs_gen_core::resource_file>(d, "res/stats_double.res");
+        if (!check(res != nullptr, "the binary resource is indexed"))
+            return false;
+
+        const auto& r = res->get_resource();
+        ok &= check(r.type == L"Resource", "the main resource is the last one");
+        std::vector<std::wstring> fields;
+        for (const auto& f : r.fields) {
+            fields.push_back(f.name + L" = " + f.value);
+        }
+        ok &= check(fields == std::vector<std::wstring>{ L"max_hp = 100", L"big = 1099511627776", L"name = \"orc\"",
+            L"ratio = 0.10000000000000001", L"bytes = PackedByteArray (5 elements, 5 B)", L"tags = [1, \"a\"]" },
+            "plain values are written the way the text format has them");
+
+        std::vector<std::string> links;
+        for (const auto& f : r.res_file_fields) {
+            links.push_back(std::filesystem::path(f.name).string() + "=" + (f.file.lock() ? f.file.lock()->get_path().filename().string() : "?"));
+        }
+        ok &= check(links == std::vector<std::string>{ "script=enemy.gd", "base=stats.tres" }, "external resources link by table index");
+        ok &= check(r.res_other_fields.size() == 1 && r.res_other_fields[0].name == L"icon", "an unknown resource is kept by name");
+        ok &= check(r.sub_res_fields.size() == 1 && r.sub_res_fields[0].name == L"curve" && r.sub_res_fields[0].field.lock(),
+            "an internal resource links to the sub-resource");
+
+        const auto& subs = res->get_sub_resources();
+        const auto curve = subs.find(L"Curve_1");
+        ok &= check(subs.size() == 1 && curve != subs.end(), "the sub-resource keeps its id");
+        if (curve != subs.end()) {
+            std::vector<std::wstring> curve_fields;
+            for (const auto& f : curve->second->fields) {
+                curve_fields.push_back(f.name + L" = " + f.value);
+            }
+            ok &= check(curve->second->type == L"Curve" && curve_fields == std::vector<std::wstring>{ L"point_count = 2",
+                L"offset = Vector2(0.25, 1.5)", L"blob = PackedVector3Array (3 elements, 72 B)" },
+                "reals and packed strides are read as doubles");
+        }
+        return ok;
+    }
+
+    bool test_binary_truncated() {
+        // every cut below is an error worth logging, none of them is news here
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::off);
+        const scratch_dir base{ "binary_truncated_test" };
+        const auto whole = read_file(fixture("main_le.scn"));
+        // the string table follows the header, the internal resource table ends the tables
+        const auto header_end = whole.find("_bundled") - 8;
+        const auto tables_end = whole.find("local://PackedScene_x") + sizeof("local://PackedScene_x") + 8;
+        const empty_context ctx;
+
+        // every cut must fail cleanly or give part of the tree, never crash or read past the end
+        bool header_fails = true;
+        bool tables_fail = true;
+        bool body_partial = true;
+        std::size_t partial_trees = 0;
+        for (std::size_t size = 0; size < whole.size(); size += 3) {
+            const auto path = base.path() / ("cut" + std::to_string(size) + ".scn");
+            write_file(path, std::string_view(whole).substr(0, size));
+            const auto scene = std::make_shared<docs_gen_core::scene_file>(path);
+            docs_gen_core::binary_parser p{ scene };
+            const bool header = p.parse_scene_header();
+            const bool contents = header && p.parse_scene_file_contents(ctx.get());
+            if (size < header_end) header_fails &= !header;
+            else if (size < tables_end) tables_fail &= !contents;
+            else {
+                body_partial &= contents && p.get_node_count() <= main_nodes.size() - 2;
+                partial_trees += p.get_node_count() < main_nodes.size() - 2;
+            }
+        }
+
+        bool ok = true;
+        ok &= check(header_fails, "a cut header is rejected");
+        ok &= check(tables_fail, "cut tables are rejected");
+        ok &= check(body_partial && partial_trees > 0, "a cut node table gives part of the tree");
+
+        const auto scene = std::make_shared<docs_gen_core::scene_file>(fixture("main_le.scn"));
+        docs_gen_core::binary_parser p{ scene };
+        // enemy.tscn is not indexed here, so the two nodes instancing it are left out
+        ok &= check(p.parse_scene_header() && p.parse_scene_file_contents(ctx.get()) && p.get_node_count() == main_nodes.size() - 2,
+            "the whole file reads every node");
+        return ok;
+    }
+
+    bool test_binary_bogus_counts() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::off);
+        const scratch_dir base{ "binary_bogus_test" };
+        const auto whole = read_file(fixture("main_le.scn"));
+        const empty_context ctx;
+
+        // Player's row of the node table: parent, owner, type, name, instance, property count,
+        // two properties, group count, one group
+        const auto player = whole.find(u32s({ 0, 0, 3, 2, -1, 2, 4, 0, 5, 1, 1, 13 }));
+        const auto property_count = player + 5 * 4;
+        const auto group_count = player + 10 * 4;
+        const auto string_count = whole.find("_bundled") - 8;
+        const auto ext_count = whole.find("Script") - 8;
+        // "_bundled" is a dictionary of 9 entries, its first key the string "names"
+        const auto bundled = whole.find(u32s({ 26, 9, 5, 6 }) + "names");
+        const auto bundled_count = bundled + 4;
+
+        // what parsing the fixture with one count replaced gives: false, or the nodes read
+        int n = 0;
+        const auto parse = [&](std::size_t offset, std::uint32_t value) -> std::size_t {
+            const auto path = base.path() / ("bogus" + std::to_string(n++) + ".scn");
+            write_file(path, patched(whole, offset, value));
+            const auto scene = std::make_shared<docs_gen_core::scene_file>(path);
+            docs_gen_core::binary_parser p{ scene };
+            if (!p.parse_scene_header() || !p.parse_scene_file_contents(ctx.get()))
+                return static_cast<std::size_t>(-1);
+            return p.get_node_count();
+        };
+
+        bool ok = true;
+        ok &= check(player != std::string::npos && bundled != std::string::npos, "the patched counts are found");
+        ok &= check(parse(string_count, 0xFFFFFFF0) == static_cast<std::size_t>(-1), "a string count past the file is rejected");
+        ok &= check(parse(ext_count, 0x7FFFFFFF) == static_cast<std::size_t>(-1), "an external resource count past the file is rejected");
+        ok &= check(parse(bundled_count, 0x7FFFFFF0) == 0, "a dictionary count past the file drops the node table");
+        ok &= check(parse(property_count, static_cast<std::uint32_t>(-1)) == 1, "a negative property count stops at the node");
+        ok &= check(parse(property_count, 0x40000000) == 1, "a property count past the table stops at the node");
+        ok &= check(parse(group_count, static_cast<std::uint32_t>(-5)) == 1, "a negative group count stops at the node");
+        ok &= check(parse(group_count, 1000) == 1, "a group count past the table stops at the node");
+        return ok;
+    }
+
+    bool test_binary_unicode() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        // the Sprite node is named "\u00e9t\u00e9" and the enemies instance res://sc\u00e8nes/summer.tscn, which is
+        // only indexed here: the paths are keyed lexically, nothing is read from it
+        const auto root = fixture("");
+        const auto summer = std::make_shared<docs_gen_core::scene_file>(root / std::filesystem::u8path(u8"sc\u00e8nes/summer.tscn"));
+        summer->set_id(0);
+        empty_context ctx;
+        ctx.files.push_back(summer);
+        ctx.paths.build(root, ctx.files);
+
+        const auto scene = std::make_shared<docs_gen_core::scene_file>(fixture("unicode.scn"));
+        docs_gen_core::binary_parser p{ scene };
+        bool ok = true;
+        ok &= check(p.parse_scene_header() && p.parse_scene_file_contents(ctx.get()), "the scene is read");
+
+        // each utf-8 byte is one character, none of them negative or replaced
+        const std::wstring name{ L'\xC3', L'\xA9', L't', L'\xC3', L'\xA9' };
+        bool named = false;
+        std::size_t instances = 0;
+        for (const auto& n : scene->get_node_tree()) {
+            named |= n->name == name && n->type == L"Sprite2D";
+            instances += n->instance.lock() == summer;
+        }
+        ok &= check(named, "a name above 0x7F is widened byte by byte");
+
+        const auto& packed = scene->get_packed_scenes();
+        ok &= check(packed.size() == 1 && (*packed.begin()).second == summer, "a path above 0x7F resolves to its file");
+        ok &= check(instances == 2, "and the nodes instancing it link to it");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,15 @@
+﻿#ifndef DOCS_GEN_TEST_BINARY_PARSER_H
+#define DOCS_GEN_TEST_BINARY_PARSER_H
+
+namespace docs_gen_test {
+
+    bool test_binary_header();
+    bool test_binary_scene();
+    bool test_binary_resource();
+    bool test_binary_truncated();
+    bool test_binary_bogus_counts();
+    bool test_binary_unicode();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_BINARY_PARSER_H
\ No newline at end of file
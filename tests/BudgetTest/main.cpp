@@ -0,0 +1,11 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_cancel_token,
+        docs_gen_test::test_cancelled_parse,
+        docs_gen_test::test_budget_generous,
+        docs_gen_test::test_budget_partial,
+    });
+}
\ No newline at end of file
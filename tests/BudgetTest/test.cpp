@@ -0,0 +1,215 @@
+﻿#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "../core/cancel.hpp"
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/parser.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        using namespace std::chrono_literals;
+
+        // a page of a run with the whole graph, without the sections a budgeted run leaves out
+        std::string without_graph(const std::string& page) {
+            const auto at = std::min(page.find("# Dependencies\n"), page.find("# Referenced by\n"));
+            return at == std::string::npos ? page : page.substr(0, at);
+        }
+
+        // the sample project and enough scenes that a short budget runs out part way
+        void write_budget_project(const std::filesystem::path& root) {
+            write_sample_project(root);
+            std::string big = "[gd_scene load_steps=2 format=3 uid=\"uid://cbigbudget001\"]\n\n"
+                "[ext_resource type=\"Script\" path=\"res://scripts/enemy.gd\" id=\"1_en\"]\n\n"
+                "[node name=\"Big\" type=\"Node\"]\n\n";
+            for (int i = 0; i < 200; ++i) {
+                big += "[node name=\"N" + std::to_string(i) + "\" type=\"Node2D\" parent=\".\"]\n"
+                    "position = Vector2(1, 2)\nscript = ExtResource(\"1_en\")\n\n";
+            }
+            for (int i = 0; i < 60; ++i) {
+                const std::string uid{ static_cast<char>('a' + i / 10), static_cast<char>('a' + i % 10) };
+                auto text = big;
+                text.replace(text.find("cbigbudget001"), 13, "cbigbudget0" + uid);
+                write_file(root / ("scenes/big/big" + std::to_string(i) + ".tscn"), text);
+            }
+        }
+
+        // the res:// paths .skipped.txt lists, and its "<written> of <total>" header
+        struct manifest {
+            bool found = false;
+            std::size_t written = 0;
+            std::size_t total = 0;
+            std::set<std::string> paths;
+        };
+
+        manifest read_manifest(const std::filesystem::path& docs) {
+            manifest m;
+            if (!std::filesystem::exists(docs / ".skipped.txt"))
+                return m;
+            m.found = true;
+            std::istringstream in{ read_file(docs / ".skipped.txt") };
+            std::string line;
+            std::getline(in, line);
+            std::istringstream header{ line.substr(line.find(": ") + 2) };
+            std::string of;
+            header >> m.written >> of >> m.total;
+            while (std::getline(in, line)) {
+                if (line.empty() || line[0] == '#') continue;
+                const auto res = line.find(" res://");
+                if (res != std::string::npos) m.paths.insert(line.substr(res + 7));
+            }
+            return m;
+        }
+
+    } // namespace
+
+    bool test_cancel_token() {
+        bool ok = true;
+        const docs_gen_core::cancel_token endless;
+        ok &= check(!endless.expired() && !endless.cancelled(), "a token without a deadline does not expire");
+        endless.cancel();
+        ok &= check(endless.cancelled() && endless.expired(), "cancel ends it");
+
+        const docs_gen_core::cancel_token past{ 0ms };
+        ok &= check(!past.cancelled(), "a passed deadline is not seen until the clock is read");
+        ok &= check(past.expired() && past.cancelled(), "expired reads the clock and latches");
+
+        // the clock is read on every 64th poll only, between those the latched flag is all that counts
+        const docs_gen_core::cancel_token soon{ 0ms };
+        docs_gen_core::cancel_poll poll{ &soon };
+        int polls = 1;
+        while (!poll() && polls < 1000) ++polls;
+        ok &= check(polls == 64, "a poll reads the clock every 64 calls");
+        ok &= check(poll() && poll.cancelled(), "and stops every poll after");
+
+        docs_gen_core::cancel_poll none;
+        bool never = false;
+        for (int i = 0; i < 200; ++i) never |= none();
+        ok &= check(!never && !none.cancelled(), "a poll without a token never stops");
+
+        const docs_gen_core::cancel_token later{ 1h };
+        docs_gen_core::cancel_poll waiting{ &later };
+        bool stopped = false;
+        for (int i = 0; i < 200; ++i) stopped |= waiting();
+        ok &= check(!stopped, "a poll before the deadline goes on");
+        later.cancel();
+        ok &= check(waiting(), "a cancelled token stops the next poll");
+        return ok;
+    }
+
+    bool test_cancelled_parse() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::off);
+        const scratch_dir project{ "cancel_parse_test" };
+        const auto& root = project.path();
+        write_budget_project(root);
+
+        const docs_gen_core::cancel_token expired{ 0ms };
+        static_cast<void>(expired.expired());
+        docs_gen_core::parse_options options;
+        options.cancel = &expired;
+
+        const docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::scene_file>> scene_files;
+        const docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::resource_file>> resource_files;
+        const docs_gen_core::path_resolver paths;
+        const std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        const docs_gen_core::link_context ctx{ scene_files, resource_files, paths, files };
+
+        bool ok = true;
+        const docs_gen_core::cancel_token after_header;
+        auto header_options = options;
+        header_options.cancel = &after_header;
+        const auto scene = std::make_shared<docs_gen_core::scene_file>(root / "scenes/big/big0.tscn");
+        docs_gen_core::dott_parser p{ scene, header_options };
+        ok &= check(p.parse_scene_header(), "the header is read before the deadline");
+        after_header.cancel();
+        ok &= check(!p.parse_scene_file_contents(ctx), "a scene parse stops at a cancelled token");
+        ok &= check(p.get_node_count() < 201, "and leaves the file half read");
+
+        const auto late = std::make_shared<docs_gen_core::scene_file>(root / "scenes/big/big1.tscn");
+        docs_gen_core::dott_parser l{ late, options };
+        ok &= check(!l.parse_scene_header(), "a header is not read past an expired deadline");
+
+        const auto whole = std::make_shared<docs_gen_core::scene_file>(root / "scenes/big/big0.tscn");
+        docs_gen_core::dott_parser q{ whole };
+        ok &= check(q.parse_scene_header() && q.parse_scene_file_contents(ctx) && q.get_node_count() == 201,
+            "without a deadline every node is read");
+
+        const auto script = std::make_shared<docs_gen_core::script_file>(root / "scripts/player.gd");
+        docs_gen_core::script_parser s{ script, &expired };
+        ok &= check(!s.parse(), "a script parse stops at an expired deadline");
+        return ok;
+    }
+
+    bool test_budget_generous() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "budget_generous_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto full = gen_docs(root);
+        docs_gen_core::thread_pool pool{ 3 };
+        const auto budgeted = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_budget(1min);
+            d.set_thread_pool(&pool);
+        });
+
+        bool ok = true;
+        ok &= check(!std::filesystem::exists(root / "docs/.skipped.txt"), "a budget that lasts lists nothing");
+        bool same = budgeted.size() == full.size();
+        for (const auto& [path, page] : budgeted) {
+            const auto it = full.find(path);
+            same &= it != full.end() && page == without_graph(it->second);
+        }
+        ok &= check(same, "every page is the full run's up to the graph sections");
+        return ok;
+    }
+
+    bool test_budget_partial() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::off);
+        const scratch_dir project{ "budget_partial_test" };
+        const auto& root = project.path();
+        const auto docs = root / "docs";
+        write_budget_project(root);
+
+        // an earlier full run, the budgeted run below leaves its pages in place
+        const auto full = gen_docs(root);
+        write_file(docs / "scenes/big/big0.tscn.md", "stale\n");
+        std::filesystem::remove(docs / "scenes/big/big1.tscn.md");
+
+        docs_gen_core::dir d;
+        bool ok = true;
+        ok &= check(d.set_path(root.wstring()), "the project opens");
+        d.set_budget(2ms);
+        d.construct_file_tree();
+        d.gen_docs();
+        const auto m = read_manifest(docs);
+        const auto total = d.get_files().size();
+
+        ok &= check(m.found && m.total == total && m.written < total && m.written + m.paths.size() == total,
+            "the manifest accounts for every file");
+        // a written page is the new one, a skipped one is whatever the earlier run left
+        bool accounted = true;
+        for (const auto& f : d.get_files()) {
+            const auto rel = docs_gen_core::path_resolver::normalize(root, f->get_path());
+            const auto page = docs / (rel + ".md");
+            const bool skipped = m.paths.count(rel) != 0;
+            if (rel == "scenes/big/big1.tscn") accounted &= skipped != std::filesystem::exists(page);
+            else if (rel == "scenes/big/big0.tscn") accounted &= skipped == (read_file(page) == "stale\n");
+            else accounted &= std::filesystem::exists(page);
+            if (!skipped) accounted &= without_graph(read_file(page)) == without_graph(full.at(rel + ".md"));
+        }
+        ok &= check(accounted, "pages are written or listed, never both or neither");
+        return ok;
+    }
+
+} // docs_gen_test
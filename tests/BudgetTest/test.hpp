@@ -0,0 +1,13 @@
+﻿#ifndef DOCS_GEN_TEST_BUDGET_H
+#define DOCS_GEN_TEST_BUDGET_H
+
+namespace docs_gen_test {
+
+    bool test_cancel_token();
+    bool test_cancelled_parse();
+    bool test_budget_generous();
+    bool test_budget_partial();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_BUDGET_H
\ No newline at end of file
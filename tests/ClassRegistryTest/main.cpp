@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_class_registry,
+        docs_gen_test::test_class_registry_long_chain,
+    });
+}
\ No newline at end of file
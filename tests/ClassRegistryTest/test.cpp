@@ -0,0 +1,110 @@
+﻿#include "test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/class_registry.hpp"
+#include "../core/log.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        struct declaration {
+            const wchar_t* file;
+            const wchar_t* class_name;
+            const wchar_t* extends;
+        };
+
+    } // namespace
+
+    bool test_class_registry() {
+        // a duplicated class_name is reported, the first declaration keeps the name
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+
+        const std::vector<declaration> scripts = {
+            { L"base.gd", L"Base", L"Node2D" },
+            { L"enemy.gd", L"Enemy", L"Base" },
+            { L"boss.gd", L"Boss", L"\"res://enemy.gd\"" },
+            { L"a.gd", L"A", L"B" },
+            { L"b.gd", L"B", L"A" },
+            { L"c.gd", L"C", L"A" },
+            { L"self.gd", L"Self", L"Self" },
+            { L"dup.gd", L"Base", L"Node" },
+            { L"unnamed.gd", L"", L"  Enemy # the one from enemy.gd" },
+            { L"missing.gd", L"Missing", L"\"res://nowhere.gd\"" },
+        };
+
+        const std::filesystem::path root = "project";
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        for (const auto& s : scripts) {
+            auto f = std::make_shared<docs_gen_core::script_file>(root / s.file);
+            f->set_id(files.size());
+            files.push_back(f);
+        }
+        docs_gen_core::path_resolver paths;
+        paths.build(root, files);
+
+        docs_gen_core::class_registry classes;
+        classes.reset(files.size());
+        for (std::size_t i = 0; i < scripts.size(); ++i) {
+            classes.set_declaration(i, scripts[i].class_name, scripts[i].extends);
+        }
+        classes.resolve(paths, files);
+
+        constexpr auto npos = docs_gen_core::file::npos;
+        const auto chain = [&](std::size_t id) { return classes.get_chain(id); };
+
+        bool ok = true;
+        ok &= check(classes.find(L"Enemy") == 1 && classes.find(L"Nope") == npos, "class names resolve to their scripts");
+        ok &= check(classes.find(L"Base") == 0, "a duplicated class_name stays with its first script");
+        ok &= check(classes.get_name(8).empty() && classes.get_name(1) == L"Enemy", "names are kept per script");
+
+        ok &= check(classes.get_parent(0) == npos && classes.get_native_base(0) == L"Node2D", "a builtin parent ends the chain");
+        ok &= check(chain(1) == std::vector<std::size_t>{ 0 }, "Enemy extends Base");
+        ok &= check(chain(2) == std::vector<std::size_t>{ 1, 0 }, "a quoted res:// path extends that script");
+        ok &= check(classes.get_native_base(2) == L"Node2D", "the native base is found through the chain");
+        ok &= check(chain(8) == std::vector<std::size_t>{ 1, 0 }, "comments and blanks are trimmed off extends");
+        ok &= check(classes.get_parent(9) == npos && classes.get_native_base(9) == L"\"res://nowhere.gd\"", "an unknown path is left unresolved");
+
+        ok &= check(classes.is_in_cycle(3) && classes.is_in_cycle(4), "A and B extend each other");
+        ok &= check(chain(3) == std::vector<std::size_t>{ 4 } && chain(4) == std::vector<std::size_t>{ 3 }, "a cycle member sees the other once");
+        ok &= check(classes.is_in_cycle(5) && chain(5) == std::vector<std::size_t>{ 3, 4 }, "extending a cycle stops after it");
+        ok &= check(classes.get_native_base(3).empty() && classes.get_native_base(5).empty(), "a looping chain has no native base");
+        ok &= check(!classes.is_in_cycle(6) && classes.get_parent(6) == npos, "a script extending itself has no parent");
+        ok &= check(!classes.is_in_cycle(0) && !classes.is_in_cycle(2) && !classes.is_in_cycle(8), "plain chains are not cycles");
+        return ok;
+    }
+
+    bool test_class_registry_long_chain() {
+        // C0 <- C1 <- ... <- Cn-1 with the leaf at id 0, so the first walk climbs the whole chain and
+        // every later one stops at a resolved script
+        constexpr std::size_t n = 5000;
+        const std::filesystem::path root = "project";
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        for (std::size_t i = 0; i < n; ++i) {
+            auto f = std::make_shared<docs_gen_core::script_file>(root / ("c" + std::to_string(i) + ".gd"));
+            f->set_id(i);
+            files.push_back(f);
+        }
+        docs_gen_core::path_resolver paths;
+        paths.build(root, files);
+
+        docs_gen_core::class_registry classes;
+        classes.reset(n);
+        for (std::size_t id = 0; id < n; ++id) {
+            const auto k = n - 1 - id;
+            const auto extends = k == 0 ? std::wstring(L"Object") : L"C" + std::to_wstring(k - 1);
+            classes.set_declaration(id, L"C" + std::to_wstring(k), extends);
+        }
+        classes.resolve(paths, files);
+
+        bool ok = true;
+        ok &= check(classes.get_chain(0).size() == n - 1 && classes.get_native_base(0) == L"Object", "a long chain resolves to its root");
+        ok &= check(classes.get_chain(n / 2).size() == n - 1 - n / 2 && classes.get_native_base(n / 2) == L"Object", "scripts halfway up share the root");
+        return ok;
+    }
+
+} // docs_gen_test
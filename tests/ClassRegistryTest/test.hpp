@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_CLASS_REGISTRY_H
+#define DOCS_GEN_TEST_CLASS_REGISTRY_H
+
+namespace docs_gen_test {
+
+    bool test_class_registry();
+    bool test_class_registry_long_chain();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_CLASS_REGISTRY_H
\ No newline at end of file
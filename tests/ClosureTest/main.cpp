@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_closure,
+        docs_gen_test::test_closure_deep_chain,
+    });
+}
\ No newline at end of file
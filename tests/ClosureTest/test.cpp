@@ -0,0 +1,103 @@
+﻿#include "test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/closure.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::vector<std::uint32_t> ids(docs_gen_core::id_range r) {
+            return { r.begin(), r.end() };
+        }
+
+        std::shared_ptr<docs_gen_core::scene_file> make_scene(std::vector<std::shared_ptr<docs_gen_core::file>>& files, const std::wstring& name) {
+            auto s = std::make_shared<docs_gen_core::scene_file>(L"project/" + name + L".tscn");
+            s->set_id(files.size());
+            files.push_back(s);
+            return s;
+        }
+
+        void link(const std::shared_ptr<docs_gen_core::scene_file>& from, const std::shared_ptr<docs_gen_core::scene_file>& to) {
+            from->push_packed_scene(std::to_wstring(to->get_id()), to);
+        }
+
+    } // namespace
+
+    bool test_closure() {
+        // main -> player -> gun, main -> level <-> room, mirror -> mirror, main -> main.gd
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        const auto main = make_scene(files, L"main");
+        const auto player = make_scene(files, L"player");
+        const auto level = make_scene(files, L"level");
+        const auto gun = make_scene(files, L"gun");
+        const auto room = make_scene(files, L"room");
+        const auto mirror = make_scene(files, L"mirror");
+        const auto script = std::make_shared<docs_gen_core::script_file>(L"project/main.gd");
+        script->set_id(files.size());
+        files.push_back(script);
+
+        link(main, player);
+        link(main, level);
+        link(player, gun);
+        link(level, room);
+        link(room, level);
+        link(mirror, mirror);
+        main->push_script(L"s", script);
+        for (const auto& f : files) {
+            if (const auto df = std::dynamic_pointer_cast<docs_gen_core::dott_file>(f)) df->freeze_links();
+        }
+
+        docs_gen_core::dependency_closure c;
+        c.build(files);
+
+        bool ok = true;
+        ok &= check(ids(c.get_closure(0)) == std::vector<std::uint32_t>{ 0, 1, 2, 3, 4, 6 }, "closure of main holds everything it reaches");
+        ok &= check(ids(c.get_closure(3)) == std::vector<std::uint32_t>{ 3 }, "closure of a leaf is itself");
+        ok &= check(ids(c.get_closure(2)) == ids(c.get_closure(4)), "members of a cycle share their closure");
+
+        const auto s = c.get_summary(0);
+        ok &= check(s.scenes == 4 && s.scripts == 1 && s.resources == 0, "summary of main counts scenes and scripts");
+
+        ok &= check(c.is_in_cycle(2) && c.is_in_cycle(4), "level and room form a cycle");
+        ok &= check(c.is_in_cycle(5), "a scene instancing itself is a cycle");
+        ok &= check(!c.is_in_cycle(0) && !c.is_in_cycle(1) && !c.is_in_cycle(3) && !c.is_in_cycle(6), "acyclic files are not in a cycle");
+        ok &= check(ids(c.get_cycle(2)) == std::vector<std::uint32_t>{ 2, 4 }, "cycle of level is level and room");
+        ok &= check(c.get_cycle(0).empty(), "main has no cycle");
+        ok &= check(c.in_same_cycle(2, 4) && !c.in_same_cycle(0, 2), "in_same_cycle only pairs the cycle members");
+        ok &= check(c.component_count() == 6, "level and room are one component");
+        return ok;
+    }
+
+    bool test_closure_deep_chain() {
+        // every closure of an open chain is stored, so that one stays short; the closed one is one
+        // component and can be deep enough that a recursive walk would run out of stack
+        const auto chain = [](std::size_t n, bool closed) {
+            std::vector<std::shared_ptr<docs_gen_core::file>> files;
+            std::vector<std::shared_ptr<docs_gen_core::scene_file>> scenes;
+            for (std::size_t i = 0; i < n; ++i) {
+                scenes.push_back(make_scene(files, L"s" + std::to_wstring(i)));
+            }
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                link(scenes[i], scenes[i + 1]);
+            }
+            if (closed) link(scenes[n - 1], scenes[0]);
+            return files;
+        };
+
+        bool ok = true;
+        docs_gen_core::dependency_closure c;
+        c.build(chain(1000, false));
+        ok &= check(c.get_closure(0).size() == 1000 && c.get_closure(999).size() == 1 && !c.is_in_cycle(0), "an open chain has no cycle");
+
+        constexpr std::size_t n = 200000;
+        c.build(chain(n, true));
+        ok &= check(c.component_count() == 1 && c.get_cycle(n / 2).size() == n, "a closed chain is one cycle");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_CLOSURE_H
+#define DOCS_GEN_TEST_CLOSURE_H
+
+namespace docs_gen_test {
+
+    bool test_closure();
+    bool test_closure_deep_chain();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_CLOSURE_H
\ No newline at end of file
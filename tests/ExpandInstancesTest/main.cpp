@@ -0,0 +1,10 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_expand_depth,
+        docs_gen_test::test_expand_cycle,
+        docs_gen_test::test_expand_modes,
+    });
+}
\ No newline at end of file
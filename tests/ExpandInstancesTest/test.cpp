@@ -0,0 +1,134 @@
+﻿#include "test.hpp"
+
+#include <string>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        // the lines between "# Node Tree" and "# External Resources"
+        std::string node_tree(const std::string& page) {
+            const std::string open = "# Node Tree\n";
+            const auto start = page.find(open);
+            const auto end = page.find("# External Resources\n");
+            if (start == std::string::npos || end == std::string::npos)
+                return {};
+            return page.substr(start + open.size(), end - start - open.size());
+        }
+
+        std::string without_node_tree(const std::string& page) {
+            const auto tree = node_tree(page);
+            if (tree.empty())
+                return page;
+            auto rest = page;
+            return rest.erase(rest.find(tree), tree.size());
+        }
+
+        std::map<std::string, std::string> gen_expanded(const std::filesystem::path& root, std::size_t depth) {
+            return gen_docs(root, [&](docs_gen_core::dir& d) { d.set_expand_instances(depth); });
+        }
+
+        const std::string main_depth_1 =
+            "- Main\n"
+            "\t- Player\n"
+            "\t\t  *script*: [player.gd](player.gd.md)\n"
+            "\t\t- Camera\n"
+            "\t\t\t- Enemy2\n"
+            "\t\t\t\t- Sprite\n"
+            "\t\t\t\t- Weapon\n"
+            "\t- Enemy1\n"
+            "\t\t- Sprite\n"
+            "\t\t- Weapon\n";
+
+        const std::string main_depth_2 =
+            "- Main\n"
+            "\t- Player\n"
+            "\t\t  *script*: [player.gd](player.gd.md)\n"
+            "\t\t- Camera\n"
+            "\t\t\t- Enemy2\n"
+            "\t\t\t\t- Sprite\n"
+            "\t\t\t\t- Weapon\n"
+            "\t\t\t\t\t- Blade\n"
+            "\t- Enemy1\n"
+            "\t\t- Sprite\n"
+            "\t\t- Weapon\n"
+            "\t\t\t- Blade\n";
+
+    } // namespace
+
+    bool test_expand_depth() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "expand_depth_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto plain = gen_docs(root);
+        const auto depth_0 = gen_expanded(root, 0);
+        const auto depth_1 = gen_expanded(root, 1);
+        const auto depth_2 = gen_expanded(root, 2);
+        const auto depth_9 = gen_expanded(root, 9);
+
+        bool ok = true;
+        ok &= check(depth_0 == plain, "depth 0 is the plain run");
+        ok &= check(node_tree(depth_1.at("scenes/main.tscn.md")) == main_depth_1, "depth 1 shows the nodes of each instanced scene");
+        ok &= check(node_tree(depth_2.at("scenes/main.tscn.md")) == main_depth_2, "depth 2 shows the scenes those instance");
+        ok &= check(depth_9 == depth_2, "a depth past the deepest instance changes nothing");
+        ok &= check(node_tree(depth_1.at("scenes/enemy.tscn.md")) == "- Enemy\n"
+            "\t  *script*: [enemy.gd](enemy.gd.md)\n\t  *stats*: [stats.tres](stats.tres.md)\n\t- Sprite\n\t- Weapon\n\t\t- Blade\n",
+            "every scene page expands its own instances");
+
+        // only the node trees change
+        bool rest_same = depth_2.size() == plain.size();
+        for (const auto& [path, page] : depth_2) {
+            rest_same &= without_node_tree(page) == without_node_tree(plain.at(path));
+        }
+        ok &= check(rest_same, "everything but the node trees is unchanged");
+        return ok;
+    }
+
+    bool test_expand_cycle() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "expand_cycle_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto docs = gen_expanded(root, 4);
+        bool ok = true;
+        ok &= check(node_tree(docs.at("scenes/level.tscn.md")) == "- Level\n\t- Room\n\t\t- *cycle*: [room.tscn](room.tscn.md)\n",
+            "an instance leading back to the page is cut");
+        ok &= check(node_tree(docs.at("scenes/room.tscn.md")) == "- Room\n\t- Level\n\t\t- *cycle*: [level.tscn](level.tscn.md)\n",
+            "from either side of the cycle");
+        return ok;
+    }
+
+    bool test_expand_modes() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "expand_modes_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        // streamed runs read an instanced scene again for its subtree, pooled ones share the memo
+        const auto plain = gen_expanded(root, 2);
+        docs_gen_core::thread_pool pool{ 4 };
+        const auto pooled = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_expand_instances(2);
+            d.set_thread_pool(&pool);
+        });
+        const auto streamed = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_expand_instances(2);
+            d.set_streaming(true);
+            d.set_thread_pool(&pool);
+        });
+
+        bool ok = true;
+        ok &= check(pooled == plain, "a pooled run expands the same");
+        ok &= check(streamed == plain, "a streamed run expands the same");
+        return ok;
+    }
+
+} // docs_gen_test
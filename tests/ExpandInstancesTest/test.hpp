@@ -0,0 +1,12 @@
+﻿#ifndef DOCS_GEN_TEST_EXPAND_INSTANCES_H
+#define DOCS_GEN_TEST_EXPAND_INSTANCES_H
+
+namespace docs_gen_test {
+
+    bool test_expand_depth();
+    bool test_expand_cycle();
+    bool test_expand_modes();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_EXPAND_INSTANCES_H
\ No newline at end of file
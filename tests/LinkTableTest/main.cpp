@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_link_table,
+        docs_gen_test::test_link_table_many,
+    });
+}
\ No newline at end of file
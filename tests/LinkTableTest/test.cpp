@@ -0,0 +1,68 @@
+﻿#include "test.hpp"
+
+#include <string>
+#include <vector>
+
+#include "../core/link_table.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    bool test_link_table() {
+        docs_gen_core::link_table<int> t;
+        bool ok = true;
+        ok &= check(t.find(L"1") == nullptr && t.empty(), "an empty table finds nothing");
+
+        ok &= check(t.insert_or_assign(L"1_abc", 1) && t.insert_or_assign(L"2_def", 2) && t.insert_or_assign(L"3", 3), "new ids insert");
+        ok &= check(!t.insert_or_assign(L"2_def", 20) && t.size() == 3, "a present id is overwritten");
+        ok &= check(*t.find(L"1_abc") == 1 && *t.find(L"2_def") == 20 && *t.find(L"3") == 3, "ids find their values");
+        ok &= check(t.find(L"1_ab") == nullptr && t.find(L"1_abcd") == nullptr && t.find(L"") == nullptr, "prefixes, suffixes and empty ids miss");
+
+        std::vector<std::wstring> keys;
+        std::vector<int> values;
+        for (const auto& [k, v] : t) {
+            keys.emplace_back(k);
+            values.push_back(v);
+        }
+        ok &= check(keys == std::vector<std::wstring>{ L"1_abc", L"2_def", L"3" } && values == std::vector<int>{ 1, 20, 3 },
+            "iteration follows the declaration order, overwrites keep their place");
+
+        t.freeze();
+        ok &= check(t.frozen() && !t.insert_or_assign(L"4", 4) && t.find(L"4") == nullptr && t.size() == 3, "a frozen table takes no more ids");
+        ok &= check(*t.find(L"2_def") == 20 && t.find(L"9") == nullptr, "a frozen table still finds its ids");
+
+        t.clear();
+        ok &= check(!t.frozen() && t.empty() && t.insert_or_assign(L"4", 4) && *t.find(L"4") == 4, "clear thaws the table");
+        return ok;
+    }
+
+    bool test_link_table_many() {
+        docs_gen_core::link_table<std::size_t> t;
+        constexpr std::size_t n = 3000;
+        for (std::size_t i = 0; i < n; ++i) {
+            t.insert_or_assign(std::to_wstring(i) + L"_k3v8x", i);
+        }
+
+        const auto all_found = [&] {
+            bool found = true;
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto* v = t.find(std::to_wstring(i) + L"_k3v8x");
+                found &= v && *v == i;
+                found &= t.find(std::to_wstring(i) + L"_k3v8y") == nullptr;
+            }
+            return found;
+        };
+
+        bool ok = true;
+        ok &= check(t.size() == n && all_found(), "every id survives the growth");
+        t.freeze();
+        ok &= check(t.size() == n && all_found(), "every id survives the shrink on freeze");
+
+        std::size_t expected = 0;
+        bool ordered = true;
+        for (const auto& [_, v] : t) ordered &= v == expected++;
+        ok &= check(ordered && expected == n, "order survives the rehashes");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_LINK_TABLE_H
+#define DOCS_GEN_TEST_LINK_TABLE_H
+
+namespace docs_gen_test {
+
+    bool test_link_table();
+    bool test_link_table_many();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_LINK_TABLE_H
\ No newline at end of file
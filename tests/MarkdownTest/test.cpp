@@ -0,0 +1,187 @@
+﻿#include "test.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/markdown.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        // a resource with every kind of field a resource page lists
+        void write_markdown_project(const std::filesystem::path& root) {
+            write_sample_project(root);
+            write_file(root / "res/curve.tres",
+                "[gd_resource type=\"Resource\" load_steps=4 format=3 uid=\"uid://bcurveres0001\"]\n\n"
+                "[ext_resource type=\"Script\" path=\"res://scripts/weapon.gd\" id=\"1_wp\"]\n"
+                "[ext_resource type=\"Texture2D\" path=\"res://icon.svg\" id=\"2_ic\"]\n"
+                "[ext_resource type=\"Resource\" uid=\"uid://b7x2k4m1q0abc\" path=\"res://res/stats.tres\" id=\"3_st\"]\n\n"
+                "[sub_resource type=\"Curve\" id=\"Curve_1\"]\npoint_count = 2\n\n"
+                "[resource]\nscript = ExtResource(\"1_wp\")\nicon = ExtResource(\"2_ic\")\nbase = ExtResource(\"3_st\")\n"
+                "curve = SubResource(\"Curve_1\")\nlabel = \"sharp\"\n");
+        }
+
+        const std::string main_page =
+            "#scene\n"
+            "# Node Tree\n"
+            "- Main\n"
+            "\t- Player\n"
+            "\t\t  *script*: [player.gd](player.gd.md)\n"
+            "\t\t- Camera\n"
+            "\t\t\t- Enemy2\n"
+            "\t- Enemy1\n"
+            "# External Resources\n"
+            "## Scenes\n"
+            "- [enemy.tscn](enemy.tscn.md)\n"
+            "## Scripts\n"
+            "- [player.gd](player.gd.md)\n"
+            "## Resources\n"
+            "# Dependencies\n"
+            "- Scenes: 2\n"
+            "- Scripts: 3\n"
+            "- Resources: 1\n"
+            "# Referenced by\n";
+
+        const std::string level_page =
+            "#scene\n"
+            "# Node Tree\n"
+            "- Level\n"
+            "\t- Room\n"
+            "# External Resources\n"
+            "## Scenes\n"
+            "- [room.tscn](room.tscn.md)\n"
+            "## Scripts\n"
+            "## Resources\n"
+            "# Dependencies\n"
+            "- Scenes: 1\n"
+            "- Scripts: 0\n"
+            "- Resources: 0\n"
+            "## Cycle\n"
+            "- [level.tscn](level.tscn.md)\n"
+            "- [room.tscn](room.tscn.md)\n"
+            "# Referenced by\n"
+            "- [room.tscn](room.tscn.md)\n";
+
+        const std::string curve_page =
+            "#resource\n"
+            "# Using\n"
+            "- script: [weapon.gd](weapon.gd.md)\n"
+            "- base: [stats.tres](stats.tres.md)\n"
+            "- icon: icon.svg\n"
+            "- curve: Curve\n"
+            "- label: \"sharp\"\n"
+            "## Sub_Resources\n"
+            "Curve\n"
+            "\t- point_count: 2\n"
+            "# External Resources\n"
+            "## Scripts\n"
+            "- [weapon.gd](weapon.gd.md)\n"
+            "## Scenes\n"
+            "## Resources\n"
+            "- [stats.tres](stats.tres.md)\n"
+            "- icon.svg: Texture2D\n"
+            "# Dependencies\n"
+            "- Scenes: 0\n"
+            "- Scripts: 2\n"
+            "- Resources: 1\n"
+            "# Referenced by\n";
+
+        const std::string player_page =
+            "#script\n"
+            "## Extends [Enemy](enemy.gd.md)\n"
+            "## Inherits [Enemy](enemy.gd.md) < Node2D\n"
+            "## Class Player\n"
+            "## Variables\n"
+            "- ### Default Export Group\n"
+            "\t- hp : int\n"
+            "## Functions\n"
+            "- move\n"
+            "\tArguments\n"
+            "\t- dir : Vector2\n"
+            "\t- who : [Enemy](enemy.gd.md)\n"
+            "\tReturn type: [Enemy](enemy.gd.md)\n"
+            "# Referenced by\n"
+            "- [main.tscn](main.tscn.md)\n";
+
+    } // namespace
+
+    bool test_markdown_buffer() {
+        bool ok = true;
+        docs_gen_core::markdown_buffer out;
+        ok &= check(out.empty() && out.size() == 0, "a new buffer is empty");
+
+        const std::wstring name = L"Player";
+        const std::wstring_view type = L"CharacterBody2D";
+        out.append(L"- ", name, L" (", type, L')', L'\n');
+        ok &= check(out.str() == L"- Player (CharacterBody2D)\n", "literals, strings, views and characters");
+        // a literal's length is its array size, so nothing in it is cut or counted twice
+        const auto before = out.size();
+        out.append(L"Unknown sub_resource\n");
+        ok &= check(out.str().substr(before) == L"Unknown sub_resource\n", "a literal is appended whole");
+        out.append(L"a\0b");
+        ok &= check(out.size() == before + 21 + 3 && out.str()[before + 22] == L'\0', "a NUL inside a literal included");
+
+        out.clear();
+        ok &= check(out.empty(), "clear empties it");
+        out.tabs(0).append(L"-").tabs(3).append(L"x");
+        ok &= check(out.str() == L"-\t\t\tx", "tabs");
+
+        out.clear();
+        out.number(0).append(L' ').number(-42).append(L' ').number(std::numeric_limits<std::int64_t>::min()).append(L' ')
+            .number(std::numeric_limits<std::uint64_t>::max()).append(L' ').number(static_cast<std::size_t>(7));
+        ok &= check(out.str() == L"0 -42 -9223372036854775808 18446744073709551615 7", "numbers of every width and sign");
+
+        docs_gen_core::markdown_buffer sized{ 4096 };
+        ok &= check(sized.str().capacity() >= 4096 && sized.empty(), "a buffer can start with its capacity");
+        // appends grow it geometrically, never to just the size of each part
+        docs_gen_core::markdown_buffer growing;
+        std::size_t grown = 0;
+        auto capacity = growing.str().capacity();
+        for (int i = 0; i < 10000; ++i) {
+            growing.append(L"- [enemy.tscn](enemy.tscn.md)\n");
+            if (growing.str().capacity() != capacity) {
+                ++grown;
+                capacity = growing.str().capacity();
+            }
+        }
+        ok &= check(growing.size() == 10000 * 30 && grown < 30, "growth at least doubles");
+
+        auto taken = growing.take();
+        ok &= check(taken.size() == 10000 * 30 && growing.empty(), "take moves the text out");
+        growing.append(L"again");
+        ok &= check(growing.str() == L"again", "and the buffer is reusable after");
+        return ok;
+    }
+
+    bool test_markdown_pages() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "markdown_page_test" };
+        const auto& root = project.path();
+        write_markdown_project(root);
+
+        const auto docs = gen_docs(root);
+        bool ok = true;
+        ok &= check(docs.at("scenes/main.tscn.md") == main_page, "a scene page, byte for byte");
+        ok &= check(docs.at("scenes/level.tscn.md") == level_page, "a scene in a cycle");
+        ok &= check(docs.at("res/curve.tres.md") == curve_page, "a resource with links, other files, sub_resources and plain fields");
+        ok &= check(docs.at("scripts/player.gd.md") == player_page, "a script with a class, exports and typed functions");
+
+        // every writer renders into its own buffer, the pages do not depend on who wrote them
+        docs_gen_core::thread_pool pool{ 4 };
+        const auto pooled = gen_docs(root, [&](docs_gen_core::dir& d) { d.set_thread_pool(&pool); });
+        const auto streamed = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_thread_pool(&pool);
+            d.set_streaming(true);
+        });
+        ok &= check(pooled == docs && streamed == docs, "pooled and streamed runs write the same bytes");
+        return ok;
+    }
+
+} // docs_gen_test
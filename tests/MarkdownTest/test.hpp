@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_MARKDOWN_H
+#define DOCS_GEN_TEST_MARKDOWN_H
+
+namespace docs_gen_test {
+
+    bool test_markdown_buffer();
+    bool test_markdown_pages();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_MARKDOWN_H
\ No newline at end of file
@@ -0,0 +1,182 @@
+﻿#include "test.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/parse_stats.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        constexpr std::uint64_t us = 1000;
+        constexpr std::uint64_t ms = 1000 * us;
+
+        std::vector<std::string> lines(const std::string& text) {
+            std::vector<std::string> out;
+            std::istringstream in{ text };
+            for (std::string line; std::getline(in, line); ) {
+                out.push_back(line);
+            }
+            return out;
+        }
+
+        // the lines after heading up to the next one that does not start with two spaces
+        std::vector<std::string> section(const std::vector<std::string>& report, const std::string& heading) {
+            std::vector<std::string> out;
+            auto it = std::find(report.begin(), report.end(), heading);
+            if (it == report.end()) return out;
+            for (++it; it != report.end() && it->rfind("  ", 0) == 0; ++it) {
+                out.push_back(*it);
+            }
+            return out;
+        }
+
+        std::vector<std::string> words(const std::string& line) {
+            std::vector<std::string> out;
+            std::istringstream in{ line };
+            for (std::string w; in >> w; ) {
+                out.push_back(w);
+            }
+            return out;
+        }
+
+    } // namespace
+
+    bool test_stats_report() {
+        const scratch_dir base{ "parse_stats_test" };
+        docs_gen_core::parse_stats stats;
+
+        std::ostringstream empty;
+        stats.write_report(empty);
+        bool ok = true;
+        ok &= check(empty.str() == "Parse statistics: no files parsed\n", "an empty run says so");
+
+        // one file per latency bucket, the second bucket twice; what record measures is now - start,
+        // so a start that far back stands in for a parse that long
+        struct sample { const char* name; std::size_t bytes; std::uint64_t ns; std::uint64_t nodes; };
+        const std::vector<sample> samples{
+            { "a.tscn", 2'000'000, 500 * ms, 40 },
+            { "b.tscn", 1'000, 50 * us, 3 },
+            { "c.tscn", 1'000, 5 * ms, 7 },
+            { "d.tres", 500'000, 250 * ms, 0 },
+            { "e.gd", 2'000, 500 * us, 0 },
+            { "f.gd", 2'000, 700 * us, 0 },
+            { "g.tscn", 8'000, 1'500 * ms, 12 },
+        };
+        for (const auto& s : samples) {
+            const auto path = base.path() / s.name;
+            write_file(path, std::string(s.bytes, 'x'));
+            std::shared_ptr<docs_gen_core::file> f;
+            if (path.extension() == ".tscn") f = std::make_shared<docs_gen_core::scene_file>(path);
+            else if (path.extension() == ".tres") f = std::make_shared<docs_gen_core::resource_file>(path);
+            else f = std::make_shared<docs_gen_core::script_file>(path);
+            stats.record(*f, 1, s.nodes, s.nodes * 2, docs_gen_core::parse_stats::now_ns() - s.ns);
+        }
+
+        ok &= check(stats.size() == samples.size(), "one entry per record");
+        const auto entries = stats.get_entries();
+        ok &= check(entries[0].bytes == 2'000'000 && entries[0].nodes == 40 && entries[0].fields == 80
+            && entries[0].kind == docs_gen_core::file_kind::scene, "an entry has the file size and the counts");
+        ok &= check(entries[0].duration_ns >= 500 * ms && entries[0].duration_ns < 501 * ms, "the duration runs from start_ns");
+
+        std::ostringstream out;
+        out << 1.23456789 << ' ';
+        stats.write_report(out, 3);
+        out << 1.23456789;
+        const auto text = out.str();
+        const auto report = lines(text.substr(text.find(' ') + 1));
+        ok &= check(text.rfind("1.23457 ", 0) == 0 && text.substr(text.size() - 7) == "1.23457", "the stream's formatting is restored");
+        ok &= check(!report.empty() && report[0].rfind("Parse statistics: 7 files, 2.51 MB, 2256.2", 0) == 0,
+            "the summary adds up every file");
+
+        // kind, files, MB, ms, MB/s
+        const auto kinds = section(report, "Parse statistics: " + report[0].substr(18));
+        ok &= check(kinds.size() == 4 && words(kinds[0]) == std::vector<std::string>{ "kind", "files", "MB", "ms", "MB/s" },
+            "a throughput row per kind");
+        if (kinds.size() == 4) {
+            const auto scene = words(kinds[1]);
+            const auto resource = words(kinds[2]);
+            const auto script = words(kinds[3]);
+            ok &= check(scene[0] == "scene" && scene[1] == "4" && scene[2] == "2.01" && scene[4] == "1.00",
+                "scenes: 2.01 MB in about 2 s is 1 MB/s");
+            ok &= check(resource[0] == "resource" && resource[1] == "1" && resource[4] == "2.00", "resources: 0.5 MB in 250 ms");
+            ok &= check(script[0] == "script" && script[1] == "2" && script[2] == "0.00", "scripts");
+        }
+
+        // bucket name, count, bar; the fullest bucket gets the whole 40 characters
+        const auto histogram = section(report, "Parse time per file:");
+        std::vector<std::string> counts;
+        std::vector<std::size_t> bars;
+        for (const auto& line : histogram) {
+            const auto w = words(line);
+            counts.push_back(w.size() >= 4 ? w[w.size() - (w.back()[0] == '#' ? 2 : 1)] : "");
+            bars.push_back(w.back()[0] == '#' ? w.back().size() : 0);
+        }
+        ok &= check(histogram.size() == 6 && histogram[0].rfind("  <  100 us", 0) == 0 && histogram[5].rfind("  >=   1 s ", 0) == 0,
+            "six buckets from 100 us to 1 s and over");
+        ok &= check(counts == std::vector<std::string>{ "1", "2", "1", "0", "2", "1" }, "each parse lands in its bucket");
+        ok &= check(bars == std::vector<std::size_t>{ 20, 40, 20, 0, 40, 20 }, "bars are scaled to the fullest bucket");
+
+        const auto slowest = section(report, "Slowest files:");
+        ok &= check(slowest.size() == 3 && slowest[0].find("g.tscn") != std::string::npos
+            && slowest[1].find("a.tscn") != std::string::npos && slowest[2].find("d.tres") != std::string::npos,
+            "the top three slowest, slowest first");
+        ok &= check(words(slowest[1])[2] == "2000.00" && words(slowest[1])[3] == "KB", "with their size");
+
+        const auto largest = section(report, "Largest node trees:");
+        ok &= check(largest.size() == 3 && words(largest[0])[0] == "40" && words(largest[1])[0] == "12" && words(largest[2])[0] == "7"
+            && words(largest[0])[2] == "80", "the top three node trees, largest first");
+
+        std::ostringstream all;
+        stats.write_report(all);
+        ok &= check(section(lines(all.str()), "Slowest files:").size() == 7
+            && section(lines(all.str()), "Largest node trees:").size() == 4, "a top past the entries lists them all, trees only");
+
+        stats.clear();
+        ok &= check(stats.size() == 0, "clear drops the entries");
+        return ok;
+    }
+
+    bool test_stats_run() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "parse_stats_run_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto plain = gen_docs(root);
+        docs_gen_core::parse_stats stats;
+        docs_gen_core::thread_pool pool{ 3 };
+        const auto counted = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_parse_stats(&stats);
+            d.set_thread_pool(&pool);
+        });
+
+        bool ok = true;
+        ok &= check(counted == plain, "counting does not change the docs");
+        const auto entries = stats.get_entries();
+        ok &= check(entries.size() == 10, "one entry per scene, resource and script");
+        bool main_found = false;
+        for (const auto& e : entries) {
+            if (e.path.filename() != "main.tscn") continue;
+            main_found = e.kind == docs_gen_core::file_kind::scene && e.nodes == 5 && e.bytes == std::filesystem::file_size(e.path);
+        }
+        ok &= check(main_found, "the main scene's entry has its five nodes");
+
+        stats.clear();
+        const auto streamed = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_parse_stats(&stats);
+            d.set_streaming(true);
+        });
+        ok &= check(streamed == plain && stats.size() == 10, "a streamed run counts each body once");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_PARSE_STATS_H
+#define DOCS_GEN_TEST_PARSE_STATS_H
+
+namespace docs_gen_test {
+
+    bool test_stats_report();
+    bool test_stats_run();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_PARSE_STATS_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+﻿#include "test.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/path_resolver.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    bool test_path_resolver() {
+        const std::filesystem::path root = "project";
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        for (const auto* p : { "scenes/main.tscn", "scripts/player.gd", "res/a b/c.tres", "main.tscn" }) {
+            auto f = std::make_shared<docs_gen_core::script_file>(root / p);
+            f->set_id(files.size());
+            files.push_back(f);
+        }
+        // null entries are skipped
+        files.push_back(nullptr);
+
+        docs_gen_core::path_resolver paths;
+        bool ok = true;
+        ok &= check(paths.resolve("res://scenes/main.tscn") == docs_gen_core::file::npos, "an empty resolver knows nothing");
+
+        paths.build(root, files);
+        ok &= check(paths.size() == 4, "every file is stored once");
+        ok &= check(paths.resolve("res://scenes/main.tscn") == 0, "res:// path hits");
+        ok &= check(paths.resolve("scenes/main.tscn") == 0, "bare path hits");
+        ok &= check(paths.resolve(L"res://scripts/player.gd") == 1, "wide path hits");
+        ok &= check(paths.resolve("res://res/a b/c.tres") == 2, "path with a space hits");
+        ok &= check(paths.resolve("scenes\\main.tscn") == 0, "backslashes read as slashes");
+        ok &= check(paths.resolve("res://main.tscn") == 3, "same file name in another folder is a different key");
+
+        ok &= check(paths.resolve("res://scenes/main.tsc") == docs_gen_core::file::npos, "prefix of a key misses");
+        ok &= check(paths.resolve("res://scenes/main.tscnx") == docs_gen_core::file::npos, "key with a suffix misses");
+        ok &= check(paths.resolve("res://Scenes/main.tscn") == docs_gen_core::file::npos, "keys are case sensitive");
+        ok &= check(paths.resolve("res://") == docs_gen_core::file::npos && paths.resolve("") == docs_gen_core::file::npos, "empty path misses");
+        ok &= check(paths.resolve("uid://scenes/main.tscn") == docs_gen_core::file::npos, "only res:// is stripped");
+        return ok;
+    }
+
+    bool test_path_resolver_many() {
+        const std::filesystem::path root = "project";
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        for (std::size_t i = 0; i < 5000; ++i) {
+            auto f = std::make_shared<docs_gen_core::resource_file>(root / ("dir" + std::to_string(i % 17)) / ("file" + std::to_string(i) + ".tres"));
+            f->set_id(i);
+            files.push_back(f);
+        }
+
+        docs_gen_core::path_resolver paths;
+        paths.build(root, files);
+
+        bool hits = true;
+        bool misses = true;
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            const auto key = "res://dir" + std::to_string(i % 17) + "/file" + std::to_string(i) + ".tres";
+            hits &= paths.resolve(key) == i;
+            const auto other = "res://dir" + std::to_string((i + 1) % 17) + "/file" + std::to_string(i) + ".tres";
+            misses &= paths.resolve(other) == docs_gen_core::file::npos;
+        }
+
+        bool ok = true;
+        ok &= check(hits, "every one of 5000 paths resolves to its id");
+        ok &= check(misses, "the same names in the wrong folders miss");
+        return ok;
+    }
+
+} // docs_gen_test
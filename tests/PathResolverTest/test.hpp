@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_PATH_RESOLVER_H
+#define DOCS_GEN_TEST_PATH_RESOLVER_H
+
+namespace docs_gen_test {
+
+    bool test_path_resolver();
+    bool test_path_resolver_many();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_PATH_RESOLVER_H
\ No newline at end of file
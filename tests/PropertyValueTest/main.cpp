@@ -0,0 +1,12 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_decode_scalars,
+        docs_gen_test::test_decode_strings,
+        docs_gen_test::test_decode_math,
+        docs_gen_test::test_decode_packed,
+        docs_gen_test::test_property_page,
+    });
+}
\ No newline at end of file
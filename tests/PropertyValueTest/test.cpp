@@ -0,0 +1,204 @@
+﻿#include "test.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/markdown.hpp"
+#include "../core/parser.hpp"
+#include "../core/property_value.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        using docs_gen_core::value_kind;
+
+        std::wstring written(const docs_gen_core::typed_value& v) {
+            docs_gen_core::markdown_buffer out;
+            docs_gen_core::write_value(out, v);
+            return out.take();
+        }
+
+        value_kind kind_of(const wchar_t* text) {
+            return docs_gen_core::decode_value(text).kind;
+        }
+
+        // text decodes and is written back unchanged
+        bool round_trips(const wchar_t* text) {
+            return written(docs_gen_core::decode_value(text)) == text;
+        }
+
+        std::vector<double> components(const docs_gen_core::typed_value& v) {
+            return { v.components.begin(), v.components.begin() + static_cast<std::ptrdiff_t>(v.component_count) };
+        }
+
+    } // namespace
+
+    bool test_decode_scalars() {
+        bool ok = true;
+        ok &= check(kind_of(L"null") == value_kind::null && kind_of(L"") == value_kind::other, "null, and nothing is not a value");
+        const auto yes = docs_gen_core::decode_value(L" true ");
+        ok &= check(yes.kind == value_kind::boolean && yes.boolean && !docs_gen_core::decode_value(L"false").boolean,
+            "booleans, surrounding space trimmed");
+
+        // anything without '.', 'e', 'E' or 'n' is tried as an integer first
+        const auto i = docs_gen_core::decode_value(L"-42");
+        ok &= check(i.kind == value_kind::integer && i.integer == -42, "an integer");
+        ok &= check(docs_gen_core::decode_value(L"+5").integer == 5 && kind_of(L"+5") == value_kind::integer, "with a plus sign");
+        const auto big = docs_gen_core::decode_value(L"9223372036854775807");
+        ok &= check(big.kind == value_kind::integer && big.integer == std::numeric_limits<std::int64_t>::max(), "up to int64's limit");
+        const auto past = docs_gen_core::decode_value(L"9223372036854775808");
+        ok &= check(past.kind == value_kind::real && past.real == 9223372036854775808.0, "past it a real");
+        const auto one = docs_gen_core::decode_value(L"1.0");
+        ok &= check(one.kind == value_kind::real && one.real == 1.0, "a '.' makes a real");
+        ok &= check(docs_gen_core::decode_value(L"1e3").real == 1000.0 && kind_of(L"1E3") == value_kind::real
+            && kind_of(L"1e3") == value_kind::real, "so does an exponent");
+        ok &= check(kind_of(L"12abc") == value_kind::other && kind_of(L"0x10") == value_kind::other && kind_of(L"1.5.2") == value_kind::other
+            && kind_of(L"--1") == value_kind::other, "a number has to parse whole");
+        ok &= check(kind_of(L"\x0661\x0662") == value_kind::other, "digits outside ascii are not numbers");
+
+        const auto inf = docs_gen_core::decode_value(L"inf");
+        const auto inf_neg = docs_gen_core::decode_value(L"inf_neg");
+        const auto nan = docs_gen_core::decode_value(L"nan");
+        ok &= check(inf.kind == value_kind::real && std::isinf(inf.real) && inf.real > 0, "inf");
+        ok &= check(inf_neg.kind == value_kind::real && std::isinf(inf_neg.real) && inf_neg.real < 0
+            && docs_gen_core::decode_value(L"-inf").real == inf_neg.real, "inf_neg, and -inf as well");
+        ok &= check(nan.kind == value_kind::real && std::isnan(nan.real), "nan");
+        ok &= check(written(inf) == L"inf" && written(inf_neg) == L"inf_neg" && written(nan) == L"nan"
+            && written(docs_gen_core::decode_value(L"-inf")) == L"inf_neg", "and written the way godot spells them");
+
+        ok &= check(written(docs_gen_core::decode_value(L"0.1")) == L"0.1" && written(docs_gen_core::decode_value(L"1e-07")) == L"1e-07"
+            && written(docs_gen_core::decode_value(L"2.5")) == L"2.5", "reals in their shortest form");
+        bool exact = true;
+        for (const double d : { 0.1, 1.0 / 3.0, 1e300, 5e-324, -123.456, 6.02214076e23 }) {
+            auto v = docs_gen_core::decode_value(L"0.5");
+            v.real = d;
+            const auto text = written(v);
+            const auto back = docs_gen_core::decode_value(text);
+            exact &= back.kind == value_kind::real && back.real == d;
+        }
+        ok &= check(exact, "and read back to the same double");
+        ok &= check(written(i) == L"-42" && written(yes) == L"true" && written(docs_gen_core::decode_value(L"null")) == L"null",
+            "integers, booleans and null are written back");
+        return ok;
+    }
+
+    bool test_decode_strings() {
+        bool ok = true;
+        const auto plain = docs_gen_core::decode_value(L"\"hello\"");
+        ok &= check(plain.kind == value_kind::string && plain.text == L"hello", "a string, without its quotes");
+        const auto name = docs_gen_core::decode_value(L"&\"idle\"");
+        ok &= check(name.kind == value_kind::string && name.text == L"idle", "a StringName");
+        ok &= check(docs_gen_core::decode_value(L"\"\"").kind == value_kind::string && docs_gen_core::decode_value(L"\"\"").text.empty(),
+            "an empty string");
+
+        const auto escaped = docs_gen_core::decode_value(L"\"say \\\"hi\\\"\"");
+        ok &= check(escaped.kind == value_kind::string && escaped.text == L"say \\\"hi\\\"", "escaped quotes stay escaped");
+        ok &= check(written(escaped) == L"\"say \\\"hi\\\"\"", "and are written back as they were");
+        ok &= check(kind_of(L"\"a\"b\"") == value_kind::other, "an unescaped quote inside is not one string");
+        ok &= check(kind_of(L"\"a\\\"") == value_kind::other, "a trailing backslash escapes the closing quote");
+        const auto slashes = docs_gen_core::decode_value(L"\"a\\\\\"");
+        ok &= check(slashes.kind == value_kind::string && slashes.text == L"a\\\\", "two of them are an escaped backslash");
+        ok &= check(kind_of(L"\"open") == value_kind::other && kind_of(L"&name") == value_kind::other && kind_of(L"\"") == value_kind::other,
+            "a string needs both quotes");
+        ok &= check(written(name) == L"\"idle\"", "a StringName is written as its text");
+        return ok;
+    }
+
+    bool test_decode_math() {
+        bool ok = true;
+        const auto v = docs_gen_core::decode_value(L"Vector2(10, 20.5)");
+        ok &= check(v.kind == value_kind::math && v.type == L"Vector2" && components(v) == std::vector<double>{ 10, 20.5 }, "a Vector2");
+        ok &= check(round_trips(L"Vector2(10, 20.5)"), "written back");
+        const auto t = docs_gen_core::decode_value(L"Transform3D(1, 0, 0, 0, 1, 0, 0, 0, 1, 0.5, -2, 3)");
+        ok &= check(t.kind == value_kind::math && t.component_count == 12 && t.components[9] == 0.5 && t.components[10] == -2,
+            "a Transform3D, basis then origin");
+        ok &= check(round_trips(L"Transform3D(1, 0, 0, 0, 1, 0, 0, 0, 1, 0.5, -2, 3)"), "written back");
+        ok &= check(round_trips(L"Color(1, 0.5, 0.25, 1)"), "a Color written back");
+        ok &= check(written(docs_gen_core::decode_value(L"Vector2( 1 ,2.50 )")) == L"Vector2(1, 2.5)", "spacing and digits normalized");
+        ok &= check(round_trips(L"Vector2(inf, inf_neg)") && round_trips(L"Color(nan, 0, 0, 1)"), "with inf, inf_neg and nan inside");
+
+        ok &= check(kind_of(L"Vector2(1, 2,)") == value_kind::other && kind_of(L"Vector2(1, 2, )") == value_kind::other,
+            "a trailing comma is not a value");
+        ok &= check(kind_of(L"Vector2(1,, 2)") == value_kind::other && kind_of(L"Vector2(, 1, 2)") == value_kind::other,
+            "nor an empty component");
+        ok &= check(kind_of(L"Vector2(1, 2, 3)") == value_kind::other, "too many components");
+        ok &= check(kind_of(L"Color(1, 0.5, 0.25)") == value_kind::other && kind_of(L"Vector2()") == value_kind::other,
+            "too few");
+        const auto bad = docs_gen_core::decode_value(L"Vector3(1, 2, x)");
+        ok &= check(bad.kind == value_kind::other && bad.component_count == 0 && bad.type.empty(), "a failed value keeps nothing");
+        ok &= check(kind_of(L"Vector2(1, 2") == value_kind::other && kind_of(L"Widget(1, 2)") == value_kind::other
+            && kind_of(L"ExtResource(\"1_ab\")") == value_kind::other && kind_of(L"[1, 2]") == value_kind::other,
+            "unclosed, unknown and reference values are left alone");
+        return ok;
+    }
+
+    bool test_decode_packed() {
+        bool ok = true;
+        const auto p = docs_gen_core::decode_value(L"PackedVector2Array(0, 1, 2.5, -3)");
+        ok &= check(p.kind == value_kind::packed && p.type == L"PackedVector2Array" && p.components_per_element == 2
+            && p.element_count() == 2 && p.elements == std::vector<double>{ 0, 1, 2.5, -3 }, "a PackedVector2Array");
+        ok &= check(round_trips(L"PackedVector2Array(0, 1, 2.5, -3)"), "written back");
+        const auto empty = docs_gen_core::decode_value(L"PackedInt32Array()");
+        ok &= check(empty.kind == value_kind::packed && empty.element_count() == 0 && written(empty) == L"PackedInt32Array()",
+            "an empty array");
+
+        const auto odd = docs_gen_core::decode_value(L"PackedVector2Array(1, 2, 3)");
+        ok &= check(odd.kind == value_kind::other && odd.elements.empty(), "a length that is not a multiple of the element size");
+        ok &= check(kind_of(L"PackedColorArray(1, 1, 1, 1, 0, 0, 0)") == value_kind::other, "for colors too");
+        ok &= check(kind_of(L"PackedInt32Array(1, 2,)") == value_kind::other, "a trailing comma");
+
+        // past max_components scalars only the count is written
+        std::wstring long_text = L"PackedVector2Array(";
+        for (int i = 0; i < 20; ++i) long_text += (i ? L", " : L"") + std::to_wstring(i);
+        long_text += L")";
+        const auto many = docs_gen_core::decode_value(long_text);
+        ok &= check(many.kind == value_kind::packed && many.element_count() == 10, "a long array keeps every element");
+        ok &= check(written(many) == L"PackedVector2Array (10 elements)", "and is written as its count");
+        std::wstring sixteen = L"PackedFloat32Array(";
+        for (int i = 0; i < 16; ++i) sixteen += (i ? L", " : L"") + std::to_wstring(i);
+        sixteen += L")";
+        ok &= check(written(docs_gen_core::decode_value(sixteen)) == sixteen, "sixteen scalars are still written out");
+        return ok;
+    }
+
+    bool test_property_page() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "property_page_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto plain = gen_docs(root);
+        docs_gen_core::parse_options options;
+        options.node_properties = true;
+        const auto typed = gen_docs(root, [&](docs_gen_core::dir& d) { d.set_parse_options(options); });
+
+        bool ok = true;
+        ok &= check(typed.at("scenes/main.tscn.md").find("\t- Player\n\t\t  *script*: [player.gd](player.gd.md)\n"
+            "\t\t  *transform*: Transform2D(1, 0, 0, 1, 5, 6)\n") != std::string::npos,
+            "a node lists its decoded properties");
+        ok &= check(typed.at("scenes/enemy.tscn.md").find("- Enemy\n\t  *script*: [enemy.gd](enemy.gd.md)\n"
+            "\t  *stats*: [stats.tres](stats.tres.md)\n\t  *position*: Vector2(10, 20.5)\n") != std::string::npos,
+            "after its resources");
+        ok &= check(typed.at("scenes/enemy.tscn.md").find("\t- Sprite\n\t\t  *modulate*: Color(1, 0.5, 0.25, 1)\n") != std::string::npos,
+            "at every depth");
+        ok &= check(typed.at("scenes/main.tscn.md").find("*script*: ExtResource") == std::string::npos, "references are not listed twice");
+
+        // without the flag the pages are what they were
+        auto rest = typed;
+        rest.erase("scenes/main.tscn.md");
+        rest.erase("scenes/enemy.tscn.md");
+        auto plain_rest = plain;
+        plain_rest.erase("scenes/main.tscn.md");
+        plain_rest.erase("scenes/enemy.tscn.md");
+        ok &= check(rest == plain_rest, "scenes without properties are unchanged");
+        ok &= check(plain.at("scenes/main.tscn.md").find("*transform*") == std::string::npos, "and nothing is listed without the flag");
+        return ok;
+    }
+
+} // docs_gen_test
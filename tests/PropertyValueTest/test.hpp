@@ -0,0 +1,14 @@
+﻿#ifndef DOCS_GEN_TEST_PROPERTY_VALUE_H
+#define DOCS_GEN_TEST_PROPERTY_VALUE_H
+
+namespace docs_gen_test {
+
+    bool test_decode_scalars();
+    bool test_decode_strings();
+    bool test_decode_math();
+    bool test_decode_packed();
+    bool test_property_page();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_PROPERTY_VALUE_H
\ No newline at end of file
@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_reachable_project,
+        docs_gen_test::test_reachable_entries,
+    });
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+﻿#include "test.hpp"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::set<std::string> pages(const std::map<std::string, std::string>& docs) {
+            std::set<std::string> out;
+            for (const auto& [path, page] : docs) {
+                if (path.size() > 3 && path.compare(path.size() - 3, 3, ".md") == 0) out.insert(path);
+            }
+            return out;
+        }
+
+        // every page of a reachable run is the full run's page for the same file
+        bool same_pages(const std::map<std::string, std::string>& reached, const std::map<std::string, std::string>& full) {
+            for (const auto& path : pages(reached)) {
+                const auto it = full.find(path);
+                if (it == full.end() || it->second != reached.at(path)) return false;
+            }
+            return true;
+        }
+
+        std::map<std::string, std::string> gen_reachable(const std::filesystem::path& root, const std::vector<std::wstring>& entries,
+            docs_gen_core::thread_pool* pool = nullptr, bool streaming = false) {
+            return gen_docs(root, [&](docs_gen_core::dir& d) {
+                d.set_reachable_only(true);
+                d.set_entry_points(entries);
+                d.set_thread_pool(pool);
+                d.set_streaming(streaming);
+            });
+        }
+
+    } // namespace
+
+    bool test_reachable_project() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "reachable_project_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        // without --entry the main scene and the autoloads of project.godot are the roots
+        const auto full = gen_docs(root);
+        const auto reached = gen_reachable(root, {});
+
+        bool ok = true;
+        ok &= check(pages(reached) == std::set<std::string>{
+            "scenes/main.tscn.md", "scenes/enemy.tscn.md", "scenes/weapon.tscn.md", "res/stats.tres.md",
+            "scripts/player.gd.md", "scripts/enemy.gd.md", "scripts/weapon.gd.md", "scripts/globals.gd.md" },
+            "the main scene and the autoload reach all but the level and the room");
+        ok &= check(same_pages(reached, full), "a reached page is the full run's page");
+
+        docs_gen_core::thread_pool pool{ 3 };
+        ok &= check(gen_reachable(root, {}, &pool) == reached, "a pooled walk reaches the same");
+        ok &= check(gen_reachable(root, {}, &pool, true) == reached, "a streamed walk reaches the same");
+        return ok;
+    }
+
+    bool test_reachable_entries() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::off);
+        const scratch_dir project{ "reachable_entry_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        const auto full = gen_docs(root);
+        bool ok = true;
+
+        const auto level = gen_reachable(root, { L"res://scenes/level.tscn" });
+        ok &= check(pages(level) == std::set<std::string>{ "scenes/level.tscn.md", "scenes/room.tscn.md" },
+            "--entry replaces project.godot's roots and follows the cycle once");
+        ok &= check(same_pages(level, full), "with the full run's pages");
+
+        const auto by_uid = gen_reachable(root, { L"uid://cweaponscene1" });
+        ok &= check(pages(by_uid) == std::set<std::string>{ "scenes/weapon.tscn.md", "scripts/weapon.gd.md" },
+            "an entry can be a uid");
+
+        const auto twice = gen_reachable(root, { L"res://scenes/weapon.tscn", L"res://scenes/enemy.tscn", L"res://nothing/here.tscn" });
+        ok &= check(pages(twice) == std::set<std::string>{ "scenes/enemy.tscn.md", "scenes/weapon.tscn.md", "res/stats.tres.md",
+            "scripts/enemy.gd.md", "scripts/weapon.gd.md" }, "roots reaching each other are walked once, a missing one is skipped");
+        // main.tscn is not reached, so it no longer refers to the enemy
+        ok &= check(twice.at("scenes/enemy.tscn.md") == full.at("scenes/enemy.tscn.md").substr(0, full.at("scenes/enemy.tscn.md").find("- [main.tscn]")),
+            "a referrer that was not reached is left out");
+        // and player.gd is not a page to link its class name to
+        auto enemy_script = full.at("scripts/enemy.gd.md");
+        enemy_script.replace(enemy_script.find("[Player](player.gd.md)"), 22, "Player");
+        ok &= check(twice.at("scripts/enemy.gd.md") == enemy_script, "a class whose script was not reached is plain text");
+        auto rest = twice;
+        rest.erase("scenes/enemy.tscn.md");
+        rest.erase("scripts/enemy.gd.md");
+        ok &= check(same_pages(rest, full), "the other pages are still the full run's");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_REACHABLE_H
+#define DOCS_GEN_TEST_REACHABLE_H
+
+namespace docs_gen_test {
+
+    bool test_reachable_project();
+    bool test_reachable_entries();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_REACHABLE_H
\ No newline at end of file
@@ -0,0 +1,106 @@
+﻿#include "test.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/dir.hpp"
+#include "../core/ref_index.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::vector<std::uint32_t> ids(docs_gen_core::id_range r) {
+            return { r.begin(), r.end() };
+        }
+
+        // the project relative paths of what refers to the file at path, sorted
+        std::vector<std::string> referrers(const docs_gen_core::dir& d, const std::filesystem::path& root, const std::string& path) {
+            std::vector<std::string> names;
+            for (std::size_t id = 0; const auto f = d.get_file(id); ++id) {
+                if (f->get_path().lexically_relative(root).generic_string() != path)
+                    continue;
+                for (const auto& r : d.get_referrers(*f)) {
+                    names.push_back(r->get_path().lexically_relative(root).generic_string());
+                }
+            }
+            std::sort(names.begin(), names.end());
+            return names;
+        }
+
+    } // namespace
+
+    bool test_ref_index() {
+        // main -> enemy (twice, under two keys), main -> main.gd, enemy -> main.gd, enemy -> stats,
+        // stats -> stats, a null slot
+        std::vector<std::shared_ptr<docs_gen_core::file>> files;
+        const auto main = std::make_shared<docs_gen_core::scene_file>("project/main.tscn");
+        const auto enemy = std::make_shared<docs_gen_core::scene_file>("project/enemy.tscn");
+        const auto script = std::make_shared<docs_gen_core::script_file>("project/main.gd");
+        const auto stats = std::make_shared<docs_gen_core::resource_file>("project/stats.tres");
+        for (const auto& f : std::vector<std::shared_ptr<docs_gen_core::file>>{ main, enemy, script, stats }) {
+            f->set_id(files.size());
+            files.push_back(f);
+        }
+        files.push_back(nullptr);
+        main->push_packed_scene(L"1_en", enemy);
+        main->push_packed_scene(L"2_en", enemy);
+        main->push_script(L"3_sc", script);
+        enemy->push_script(L"1_sc", script);
+        enemy->push_ext_resource(L"2_st", stats);
+        stats->push_ext_resource(L"1_st", stats);
+
+        std::vector<std::size_t> refs;
+        docs_gen_core::collect_direct_references(*main, refs);
+        bool ok = true;
+        ok &= check(refs == std::vector<std::size_t>{ 1, 2 }, "direct references are sorted and listed once");
+
+        docs_gen_core::ref_index index;
+        index.build(files);
+        ok &= check(index.size() == files.size(), "one entry per file slot");
+        ok &= check(ids(index.get_referrers(1)) == std::vector<std::uint32_t>{ 0 }, "a scene instanced twice has one referrer");
+        ok &= check(ids(index.get_referrers(2)) == std::vector<std::uint32_t>{ 0, 1 }, "referrers come in id order");
+        ok &= check(ids(index.get_referrers(3)) == std::vector<std::uint32_t>{ 1 }, "a file referring to itself is left out");
+        ok &= check(index.get_referrers(0).empty() && index.get_referrers(4).empty(), "unreferenced and null slots have none");
+        ok &= check(index.get_referrers(100).empty(), "an id past the end has none");
+        ok &= check(index.edge_count() == 4, "every distinct edge is stored once");
+
+        index.clear();
+        ok &= check(index.size() == 0 && index.get_referrers(1).empty(), "clear empties the index");
+        return ok;
+    }
+
+    bool test_ref_index_project() {
+        const scratch_dir project{ "ref_index_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        docs_gen_core::dir d;
+        bool ok = true;
+        ok &= check(d.set_path(root.wstring()), "the project opens");
+        d.construct_file_tree();
+
+        using names = std::vector<std::string>;
+        ok &= check(referrers(d, root, "scenes/enemy.tscn") == names{ "scenes/main.tscn" }, "an instanced scene knows its instancer");
+        ok &= check(referrers(d, root, "scripts/enemy.gd") == names{ "res/stats.tres", "scenes/enemy.tscn" },
+            "a script knows the scene and the resource using it");
+        ok &= check(referrers(d, root, "scenes/level.tscn") == names{ "scenes/room.tscn" }
+            && referrers(d, root, "scenes/room.tscn") == names{ "scenes/level.tscn" }, "a cycle refers both ways");
+        ok &= check(referrers(d, root, "scenes/main.tscn").empty() && referrers(d, root, "scripts/globals.gd").empty(),
+            "the main scene and an autoload have no referrers");
+
+        d.gen_docs();
+        const auto page = read_file(root / "docs/scenes/enemy.tscn.md");
+        const std::string section = "# Referenced by\n- [main.tscn](main.tscn.md)\n";
+        ok &= check(page.size() >= section.size() && page.compare(page.size() - section.size(), section.size(), section) == 0,
+            "the page ends with its referrers");
+        const auto main_page = read_file(root / "docs/scenes/main.tscn.md");
+        ok &= check(main_page.size() > 16 && main_page.compare(main_page.size() - 16, 16, "# Referenced by\n") == 0,
+            "an unreferenced page has an empty section");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_REFERENCE_INDEX_H
+#define DOCS_GEN_TEST_REFERENCE_INDEX_H
+
+namespace docs_gen_test {
+
+    bool test_ref_index();
+    bool test_ref_index_project();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_REFERENCE_INDEX_H
\ No newline at end of file
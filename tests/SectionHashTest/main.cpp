@@ -0,0 +1,10 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_section_hash,
+        docs_gen_test::test_field_hash,
+        docs_gen_test::test_section_fields,
+    });
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+﻿#include "test.hpp"
+
+#include <string>
+#include <string_view>
+
+#include "../core/section.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::wstring widen(std::string_view s) {
+            return { s.begin(), s.end() };
+        }
+
+        bool is_name(std::string_view s) {
+            for (const auto n : docs_gen_core::detail::section_names) if (n == s) return true;
+            for (const auto n : docs_gen_core::detail::field_names) if (n == s) return true;
+            return false;
+        }
+
+        // the lookup is usable in constant expressions
+        static_assert(docs_gen_core::to_section_kind(std::string_view("node")) == docs_gen_core::section_kind::node);
+        static_assert(docs_gen_core::to_field_key(std::wstring_view(L"instance_placeholder")) == docs_gen_core::field_key::instance_placeholder);
+
+    } // namespace
+
+    bool test_section_hash() {
+        using docs_gen_core::section_kind;
+
+        bool known = true;
+        for (std::size_t i = 0; i < docs_gen_core::detail::section_names.size(); ++i) {
+            const auto name = docs_gen_core::detail::section_names[i];
+            const auto kind = static_cast<section_kind>(i);
+            known &= docs_gen_core::to_section_kind(name) == kind;
+            known &= docs_gen_core::to_section_kind(std::wstring_view(widen(name))) == kind;
+            known &= docs_gen_core::to_string(kind) == name;
+        }
+
+        bool ok = true;
+        ok &= check(known, "every section name maps to its kind, narrow and wide");
+        ok &= check(docs_gen_core::to_section_kind(std::string_view("")) == section_kind::unknown, "empty section name is unknown");
+        ok &= check(docs_gen_core::to_section_kind(std::string_view("nod")) == section_kind::unknown
+            && docs_gen_core::to_section_kind(std::string_view("nodes")) == section_kind::unknown, "prefix and suffix of a name are unknown");
+        ok &= check(docs_gen_core::to_section_kind(std::string_view("Node")) == section_kind::unknown, "section names are case sensitive");
+        ok &= check(docs_gen_core::to_section_kind(std::string_view("path")) == section_kind::unknown, "a field name is no section");
+        ok &= check(docs_gen_core::to_string(section_kind::unknown) == "unknown", "unknown kind has a name");
+        return ok;
+    }
+
+    bool test_field_hash() {
+        using docs_gen_core::field_key;
+
+        bool known = true;
+        for (std::size_t i = 0; i < docs_gen_core::detail::field_names.size(); ++i) {
+            const auto name = docs_gen_core::detail::field_names[i];
+            const auto key = static_cast<field_key>(i);
+            known &= docs_gen_core::to_field_key(name) == key;
+            known &= docs_gen_core::to_field_key(std::wstring_view(widen(name))) == key;
+            known &= docs_gen_core::to_string(key) == name;
+        }
+
+        // every other key of up to three letters, plus underscores, lands on some slot; a taken
+        // one must still compare as unknown
+        bool unknown = true;
+        std::size_t tried = 0;
+        const std::string_view alphabet = "abcdefghijklmnopqrstuvwxyz_";
+        std::string s;
+        for (const auto a : alphabet) {
+            for (const auto b : alphabet) {
+                for (const auto c : alphabet) {
+                    for (const std::size_t n : { 1u, 2u, 3u }) {
+                        s = { a, b, c };
+                        s.resize(n);
+                        if (is_name(s)) continue;
+                        unknown &= docs_gen_core::to_field_key(std::string_view(s)) == field_key::unknown;
+                        unknown &= docs_gen_core::to_section_kind(std::string_view(s)) == docs_gen_core::section_kind::unknown;
+                        ++tried;
+                    }
+                }
+            }
+        }
+
+        bool ok = true;
+        ok &= check(known, "every field name maps to its key, narrow and wide");
+        ok &= check(unknown && tried > 20000, "short keys that are no name are unknown");
+        ok &= check(docs_gen_core::to_field_key(std::string_view("script_clas")) == field_key::unknown
+            && docs_gen_core::to_field_key(std::string_view("script_class_")) == field_key::unknown, "near misses of a long name are unknown");
+        // U+0161 hashes like 'a', only the compare tells it from "path"
+        ok &= check(docs_gen_core::to_field_key(std::wstring_view(L"p\u0161th")) == field_key::unknown, "a wide character hashing like an ASCII one misses");
+        return ok;
+    }
+
+    bool test_section_fields() {
+        using docs_gen_core::field_key;
+
+        docs_gen_core::section_fields f;
+        f.set_kind(docs_gen_core::section_kind::ext_resource);
+        f.set(field_key::path, L"res://a.tscn");
+        f.set(field_key::id, L"");
+        f.push_unknown(L"custom", L"1");
+
+        bool ok = true;
+        ok &= check(f.get_kind() == docs_gen_core::section_kind::ext_resource, "kind is kept");
+        ok &= check(f.has(field_key::path) && f.get(field_key::path) == L"res://a.tscn", "known key is stored in its slot");
+        ok &= check(f.has(field_key::id) && !f.has_value(field_key::id), "present but empty");
+        ok &= check(!f.has(field_key::uid) && f.get(field_key::uid).empty(), "absent key reads empty");
+        ok &= check(!f.has(field_key::unknown), "unknown is never present");
+        ok &= check(f.overflow_size() == 1 && f.get_overflow(0).first == L"custom", "unknown keys go to the overflow");
+
+        f.clear();
+        ok &= check(!f.has(field_key::path) && f.overflow_size() == 0, "clear drops every field");
+        return ok;
+    }
+
+} // docs_gen_test
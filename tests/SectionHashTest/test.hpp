@@ -0,0 +1,12 @@
+﻿#ifndef DOCS_GEN_TEST_SECTION_HASH_H
+#define DOCS_GEN_TEST_SECTION_HASH_H
+
+namespace docs_gen_test {
+
+    bool test_section_hash();
+    bool test_field_hash();
+    bool test_section_fields();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_SECTION_HASH_H
\ No newline at end of file
@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_shard_round_trip,
+        docs_gen_test::test_shard_missing,
+    });
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+﻿#include "test.hpp"
+
+#include <filesystem>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::map<std::string, std::string> gen_shard(const std::filesystem::path& root, std::size_t index, std::size_t count) {
+            return gen_docs(root, [&](docs_gen_core::dir& d) { d.set_shard(index, count); });
+        }
+
+        bool merge(const std::filesystem::path& root) {
+            docs_gen_core::dir d;
+            return d.set_path(root.wstring()) && d.merge_shards();
+        }
+
+    } // namespace
+
+    bool test_shard_round_trip() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+
+        const scratch_dir base{ "shard_test" };
+        const auto root = base.path() / "project";
+        const auto docs = root / "docs";
+        const auto collected = base.path() / "collected";
+        write_sample_project(root);
+
+        const auto reference = gen_docs(root);
+        bool ok = true;
+        ok &= check(reference.count("scenes/main.tscn.md") == 1 && reference.count("scripts/player.gd.md") == 1,
+            "the single run has a page per file");
+
+        // gen_docs starts from an empty docs folder, so each shard's output is gathered elsewhere
+        constexpr std::size_t count = 3;
+        bool written = true;
+        for (std::size_t i = 0; i < count; ++i) {
+            written &= !gen_shard(root, i, count).empty();
+            std::filesystem::copy(docs, collected,
+                std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
+        }
+        ok &= check(written, "every shard writes its slice");
+        std::filesystem::remove_all(docs);
+        std::filesystem::copy(collected, docs, std::filesystem::copy_options::recursive);
+
+        ok &= check(read_tree(docs) != reference, "the shards alone lack the dependency sections");
+        ok &= check(merge(root), "the shard indexes merge");
+        ok &= check(!std::filesystem::exists(docs / ".shards"), "the merge removes the shard indexes");
+        ok &= check(read_tree(docs) == reference, "merged shards match the single run page for page");
+        return ok;
+    }
+
+    bool test_shard_missing() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+
+        const scratch_dir base{ "shard_missing_test" };
+        const auto root = base.path() / "project";
+        write_sample_project(root);
+
+        bool ok = true;
+        ok &= check(!merge(root), "no shard indexes is an error");
+
+        // only the second of two shards ran
+        gen_shard(root, 1, 2);
+        ok &= check(!merge(root), "a missing shard is an error");
+        ok &= check(std::filesystem::exists(root / "docs" / ".shards"), "a failed merge keeps the indexes");
+
+        // the first shard ran before a script was removed, the second after
+        const auto held = base.path() / "held";
+        write_file(root / "scripts/extra.gd", "extends Node\n");
+        gen_shard(root, 0, 2);
+        std::filesystem::copy(root / "docs" / ".shards", held);
+        std::filesystem::remove(root / "scripts/extra.gd");
+        gen_shard(root, 1, 2);
+        std::filesystem::copy(held, root / "docs" / ".shards", std::filesystem::copy_options::recursive);
+        ok &= check(!merge(root), "a shard of another tree is an error");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_SHARD_INDEX_H
+#define DOCS_GEN_TEST_SHARD_INDEX_H
+
+namespace docs_gen_test {
+
+    bool test_shard_round_trip();
+    bool test_shard_missing();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_SHARD_INDEX_H
\ No newline at end of file
@@ -0,0 +1,10 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_section_cuts,
+        docs_gen_test::test_split_parse,
+        docs_gen_test::test_split_docs,
+    });
+}
\ No newline at end of file
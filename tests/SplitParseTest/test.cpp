@@ -0,0 +1,222 @@
+﻿#include "test.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/parser.hpp"
+#include "../core/thread_pool.hpp"
+#include "../core/trace.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        // a '[' opening a line inside a string or a bracketed value is no section header
+        const std::string tricky_body =
+            "[node name=\"A\" type=\"Node\" parent=\".\"]\n"
+            "text = \"first\n[node name=\\\"Fake\\\" parent=\\\".\\\"]\nlast\"\n"
+            "quoted = \"a \\\" quote\n[node name=\\\"Fake2\\\"]\"\n\n"
+            "[node name=\"B\" type=\"Node\" parent=\".\"]\n"
+            "data = {\n\"k\": [\n[1, 2],\n[3, 4]\n]\n}\n"
+            "points = PackedVector2Array(\n[0]\n)\n\n"
+            "[node name=\"C\" type=\"Node\" parent=\"B\"]\n";
+
+        // a scene big enough to be cut into many chunks: groups of nodes with scripts, instances,
+        // plain properties and the values of tricky_body
+        std::string big_scene() {
+            std::string s =
+                "[gd_scene load_steps=3 format=3 uid=\"uid://cbigscene0001\"]\n\n"
+                "[ext_resource type=\"Script\" path=\"res://scripts/item.gd\" id=\"1_sc\"]\n"
+                "[ext_resource type=\"PackedScene\" uid=\"uid://dq3k5enemy01\" path=\"res://scenes/enemy.tscn\" id=\"2_en\"]\n\n"
+                "[node name=\"Main\" type=\"Node\"]\n\n";
+            for (int g = 0; g < 80; ++g) {
+                const auto group = "G" + std::to_string(g);
+                s += "[node name=\"" + group + "\" type=\"Node2D\" parent=\".\"]\n";
+                s += "position = Vector2(" + std::to_string(g) + ", 1)\n";
+                s += "text = \"first\n[node name=\\\"Fake\\\" parent=\\\".\\\"]\nlast\"\n\n";
+                for (int c = 0; c < 12; ++c) {
+                    const auto child = "C" + std::to_string(c);
+                    s += "[node name=\"" + child + "\" type=\"Sprite2D\" parent=\"" + group + "\"]\n";
+                    if (c % 3 == 0) s += "script = ExtResource(\"1_sc\")\n";
+                    s += "data = {\n\"k\": [\n[1, 2],\n[3, 4]\n]\n}\n\n";
+                    s += "[node name=\"Leaf\" type=\"Node\" parent=\"" + group + "/" + child + "\"]\n";
+                    s += "modulate = Color(1, 0.5, 0.25, 1)\n\n";
+                }
+                s += "[node name=\"E\" parent=\"" + group + "\" instance=ExtResource(\"2_en\")]\n\n";
+            }
+            return s;
+        }
+
+        bool same_node(const docs_gen_core::node_tree::tree_node& a, const docs_gen_core::node_tree::tree_node& b) {
+            if (a.name != b.name || a.type != b.type || a.path != b.path || a.depth != b.depth || a.properties != b.properties)
+                return false;
+            if (a.children.size() != b.children.size() || a.ext_resource_fields.size() != b.ext_resource_fields.size())
+                return false;
+            for (std::size_t i = 0; i < a.ext_resource_fields.size(); ++i) {
+                if (a.ext_resource_fields[i].first != b.ext_resource_fields[i].first
+                    || a.ext_resource_fields[i].second.lock() != b.ext_resource_fields[i].second.lock())
+                    return false;
+            }
+            return a.instance.lock() == b.instance.lock();
+        }
+
+        bool same_tree(docs_gen_core::node_tree& a, docs_gen_core::node_tree& b, std::size_t& count) {
+            count = 0;
+            auto ia = a.begin();
+            auto ib = b.begin();
+            for (; ia != a.end() && ib != b.end(); ++ia, ++ib, ++count) {
+                if (!same_node(**ia, **ib))
+                    return false;
+            }
+            return ia == a.end() && ib == b.end();
+        }
+
+        // the chunks parsed while fn ran, one trace span each
+        template <typename Fn>
+        std::size_t count_chunks(const scratch_dir& base, Fn&& fn) {
+            namespace trace = docs_gen_core::trace;
+            trace::clear();
+            trace::set_enabled(true);
+            fn();
+            trace::set_enabled(false);
+            const auto path = base.path() / "trace.json";
+            const auto json = trace::write_chrome_trace(path) ? read_file(path) : std::string{};
+            trace::clear();
+
+            const std::string name = "\"name\":\"parse_scene_chunk\"";
+            std::size_t n = 0;
+            for (auto at = json.find(name); at != std::string::npos; at = json.find(name, at + name.size())) {
+                ++n;
+            }
+            return n;
+        }
+
+    } // namespace
+
+    bool test_section_cuts() {
+        const scratch_dir base{ "split_cuts_test" };
+        const auto path = base.path() / "tricky.tscn";
+        const std::string header = "[gd_scene format=3]\n\n";
+        const auto text = header + tricky_body;
+        write_file(path, text);
+
+        const std::uint64_t size = text.size();
+        const std::uint64_t a = text.find("[node name=\"A\"");
+        const std::uint64_t b = text.find("[node name=\"B\"");
+        const std::uint64_t c = text.find("[node name=\"C\"");
+
+        bool ok = true;
+        ok &= check(docs_gen_core::find_section_cuts(path, 0, 1) == std::vector<std::uint64_t>{ 0, a, b, c, size },
+            "only the real section headers are cuts");
+        ok &= check(docs_gen_core::find_section_cuts(path, a, 1) == std::vector<std::uint64_t>{ a, b, c, size },
+            "the scan starts at from");
+        ok &= check(docs_gen_core::find_section_cuts(path, a, b - a + 1) == std::vector<std::uint64_t>{ a, c, size },
+            "a cut waits until chunk_bytes have passed");
+        ok &= check(docs_gen_core::find_section_cuts(path, 0, size) == std::vector<std::uint64_t>{ 0, size },
+            "a chunk bigger than the file is not cut");
+        ok &= check(docs_gen_core::find_section_cuts(path, 0, 0).empty(), "chunk_bytes of 0 is no cut at all");
+        ok &= check(docs_gen_core::find_section_cuts(base.path() / "missing.tscn", 0, 1).empty(), "a missing file has no cuts");
+        return ok;
+    }
+
+    bool test_split_parse() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+
+        const scratch_dir project{ "split_parse_test" };
+        const auto& root = project.path();
+        write_file(root / "scenes/big.tscn", big_scene());
+
+        const auto script = std::make_shared<docs_gen_core::script_file>(root / "scripts/item.gd");
+        script->set_id(0);
+        const auto enemy = std::make_shared<docs_gen_core::scene_file>(root / "scenes/enemy.tscn");
+        enemy->set_id(1);
+        enemy->set_uid(docs_gen_core::decode_uid("uid://dq3k5enemy01"));
+        const std::vector<std::shared_ptr<docs_gen_core::file>> files{ script, enemy };
+
+        docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::scene_file>> scene_files;
+        scene_files.insert_or_assign(enemy->get_uid(), enemy);
+        const docs_gen_core::uid_map<std::shared_ptr<docs_gen_core::resource_file>> resource_files;
+        docs_gen_core::path_resolver paths;
+        paths.build(root, files);
+        const docs_gen_core::link_context ctx{ scene_files, resource_files, paths, files };
+
+        const auto parse = [&](docs_gen_core::thread_pool* pool, std::uint64_t split_bytes) {
+            auto scene = std::make_shared<docs_gen_core::scene_file>(root / "scenes/big.tscn");
+            docs_gen_core::parse_options options;
+            options.node_properties = true;
+            options.split_bytes = split_bytes;
+            docs_gen_core::dott_parser p{ scene, options };
+            p.set_thread_pool(pool);
+            const bool parsed = p.parse_scene_file_contents(ctx);
+            return std::make_pair(parsed ? scene : nullptr, p.get_node_count());
+        };
+
+        constexpr std::uint64_t split_bytes = 4096;
+        docs_gen_core::thread_pool pool{ 4 };
+        const auto [sequential, sequential_nodes] = parse(nullptr, 0);
+        const auto [split, split_nodes] = parse(&pool, split_bytes);
+
+        bool ok = true;
+        ok &= check(sequential && split, "both passes parse the scene");
+        if (!sequential || !split) return false;
+
+        ok &= check(docs_gen_core::find_section_cuts(root / "scenes/big.tscn", 0, split_bytes).size() > 10,
+            "the scene is cut into many chunks");
+        std::size_t count = 0;
+        ok &= check(same_tree(sequential->get_node_tree(), split->get_node_tree(), count), "the split tree equals the sequential one");
+        ok &= check(count == 1 + 80 * (2 + 2 * 12) && sequential_nodes == count && split_nodes == count,
+            "every node is read once, no string makes one up");
+
+        // the same scene read again on the pool does not depend on how the chunks were scheduled
+        const auto [again, again_nodes] = parse(&pool, split_bytes);
+        ok &= check(again && again_nodes == count && same_tree(split->get_node_tree(), again->get_node_tree(), count),
+            "a second split pass builds the same tree");
+        return ok;
+    }
+
+    bool test_split_docs() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir base{ "split_docs_test" };
+        const auto root = base.path() / "project";
+        write_sample_project(root);
+        write_file(root / "scripts/item.gd", "extends Sprite2D\n");
+        write_file(root / "scenes/big.tscn", big_scene());
+
+        const auto run = [&](std::uint64_t split_bytes, docs_gen_core::thread_pool* pool, std::map<std::string, std::string>& docs) {
+            return count_chunks(base, [&] {
+                docs = gen_docs(root, [&](docs_gen_core::dir& d) {
+                    docs_gen_core::parse_options options;
+                    options.node_properties = true;
+                    options.split_bytes = split_bytes;
+                    d.set_parse_options(options);
+                    d.set_thread_pool(pool);
+                });
+            });
+        };
+
+        std::map<std::string, std::string> whole;
+        std::map<std::string, std::string> alone;
+        std::map<std::string, std::string> pooled;
+        std::map<std::string, std::string> unsplit;
+        docs_gen_core::thread_pool pool{ 4 };
+        const auto whole_chunks = run(0, nullptr, whole);
+        // a run without a pool gets one of its own for the big scene
+        const auto alone_chunks = run(4096, nullptr, alone);
+        const auto pooled_chunks = run(4096, &pool, pooled);
+        const auto unsplit_chunks = run(std::uint64_t{ 1 } << 30, nullptr, unsplit);
+
+        bool ok = true;
+        ok &= check(whole.count("scenes/big.tscn.md") == 1 && whole_chunks == 0, "split_bytes of 0 reads the scene in one piece");
+        ok &= check(alone_chunks > 10 && pooled_chunks == alone_chunks, "a run with or without a pool splits the big scene");
+        ok &= check(unsplit_chunks == 0, "a scene under twice split_bytes is not split");
+        ok &= check(alone == whole && pooled == whole && unsplit == whole, "split or not, the docs are the same bytes");
+        return ok;
+    }
+
+} // docs_gen_test
@@ -0,0 +1,12 @@
+﻿#ifndef DOCS_GEN_TEST_SPLIT_PARSE_H
+#define DOCS_GEN_TEST_SPLIT_PARSE_H
+
+namespace docs_gen_test {
+
+    bool test_section_cuts();
+    bool test_split_parse();
+    bool test_split_docs();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_SPLIT_PARSE_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+﻿#include "test.hpp"
+
+#include <memory>
+#include <string>
+
+#include "../core/dir.hpp"
+#include "../core/log.hpp"
+#include "../core/thread_pool.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        // the sample project and a few dozen scenes more, enough for every worker to get several
+        void write_stream_project(const std::filesystem::path& root) {
+            write_sample_project(root);
+            for (int i = 0; i < 40; ++i) {
+                const auto n = std::to_string(i);
+                const std::string uid{ static_cast<char>('a' + i / 10), static_cast<char>('a' + i % 10) };
+                write_file(root / ("scenes/gen/room" + n + ".tscn"),
+                    "[gd_scene load_steps=3 format=3 uid=\"uid://cgenroom" + uid + "\"]\n\n"
+                    "[ext_resource type=\"PackedScene\" uid=\"uid://dq3k5enemy01\" path=\"res://scenes/enemy.tscn\" id=\"1_en\"]\n"
+                    "[ext_resource type=\"Script\" path=\"res://scripts/gen/room" + n + ".gd\" id=\"2_sc\"]\n\n"
+                    "[node name=\"Room" + n + "\" type=\"Node2D\"]\nscript = ExtResource(\"2_sc\")\n\n"
+                    "[node name=\"Guard\" parent=\".\" instance=ExtResource(\"1_en\")]\n");
+                write_file(root / ("scripts/gen/room" + n + ".gd"),
+                    "extends Node2D\n\nvar size : int = " + n + "\n\nfunc enter(who : Player) -> void:\n\tpass\n");
+            }
+        }
+
+    } // namespace
+
+    bool test_stream_identical() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "stream_test" };
+        const auto& root = project.path();
+        write_stream_project(root);
+
+        const auto plain = gen_docs(root);
+        const auto streamed = gen_docs(root, [](docs_gen_core::dir& d) { d.set_streaming(true); });
+        docs_gen_core::thread_pool pool{ 4 };
+        const auto pooled = gen_docs(root, [&](docs_gen_core::dir& d) {
+            d.set_streaming(true);
+            d.set_thread_pool(&pool);
+        });
+
+        bool ok = true;
+        ok &= check(plain.size() == 1 + 10 + 2 * 40, "the plain run writes every page");
+        ok &= check(streamed == plain, "a streamed run writes the same docs");
+        ok &= check(pooled == plain, "a streamed run on a pool writes the same docs");
+        return ok;
+    }
+
+    bool test_stream_releases() {
+        docs_gen_core::logging::set_level(docs_gen_core::logging::level::error);
+        const scratch_dir project{ "stream_release_test" };
+        const auto& root = project.path();
+        write_sample_project(root);
+
+        docs_gen_core::dir d;
+        bool ok = true;
+        ok &= check(d.set_path(root.wstring()), "the project opens");
+        d.set_streaming(true);
+        d.construct_file_tree();
+
+        // only the links are read up front, the bodies wait for gen_docs
+        bool links = true;
+        bool bodies = true;
+        for (const auto& f : d.get_files()) {
+            if (const auto rf = std::dynamic_pointer_cast<docs_gen_core::resource_file>(f)) {
+                links &= !rf->get_scripts().empty();
+                bodies &= rf->get_resource().fields.empty();
+            }
+        }
+        ok &= check(links, "the links are read before gen_docs");
+        ok &= check(bodies, "the bodies are not");
+        ok &= check(d.get_ref_index().edge_count() > 0, "the reference index is built from the links alone");
+
+        d.gen_docs();
+        bool released = true;
+        for (const auto& f : d.get_files()) {
+            if (const auto rf = std::dynamic_pointer_cast<docs_gen_core::resource_file>(f))
+                released &= rf->get_resource().fields.empty() && rf->get_resource().type.empty();
+            else if (const auto sf = std::dynamic_pointer_cast<docs_gen_core::script_file>(f))
+                released &= sf->get_script_class().functions.empty() && sf->get_script_class().categories.empty();
+        }
+        ok &= check(released, "each body is dropped once its page is written");
+        const auto page = read_file(root / "docs/res/stats.tres.md");
+        ok &= check(page.find("max_hp") != std::string::npos, "the page was written from the body");
+        return ok;
+    }
+
+} // docs_gen_test
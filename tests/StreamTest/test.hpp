@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_STREAM_H
+#define DOCS_GEN_TEST_STREAM_H
+
+namespace docs_gen_test {
+
+    bool test_stream_identical();
+    bool test_stream_releases();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_STREAM_H
\ No newline at end of file
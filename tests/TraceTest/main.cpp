@@ -0,0 +1,9 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_trace_scope,
+        docs_gen_test::test_trace_run,
+    });
+}
\ No newline at end of file
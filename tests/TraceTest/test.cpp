@@ -0,0 +1,101 @@
+﻿#include "test.hpp"
+
+#include <cstddef>
+#include <string>
+
+#include "../core/trace.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    namespace {
+
+        std::size_t count(const std::string& text, const std::string& what) {
+            std::size_t n = 0;
+            for (auto at = text.find(what); at != std::string::npos; at = text.find(what, at + what.size())) {
+                ++n;
+            }
+            return n;
+        }
+
+        std::string write_trace(const scratch_dir& base) {
+            const auto path = base.path() / "trace.json";
+            if (!docs_gen_core::trace::write_chrome_trace(path))
+                return {};
+            return read_file(path);
+        }
+
+    } // namespace
+
+    bool test_trace_scope() {
+        namespace trace = docs_gen_core::trace;
+        const scratch_dir base{ "trace_scope_test" };
+        trace::set_enabled(false);
+        trace::clear();
+
+        bool ok = true;
+        {
+            DOCS_GEN_TRACE_SCOPE(span, "off", "test");
+            ok &= check(!span.active(), "a span is inactive while tracing is off");
+        }
+        ok &= check(trace::event_count() == 0, "an inactive span records nothing");
+
+        trace::set_enabled(true);
+        trace::set_thread_name("main \"thread\"");
+        {
+            DOCS_GEN_TRACE_SCOPE(span, "outer", "test");
+            ok &= check(span.active(), "a span is active while tracing is on");
+            span.set_detail(std::string{ "a\"b\\c\n" });
+            for (std::uint64_t i = 0; i < docs_gen_core::trace::max_args + 2; ++i) {
+                span.arg("n", i);
+            }
+            DOCS_GEN_TRACE_SCOPE(inner, "inner", "test");
+        }
+        trace::set_enabled(false);
+        ok &= check(trace::event_count() == 2, "each closed span is one event");
+
+        const auto json = write_trace(base);
+        ok &= check(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 && json.size() > 4
+            && json.compare(json.size() - 4, 4, "\n]}\n") == 0, "the trace is one trace-event object");
+        ok &= check(count(json, "\"ph\":\"X\"") == 2, "a complete event per span");
+        ok &= check(json.find("\"name\":\"thread_name\",\"ph\":\"M\"") != std::string::npos
+            && json.find("\"args\":{\"name\":\"main \\\"thread\\\"\"}") != std::string::npos, "the thread gets its name");
+        ok &= check(json.find("\"args\":{\"file\":\"a\\\"b\\\\c\\u000a\",\"n\":0,\"n\":1,\"n\":2,\"n\":3}") != std::string::npos,
+            "the detail is escaped and the args stop at max_args");
+        ok &= check(json.find("\"name\":\"inner\",\"cat\":\"test\"") < json.find("\"name\":\"outer\",\"cat\":\"test\""),
+            "spans are written in the order they closed");
+
+        trace::clear();
+        ok &= check(trace::event_count() == 0, "clear drops the events");
+        return ok;
+    }
+
+    bool test_trace_run() {
+        namespace trace = docs_gen_core::trace;
+        const scratch_dir base{ "trace_run_test" };
+        const auto root = base.path() / "project";
+        write_sample_project(root);
+
+        trace::clear();
+        const auto plain = gen_docs(root);
+        trace::set_enabled(true);
+        const auto traced = gen_docs(root);
+        trace::set_enabled(false);
+        const auto json = write_trace(base);
+        trace::clear();
+
+        bool ok = true;
+        ok &= check(!plain.empty() && traced == plain, "tracing does not change the docs");
+        for (const char* name : { "\"index_files\"", "\"parse_files\"", "\"parse_headers\"", "\"resolve_references\"",
+                 "\"build_ref_index\"", "\"build_closure\"", "\"gen_docs\"" }) {
+            ok &= check(count(json, std::string{ "\"name\":" } + name) == 1, name);
+        }
+        ok &= check(count(json, "\"name\":\"parse_scene\"") == 5 && count(json, "\"name\":\"parse_resource\"") == 1
+            && count(json, "\"name\":\"parse_script\"") == 4, "a parse span per file");
+        ok &= check(count(json, "\"name\":\"write_scene_page\"") == 5 && count(json, "\"name\":\"write_resource_page\"") == 1
+            && count(json, "\"name\":\"write_script_page\"") == 4, "a span per written page");
+        ok &= check(count(json, "main.tscn\"") == 3, "the main scene's spans carry its path");
+        return ok;
+    }
+
+} // docs_gen_test
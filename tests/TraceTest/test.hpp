@@ -0,0 +1,11 @@
+﻿#ifndef DOCS_GEN_TEST_TRACE_H
+#define DOCS_GEN_TEST_TRACE_H
+
+namespace docs_gen_test {
+
+    bool test_trace_scope();
+    bool test_trace_run();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_TRACE_H
\ No newline at end of file
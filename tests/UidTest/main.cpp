@@ -0,0 +1,10 @@
+﻿#include "test.hpp"
+#include "../test_common.hpp"
+
+int main() {
+    return docs_gen_test::run({
+        docs_gen_test::test_decode_uid,
+        docs_gen_test::test_uid_round_trip,
+        docs_gen_test::test_uid_map,
+    });
+}
\ No newline at end of file
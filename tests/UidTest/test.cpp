@@ -0,0 +1,76 @@
+﻿#include "test.hpp"
+
+#include <cstdint>
+#include <string>
+
+#include "../core/uid.hpp"
+#include "../test_common.hpp"
+
+namespace docs_gen_test {
+
+    bool test_decode_uid() {
+        using docs_gen_core::decode_uid;
+        using docs_gen_core::invalid_uid;
+
+        bool ok = true;
+        // a-y are the digits 0-24, 0-8 are 25-33
+        ok &= check(decode_uid("uid://a") == 0 && decode_uid("uid://b") == 1 && decode_uid("uid://y") == 24, "letters are the low digits");
+        ok &= check(decode_uid("uid://0") == 25 && decode_uid("uid://8") == 33, "numbers follow the letters");
+        ok &= check(decode_uid("uid://ba") == 34 && decode_uid("uid://bb") == 35 && decode_uid("uid://baa") == 34 * 34, "base 34, most significant digit first");
+        ok &= check(decode_uid("cecaxbhfkmmv") == decode_uid("uid://cecaxbhfkmmv"), "the uid:// prefix is optional");
+        ok &= check(decode_uid(L"uid://cecaxbhfkmmv") == decode_uid("uid://cecaxbhfkmmv"), "wide and narrow text decode alike");
+
+        ok &= check(decode_uid("") == invalid_uid && decode_uid("uid://") == invalid_uid, "empty payload is invalid");
+        ok &= check(decode_uid("uid://Abc") == invalid_uid, "upper case is invalid");
+        ok &= check(decode_uid("uid://ab-c") == invalid_uid && decode_uid("uid://ab c") == invalid_uid, "punctuation and blanks are invalid");
+        ok &= check(decode_uid("res://abc") == invalid_uid, "another scheme is invalid");
+        return ok;
+    }
+
+    bool test_uid_round_trip() {
+        using docs_gen_core::decode_uid;
+        using docs_gen_core::encode_uid;
+
+        bool ok = true;
+        bool values = true;
+        for (const std::uint64_t v : { std::uint64_t{ 0 }, std::uint64_t{ 1 }, std::uint64_t{ 33 }, std::uint64_t{ 34 },
+                 std::uint64_t{ 1234567890123456789 }, std::uint64_t{ 0x7FFFFFFFFFFFFFFE } }) {
+            values &= decode_uid(encode_uid(v)) == v;
+        }
+        ok &= check(values, "decode(encode(v)) == v");
+
+        bool sweep = true;
+        for (std::uint64_t v = 1; v < (std::uint64_t{ 1 } << 62); v = v * 3 + 7) {
+            sweep &= decode_uid(encode_uid(v)) == v;
+        }
+        ok &= check(sweep, "round trip over values up to 2^62");
+
+        ok &= check(encode_uid(decode_uid("uid://cecaxbhfkmmv")) == "uid://cecaxbhfkmmv", "encode(decode(s)) == s");
+        ok &= check(encode_uid(docs_gen_core::invalid_uid) == "uid://<invalid>", "invalid_uid encodes as a marker");
+        return ok;
+    }
+
+    bool test_uid_map() {
+        docs_gen_core::uid_map<int> m;
+        bool ok = true;
+        ok &= check(m.find(1) == nullptr, "an empty map finds nothing");
+
+        bool inserted = true;
+        for (int i = 0; i < 1000; ++i) {
+            inserted &= m.insert_or_assign(static_cast<std::uint64_t>(i), i * 2);
+        }
+        ok &= check(inserted && m.size() == 1000, "sequential uids all insert");
+        ok &= check(!m.insert_or_assign(10, 7) && *m.find(10) == 7 && m.size() == 1000, "a present uid is overwritten");
+        ok &= check(!m.insert_or_assign(docs_gen_core::invalid_uid, 1) && !m.contains(docs_gen_core::invalid_uid), "invalid_uid is never stored");
+
+        bool found = true;
+        for (int i = 0; i < 1000; ++i) {
+            if (i == 10) continue;
+            const auto* v = m.find(static_cast<std::uint64_t>(i));
+            found &= v && *v == i * 2;
+        }
+        ok &= check(found && m.find(1000) == nullptr, "every uid finds its value, others miss");
+        return ok;
+    }
+
+} // docs_gen_test
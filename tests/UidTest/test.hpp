@@ -0,0 +1,12 @@
+﻿#ifndef DOCS_GEN_TEST_UID_H
+#define DOCS_GEN_TEST_UID_H
+
+namespace docs_gen_test {
+
+    bool test_decode_uid();
+    bool test_uid_round_trip();
+    bool test_uid_map();
+    
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_UID_H
\ No newline at end of file
@@ -1 +1,22 @@
-include "NodeTreeTest"
\ No newline at end of file
+include "test_project.lua"
+
+test_project "NodeTreeTest"
+test_project "ReferenceIndexTest"
+test_project "ClosureTest"
+test_project "TraceTest"
+test_project "PathResolverTest"
+test_project "UidTest"
+test_project "SectionHashTest"
+test_project "BinaryParserTest"
+test_project "StreamTest"
+test_project "ClassRegistryTest"
+test_project "ExpandInstancesTest"
+test_project "ParseStatsTest"
+test_project "LinkTableTest"
+test_project "ReachableTest"
+test_project "ShardIndexTest"
+test_project "ArchiveTest"
+test_project "PropertyValueTest"
+test_project "SplitParseTest"
+test_project "BudgetTest"
+test_project "MarkdownTest"
\ No newline at end of file
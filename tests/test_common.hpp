@@ -0,0 +1,145 @@
+﻿#ifndef DOCS_GEN_TEST_COMMON_H
+#define DOCS_GEN_TEST_COMMON_H
+
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include "../core/dir.hpp"
+
+// what every test program shares: the expectation printer, the runner main calls, and a small
+// Godot project written to a scratch folder for the tests that go through dir
+namespace docs_gen_test {
+
+    // one line per expectation, "ok   " or "FAIL " and what was expected
+    inline bool check(bool ok, const char* what) {
+        std::cout << (ok ? "ok   " : "FAIL ") << what << '\n';
+        return ok;
+    }
+
+    // runs every test even after one failed, the result is what main returns
+    inline int run(std::initializer_list<bool (*)()> tests) {
+        bool ok = true;
+        for (const auto test : tests) {
+            ok &= test();
+        }
+        return ok ? 0 : 1;
+    }
+
+    // an empty folder below the temp directory, removed again with the object
+    class scratch_dir {
+        std::filesystem::path path_;
+
+    public:
+        explicit scratch_dir(const std::string& name)
+            : path_(std::filesystem::temp_directory_path() / ("docs_gen_" + name)) {
+            std::filesystem::remove_all(path_);
+            std::filesystem::create_directories(path_);
+        }
+        scratch_dir(const scratch_dir&) = delete;
+        scratch_dir& operator=(const scratch_dir&) = delete;
+        ~scratch_dir() {
+            std::error_code ec;
+            std::filesystem::remove_all(path_, ec);
+        }
+
+        [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+    };
+
+    inline void write_file(const std::filesystem::path& path, std::string_view text) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream out{ path, std::ios::out | std::ios::binary };
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    inline std::string read_file(const std::filesystem::path& path) {
+        std::ifstream in{ path, std::ios::in | std::ios::binary };
+        return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    }
+
+    // relative path -> contents of every file below root
+    inline std::map<std::string, std::string> read_tree(const std::filesystem::path& root) {
+        std::map<std::string, std::string> tree;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root, ec)) {
+            if (entry.is_regular_file()) {
+                tree[std::filesystem::relative(entry.path(), root).generic_string()] = read_file(entry.path());
+            }
+        }
+        return tree;
+    }
+
+    // main.tscn (the main scene) instances enemy.tscn, which instances weapon.tscn; level.tscn and
+    // room.tscn instance each other and nothing reaches them; globals.gd is an autoload
+    inline void write_sample_project(const std::filesystem::path& root) {
+        write_file(root / "project.godot",
+            "config_version=5\n\n[application]\n\nconfig/name=\"Sample\"\nrun/main_scene=\"res://scenes/main.tscn\"\n\n"
+            "[autoload]\n\nGlobals=\"*res://scripts/globals.gd\"\n");
+        write_file(root / "scripts/enemy.gd", "extends Node2D\nclass_name Enemy\n\nfunc attack(p : Player) -> void:\n\tpass\n");
+        write_file(root / "scripts/player.gd",
+            "extends Enemy\nclass_name Player\n\n@export var hp : int = 10\n\nfunc move(dir : Vector2, who : Enemy) -> Enemy:\n\tpass\n");
+        write_file(root / "scripts/weapon.gd", "extends Node2D\n\nvar damage : int = 3\n");
+        write_file(root / "scripts/globals.gd", "extends Node\n");
+        write_file(root / "scenes/main.tscn",
+            "[gd_scene load_steps=3 format=3 uid=\"uid://cmainscene001\"]\n\n"
+            "[ext_resource type=\"Script\" path=\"res://scripts/player.gd\" id=\"1_pl\"]\n"
+            "[ext_resource type=\"PackedScene\" uid=\"uid://dq3k5enemy01\" path=\"res://scenes/enemy.tscn\" id=\"2_en\"]\n\n"
+            "[node name=\"Main\" type=\"Node\"]\n\n"
+            "[node name=\"Player\" type=\"CharacterBody2D\" parent=\".\"]\n"
+            "transform = Transform2D(1, 0, 0, 1, 5, 6)\nscript = ExtResource(\"1_pl\")\n\n"
+            "[node name=\"Camera\" type=\"Camera2D\" parent=\"Player\"]\n\n"
+            "[node name=\"Enemy1\" parent=\".\" instance=ExtResource(\"2_en\")]\n\n"
+            "[node name=\"Enemy2\" parent=\"Player/Camera\" instance=ExtResource(\"2_en\")]\n");
+        write_file(root / "scenes/enemy.tscn",
+            "[gd_scene load_steps=4 format=3 uid=\"uid://dq3k5enemy01\"]\n\n"
+            "[ext_resource type=\"Script\" path=\"res://scripts/enemy.gd\" id=\"1_en\"]\n"
+            "[ext_resource type=\"Resource\" uid=\"uid://b7x2k4m1q0abc\" path=\"res://res/stats.tres\" id=\"2_st\"]\n"
+            "[ext_resource type=\"PackedScene\" uid=\"uid://cweaponscene1\" path=\"res://scenes/weapon.tscn\" id=\"3_wp\"]\n\n"
+            "[node name=\"Enemy\" type=\"Node2D\"]\nposition = Vector2(10, 20.5)\nscript = ExtResource(\"1_en\")\nstats = ExtResource(\"2_st\")\n\n"
+            "[node name=\"Sprite\" type=\"Sprite2D\" parent=\".\"]\nmodulate = Color(1, 0.5, 0.25, 1)\n\n"
+            "[node name=\"Weapon\" parent=\".\" instance=ExtResource(\"3_wp\")]\n");
+        write_file(root / "scenes/weapon.tscn",
+            "[gd_scene load_steps=2 format=3 uid=\"uid://cweaponscene1\"]\n\n"
+            "[ext_resource type=\"Script\" path=\"res://scripts/weapon.gd\" id=\"1_wp\"]\n\n"
+            "[node name=\"Weapon\" type=\"Node2D\"]\nscript = ExtResource(\"1_wp\")\n\n"
+            "[node name=\"Blade\" type=\"Sprite2D\" parent=\".\"]\n");
+        write_file(root / "scenes/level.tscn",
+            "[gd_scene load_steps=2 format=3 uid=\"uid://clevelscene01\"]\n\n"
+            "[ext_resource type=\"PackedScene\" uid=\"uid://croomscene001\" path=\"res://scenes/room.tscn\" id=\"1_ro\"]\n\n"
+            "[node name=\"Level\" type=\"Node\"]\n\n"
+            "[node name=\"Room\" parent=\".\" instance=ExtResource(\"1_ro\")]\n");
+        write_file(root / "scenes/room.tscn",
+            "[gd_scene load_steps=2 format=3 uid=\"uid://croomscene001\"]\n\n"
+            "[ext_resource type=\"PackedScene\" uid=\"uid://clevelscene01\" path=\"res://scenes/level.tscn\" id=\"1_le\"]\n\n"
+            "[node name=\"Room\" type=\"Node\"]\n\n"
+            "[node name=\"Level\" parent=\".\" instance=ExtResource(\"1_le\")]\n");
+        write_file(root / "res/stats.tres",
+            "[gd_resource type=\"Resource\" script_class=\"Enemy\" load_steps=2 format=3 uid=\"uid://b7x2k4m1q0abc\"]\n\n"
+            "[ext_resource type=\"Script\" path=\"res://scripts/enemy.gd\" id=\"1_abcd\"]\n\n"
+            "[resource]\nscript = ExtResource(\"1_abcd\")\nmax_hp = 100\n");
+    }
+
+    // indexes, parses and documents root after configure(d) had its say, and returns the docs
+    template <typename Configure>
+    std::map<std::string, std::string> gen_docs(const std::filesystem::path& root, Configure&& configure) {
+        docs_gen_core::dir d;
+        if (!d.set_path(root.wstring()))
+            return {};
+        configure(d);
+        d.construct_file_tree();
+        d.gen_docs();
+        return read_tree(root / "docs");
+    }
+
+    inline std::map<std::string, std::string> gen_docs(const std::filesystem::path& root) {
+        return gen_docs(root, [](docs_gen_core::dir&) {});
+    }
+
+} // docs_gen_test
+
+#endif // DOCS_GEN_TEST_COMMON_H
\ No newline at end of file
@@ -0,0 +1,38 @@
+-- the settings every test program shares; each test is the sources of its own folder plus
+-- test_common.hpp, linked against Core
+function test_project(name)
+    project(name)
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+        staticruntime "off"
+
+        files {
+            name .. "/**.hpp",
+            name .. "/**.cpp",
+            "test_common.hpp",
+        }
+
+        targetdir ("%{wks.location}/build/bin/" .. outputdir .. "/%{prj.name}")
+        objdir ("%{wks.location}/build/obj/" .. outputdir .. "/%{prj.name}")
+
+        links { "Core" }
+
+        includedirs { "../core" }
+
+        -- the test's own folder, where it finds its fixtures
+        defines { "DOCS_GEN_TEST_DIR=\"" .. path.getabsolute(name) .. "\"" }
+
+        filter { "system:windows" }
+            defines { "WIN" }
+        filter {}
+
+        filter { "configurations:Debug" }
+            defines { "DEBUG" }
+            symbols "On"
+        filter {}
+
+        filter { "configurations:Release" }
+            optimize "On"
+        filter {}
+end
\ No newline at end of file